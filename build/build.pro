@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 CONFIG += c++11
-QT       += core svg serialport network xml
+QT       += core svg serialport network xml concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4):
 
@@ -47,28 +47,36 @@ SOURCES += \
     $$PWD/../src/geometry/slottedhole.cpp \
     $$PWD/../src/geometry/sphere.cpp \
     $$PWD/../src/geometry/torus.cpp \
+    $$PWD/../src/plugin/exchange/asciitokenizer.cpp \
     $$PWD/../src/plugin/exchange/exchangedefinedformat.cpp \
     $$PWD/../src/plugin/exchange/exchangeinterface.cpp \
     $$PWD/../src/plugin/exchange/exchangesimpleascii.cpp \
+    $$PWD/../src/plugin/exchange/exportengine.cpp \
     $$PWD/../src/plugin/function/function.cpp \
     $$PWD/../src/plugin/sensor/sensor.cpp \
     $$PWD/../src/plugin/sensor/sensorfacade.cpp \
     $$PWD/../src/plugin/simulation/simulationmodel.cpp \
+    $$PWD/../src/plugin/simulation/simulationrunner.cpp \
     $$PWD/../src/plugin/tool/tool.cpp \
     $$PWD/../src/util/util.cpp \
     $$PWD/../src/coordinatesystem.cpp \
+    $$PWD/../src/deviationreport.cpp \
     $$PWD/../src/direction.cpp \
     $$PWD/../src/element.cpp \
     $$PWD/../src/feature.cpp \
     $$PWD/../src/featurecontainer.cpp \
     $$PWD/../src/featurewrapper.cpp \
     $$PWD/../src/geometry.cpp \
+    $$PWD/../src/jobgenerator.cpp \
     $$PWD/../src/measurementconfig.cpp \
     $$PWD/../src/observation.cpp \
     $$PWD/../src/oijob.cpp \
+    $$PWD/../src/oirequestencoder.cpp \
     $$PWD/../src/position.cpp \
+    $$PWD/../src/profiler.cpp \
     $$PWD/../src/radius.cpp \
     $$PWD/../src/reading.cpp \
+    $$PWD/../src/readingstore.cpp \
     $$PWD/../src/sensorconfiguration.cpp \
     $$PWD/../src/sensorcontrol.cpp \
     $$PWD/../src/sensorworker.cpp \
@@ -76,7 +84,10 @@ SOURCES += \
     $$PWD/../src/station.cpp \
     $$PWD/../src/statistic.cpp \
     $$PWD/../src/trafoparam.cpp \
-    $$PWD/../src/plugin/networkAdjustment/bundleadjustment.cpp
+    $$PWD/../src/watchwindowengine.cpp \
+    $$PWD/../src/plugin/networkAdjustment/bundleadjustment.cpp \
+    $$PWD/../src/plugin/networkAdjustment/bundleengine.cpp \
+    $$PWD/../src/plugin/networkAdjustment/bundleinput.cpp
 
 # header files
 HEADERS  += \
@@ -99,9 +110,11 @@ HEADERS  += \
     $$PWD/../include/geometry/slottedhole.h \
     $$PWD/../include/geometry/sphere.h \
     $$PWD/../include/geometry/torus.h \
+    $$PWD/../include/plugin/exchange/asciitokenizer.h \
     $$PWD/../include/plugin/exchange/exchangedefinedformat.h \
     $$PWD/../include/plugin/exchange/exchangeinterface.h \
     $$PWD/../include/plugin/exchange/exchangesimpleascii.h \
+    $$PWD/../include/plugin/exchange/exportengine.h \
     $$PWD/../include/plugin/plugin.h \
     $$PWD/../include/plugin/pluginmetadata.h \
     $$PWD/../include/plugin/function/constructfunction.h \
@@ -117,10 +130,12 @@ HEADERS  += \
     $$PWD/../include/plugin/sensor/sensorfacade.h \
     $$PWD/../include/plugin/sensor/totalstation.h \
     $$PWD/../include/plugin/simulation/simulationmodel.h \
+    $$PWD/../include/plugin/simulation/simulationrunner.h \
     $$PWD/../include/plugin/tool/tool.h \
     $$PWD/../include/util/types.h \
     $$PWD/../include/util/util.h \
     $$PWD/../include/coordinatesystem.h \
+    $$PWD/../include/deviationreport.h \
     $$PWD/../include/direction.h \
     $$PWD/../include/element.h \
     $$PWD/../include/feature.h \
@@ -128,13 +143,17 @@ HEADERS  += \
     $$PWD/../include/featurecontainer.h \
     $$PWD/../include/featurewrapper.h \
     $$PWD/../include/geometry.h \
+    $$PWD/../include/jobgenerator.h \
     $$PWD/../include/measurementconfig.h \
     $$PWD/../include/observation.h \
     $$PWD/../include/oijob.h \
+    $$PWD/../include/oirequestencoder.h \
     $$PWD/../include/oirequestresponse.h \
     $$PWD/../include/position.h \
+    $$PWD/../include/profiler.h \
     $$PWD/../include/radius.h \
     $$PWD/../include/reading.h \
+    $$PWD/../include/readingstore.h \
     $$PWD/../include/sensorconfiguration.h \
     $$PWD/../include/sensorcontrol.h \
     $$PWD/../include/sensorworker.h \
@@ -142,4 +161,7 @@ HEADERS  += \
     $$PWD/../include/station.h \
     $$PWD/../include/statistic.h \
     $$PWD/../include/trafoparam.h \
-    $$PWD/../include/plugin/networkAdjustment/bundleadjustment.h
+    $$PWD/../include/watchwindowengine.h \
+    $$PWD/../include/plugin/networkAdjustment/bundleadjustment.h \
+    $$PWD/../include/plugin/networkAdjustment/bundleengine.h \
+    $$PWD/../include/plugin/networkAdjustment/bundleinput.h
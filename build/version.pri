@@ -23,6 +23,20 @@ OpenIndyCore_VERSION = $$system(git --git-dir ../.git describe --always --tags)
 OpenIndyCore_VERSION = $$replace(OpenIndyCore_VERSION, "-g"{1}\w*, ) # remove commit hash after tag name
 OpenIndyCore_VERSION = $$replace(OpenIndyCore_VERSION, "-", ".") # remove remaining hyphen
 PluginInterfaceVersion = $$replace(OpenIndyCore_VERSION, "[\.]", "")
+# increase when the layout of a plugin base class changes, so that plugins built against older headers
+# get a different IID and are rejected by the plugin loader
+# r1: layout changes of
+#   - ExchangeInterface: device mapping and asynchronous export members (also embedded in ExchangeSimpleAscii and ExchangeDefinedFormat)
+#   - Function: executionStatistic and job (also embedded in all function types)
+#   - InputElement: weight
+#   - BestFitUtil: buffers of the robust estimators
+#   - Statistic: p, qxx and v replaced by shared data (also embedded in FitFunction and Geometry)
+#   - Nurbs: control net, patches and bounding volume hierarchy
+#   - SimulationModel: randomGenerator
+#   - UncertaintyData and SimulationData: online statistics, quantiles, histogram and covariances
+#   - BundleAdjustment: bundleEngine
+PluginInterfaceRevision = 1
+PluginInterfaceVersion = $${PluginInterfaceVersion}r$${PluginInterfaceRevision}
 DEFINES += PLUGIN_INTERFACE_VERSION=$$PluginInterfaceVersion
 OpenIndyCore_VERSION = $$replace(OpenIndyCore_VERSION, "\b[0-9a-f]{5,40}\b", ) # remove commit hash (only if no tag has been set yet)
 
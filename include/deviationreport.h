@@ -0,0 +1,127 @@
+#ifndef DEVIATIONREPORT_H
+#define DEVIATIONREPORT_H
+
+#include <QObject>
+#include <QPointer>
+#include <QList>
+#include <QVector>
+#include <QStringList>
+#include <QAtomicInt>
+
+#include "types.h"
+
+namespace oi{
+
+class FeatureWrapper;
+
+/*!
+ * \brief The DeviationTable class
+ * Columnar result of a deviation report: one row per actual/nominal pair and one column per geometry parameter.
+ * Values that are not available for a pair (parameter not defined for its type, geometry not solved) are NaN
+ */
+class OI_CORE_EXPORT DeviationTable{
+public:
+    DeviationTable();
+
+    int getRowCount() const;
+    int getColumnIndex(const GeometryParameters &parameter) const;
+
+    void clear();
+
+    //row attributes
+    QVector<int> actualIds;
+    QVector<int> nominalIds;
+    QStringList names;
+    QVector<GeometryTypes> types;
+
+    //columns (default units: meter, radian, degree celsius)
+    QList<GeometryParameters> parameters;
+    QVector<QVector<double> > actuals;
+    QVector<QVector<double> > nominals;
+    QVector<QVector<double> > deviations; //actual - nominal
+
+};
+
+/*!
+ * \brief The DeviationReport class
+ * Computes the numeric deviations of all actual/nominal pairs of a set of features in parallel chunks.
+ * The features must not be changed while run() is executed (run blocks the calling thread)
+ */
+class OI_CORE_EXPORT DeviationReport : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DeviationReport(QObject *parent = 0);
+
+    ~DeviationReport();
+
+    //###################################
+    //set up the report before running it
+    //###################################
+
+    void setFeatures(const QList<QPointer<FeatureWrapper> > &features);
+
+    const QList<GeometryParameters> &getParameters() const;
+    void setParameters(const QList<GeometryParameters> &parameters);
+
+    const int &getChunkSize() const;
+    void setChunkSize(const int &chunkSize);
+
+    int getNumberOfPairs() const;
+
+    //#####################
+    //run or cancel the run
+    //#####################
+
+    bool run(DeviationTable &table);
+    void cancel();
+
+    static bool getParameterValue(const QPointer<FeatureWrapper> &feature, const GeometryParameters &parameter, double &value);
+
+signals:
+
+    //################################
+    //inform about the report progress
+    //################################
+
+    void sendMessage(const QString &msg, const MessageTypes &msgType, const MessageDestinations &msgDest = eConsoleMessage);
+    void updateProgress(const int &progress, const QString &msg);
+
+private:
+
+    //##############
+    //helper methods
+    //##############
+
+    class ColumnPointers{
+    public:
+        QVector<double *> actuals;
+        QVector<double *> nominals;
+        QVector<double *> deviations;
+    };
+
+    void computeChunk(const int &chunk, const QList<GeometryParameters> &parameters, const ColumnPointers &columns) const;
+
+    //#################
+    //helper attributes
+    //#################
+
+    class Pair{
+    public:
+        QPointer<FeatureWrapper> actual;
+        QPointer<FeatureWrapper> nominal;
+    };
+
+    QVector<Pair> pairs;
+    QList<GeometryParameters> parameters; //empty: all parameters of the pair types
+
+    int chunkSize; //number of pairs computed by one task
+
+    QAtomicInt isCanceled;
+
+};
+
+}
+
+#endif // DEVIATIONREPORT_H
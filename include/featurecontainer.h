@@ -56,6 +56,10 @@ public:
     QList<QPointer<FeatureWrapper> > getFeaturesByType(const FeatureTypes &type) const;
     QList<QPointer<Geometry> > getGeometriesByMConfig(const MeasurementConfigKey &key) const;
 
+    //case insensitive prefix search (sorted by name, paginated with offset and limit)
+    QList<QPointer<FeatureWrapper> > getFeaturesByNamePrefix(const QString &prefix, const int &offset = 0, const int &limit = -1) const;
+    int getFeatureCountByNamePrefix(const QString &prefix) const;
+
     //######################
     //get number of features
     //######################
@@ -100,6 +104,7 @@ private:
     //feature maps (useful to quickly find a feature with a given id, name, group etc.)
     QMap<int, QPointer<FeatureWrapper> > featuresIdMap; //map of all features in OpenIndy with their id as key
     QMultiMap<QString, QPointer<FeatureWrapper> > featuresNameMap; //map of all features in OpenIndy with their name as key
+    QMultiMap<QString, QPointer<FeatureWrapper> > featuresFoldedNameMap; //map of all features in OpenIndy with their case folded name as key (sorted prefix index)
     QMultiMap<QString, QPointer<FeatureWrapper> > featuresGroupMap; //map of all features in OpenIndy with their group as key
     QMultiMap<FeatureTypes, QPointer<FeatureWrapper> > featuresTypeMap; // map of all features in OpenIndy with their type as key
     QMultiMap<MeasurementConfigKey, QPointer<Geometry> > geometriesMConfigMap; //map of all geometries in OpenIndy with their measurement config name and saved state as key
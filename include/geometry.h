@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QPointer>
 #include <QList>
+#include <QVector>
 #include <QtXml>
 
 #include "feature.h"
@@ -97,6 +98,13 @@ public:
                                                           const QMap<DimensionType, int> &displayDigits) const;
     virtual void setUnknownParameters(const QMap<GeometryParameters, double> &parameters);
 
+    //###########################################
+    //deviations of many points from the geometry
+    //###########################################
+
+    virtual bool computeDeviations(const double *points, const int &numPoints, double *deviations, double *footPoints = 0) const;
+    bool getDeviations(const QVector<double> &points, QVector<double> &deviations, QVector<double> *footPoints = 0) const;
+
     //###########################
     //reexecute the function list
     //###########################
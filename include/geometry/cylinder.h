@@ -65,6 +65,12 @@ public:
                                                           const QMap<DimensionType, int> &displayDigits) const;
     virtual void setUnknownParameters(const QMap<GeometryParameters, double> &parameters);
 
+    //###########################################
+    //deviations of many points from the geometry
+    //###########################################
+
+    bool computeDeviations(const double *points, const int &numPoints, double *deviations, double *footPoints = 0) const;
+
     //###########################
     //reexecute the function list
     //###########################
@@ -3,6 +3,7 @@
 
 #include <QObject>
 #include <QtXml>
+#include <QVector>
 
 #include "geometry.h"
 
@@ -10,6 +11,12 @@ namespace oi{
 
 /*!
  * \brief The Nurbs class
+ * Defines a NURBS surface by its control net (numControlPointsU x numControlPointsV points with weights),
+ * the degrees and the knot vectors in u and v.
+ *
+ * Setting the control net builds a cache: homogeneous control points, one patch per non-empty knot span pair
+ * with sampled surface points and a bounding volume hierarchy over the patches (convex hull property).
+ * Closest point projections use the hierarchy to find candidate patches and refine on them with Newton iterations.
  */
 class OI_CORE_EXPORT Nurbs : public Geometry
 {
@@ -40,6 +47,36 @@ public:
     //get or set nurbs parameters
     //###########################
 
+    bool setNurbs(const int &degreeU, const int &degreeV, const int &numControlPointsU, const int &numControlPointsV,
+                  const QVector<double> &knotsU, const QVector<double> &knotsV,
+                  const QVector<double> &controlPoints, const QVector<double> &weights = QVector<double>());
+
+    bool hasControlNet() const;
+
+    const int &getDegreeU() const;
+    const int &getDegreeV() const;
+    const int &getNumControlPointsU() const;
+    const int &getNumControlPointsV() const;
+    const QVector<double> &getKnotsU() const;
+    const QVector<double> &getKnotsV() const;
+    const QVector<double> &getControlPoints() const;
+    const QVector<double> &getWeights() const;
+
+    //####################
+    //evaluate the surface
+    //####################
+
+    bool evaluate(const double &u, const double &v, double xyz[3]) const;
+    bool evaluateNormal(const double &u, const double &v, double normal[3]) const;
+
+    bool closestPoint(const double xyz[3], double &u, double &v, double footPoint[3]) const;
+
+    //###########################################
+    //deviations of many points from the geometry
+    //###########################################
+
+    bool computeDeviations(const double *points, const int &numPoints, double *deviations, double *footPoints = 0) const;
+
     //###########################
     //reexecute the function list
     //###########################
@@ -53,6 +90,68 @@ public:
     QDomElement toOpenIndyXML(QDomDocument &xmlDoc) const;
     bool fromOpenIndyXML(QDomElement &xmlElem);
 
+    //highest supported degree
+    static const int maxDegree = 9;
+
+private:
+
+    //##############
+    //helper classes
+    //##############
+
+    class Patch{
+    public:
+        int spanU, spanV; //knot span indices
+        double uMin, uMax, vMin, vMax; //parameter domain
+        double box[6]; //bounding box of the patch control points (min x, y, z, max x, y, z)
+        QVector<double> samples; //x, y, z of (sampleCount + 1)^2 surface points
+    };
+
+    class BvhNode{
+    public:
+        double box[6];
+        int left, right; //child nodes (inner node)
+        int patch; //patch index (leaf) or -1
+    };
+
+    //##############
+    //helper methods
+    //##############
+
+    void buildCache();
+    int buildBvh(QVector<int> &patchIndices, const int &begin, const int &end);
+
+    int findSpan(const QVector<double> &knots, const int &degree, const int &numControlPoints, const double &t) const;
+    void basisFunctionDerivatives(const QVector<double> &knots, const int &degree, const int &span, const double &t,
+                                  double ders[3][maxDegree + 1]) const;
+    void evaluateDerivatives(const int &spanU, const int &spanV, const double &u, const double &v,
+                             double s[3], double su[3], double sv[3], double suu[3], double suv[3], double svv[3]) const;
+
+    double projectOnPatch(const Patch &patch, const double xyz[3], double &u, double &v, double footPoint[3]) const;
+
+    //################
+    //nurbs attributes
+    //################
+
+    int degreeU;
+    int degreeV;
+    int numControlPointsU;
+    int numControlPointsV;
+    QVector<double> knotsU;
+    QVector<double> knotsV;
+    QVector<double> controlPoints; //x, y, z of each control point (index = i * numControlPointsV + j)
+    QVector<double> weights;
+
+    //#################
+    //helper attributes
+    //#################
+
+    QVector<double> homogeneousPoints; //w * x, w * y, w * z, w of each control point
+    QVector<Patch> patches;
+    QVector<BvhNode> bvh; //the root is the first node
+
+    static const int sampleCount = 4; //samples per patch and direction - 1
+
 };
 
 }
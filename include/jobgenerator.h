@@ -0,0 +1,92 @@
+#ifndef JOBGENERATOR_H
+#define JOBGENERATOR_H
+
+#include <QPointer>
+#include <QList>
+
+#include "types.h"
+
+namespace oi{
+
+class OiJob;
+
+/*!
+ * \brief The JobGeneratorSettings class
+ * Describes the size of a generated job. Geometry counts are per geometry type,
+ * the first min(numNominals, numActuals) names of each type get a nominal and an actual geometry
+ */
+class OI_CORE_EXPORT JobGeneratorSettings
+{
+public:
+    JobGeneratorSettings(){
+        this->seed = 1;
+        this->numStations = 1;
+        this->numCoordinateSystems = 1;
+        this->numTrafoParams = 0;
+        this->geometryTypes.append(ePointFeature);
+        this->numNominals = 0;
+        this->numActuals = 0;
+        this->numReadings = 0;
+        this->readingType = eCartesianReading;
+        this->extent = 10.0;
+        this->noise = 0.00005;
+    }
+
+    //seed of the random generator (equal settings generate equal jobs)
+    quint32 seed;
+
+    //features
+    int numStations;
+    int numCoordinateSystems; //part systems (the first one is the nominal system)
+    int numTrafoParams; //between station systems and part systems
+    QList<FeatureTypes> geometryTypes;
+    int numNominals; //per geometry type
+    int numActuals; //per geometry type
+
+    //readings
+    int numReadings; //per actual geometry
+    ReadingTypes readingType; //eCartesianReading or ePolarReading
+    double extent; //geometries are placed in a cube of +-extent [m]
+    double noise; //standard deviation of the reading coordinates [m]
+
+};
+
+/*!
+ * \brief The JobGenerator class
+ * Fills a job with synthetic features and readings for load and scaling tests.
+ * Features are created by OiJob::addFeatures and readings are added by OiJob::addMeasurementResults,
+ * so that the job is set up like a job that is measured with a sensor.
+ * The actual geometries are distributed to the stations round robin. No functions are assigned
+ */
+class OI_CORE_EXPORT JobGenerator
+{
+public:
+    JobGenerator();
+    explicit JobGenerator(const JobGeneratorSettings &settings);
+
+    //##########################
+    //get or set up the settings
+    //##########################
+
+    const JobGeneratorSettings &getSettings() const;
+    void setSettings(const JobGeneratorSettings &settings);
+
+    //##############
+    //generate a job
+    //##############
+
+    bool generate(const QPointer<OiJob> &job) const;
+
+private:
+
+    //#################
+    //helper attributes
+    //#################
+
+    JobGeneratorSettings settings;
+
+};
+
+}
+
+#endif // JOBGENERATOR_H
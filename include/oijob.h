@@ -7,6 +7,7 @@
 #include <QList>
 #include <QStringList>
 #include <QMap>
+#include <QHash>
 #include <QMultiMap>
 #include <QIODevice>
 #include <QSet>
@@ -32,6 +33,39 @@ enum CompatibilyCheckResult{
     eCheckResult_job_lt_oi_22_1
 };
 
+/*!
+ * \brief The JobMemoryUsage class
+ * Approximate memory usage of a job in bytes. Elements are counted with their object size, statistics with the size
+ * of their matrices and vectors. Strings, signal connections and the index overhead of the feature container are not included
+ */
+class JobMemoryUsage{
+public:
+    JobMemoryUsage() : numObservations(0), observations(0), numReadings(0), readings(0), numInputElements(0),
+        inputElements(0), statistics(0), caches(0){}
+
+    qint64 getTotal() const{
+        qint64 total = this->observations + this->readings + this->inputElements + this->statistics + this->caches;
+        foreach(const qint64 &bytes, this->features){
+            total += bytes;
+        }
+        return total;
+    }
+
+    QMap<FeatureTypes, int> numFeatures;
+    QMap<FeatureTypes, qint64> features;
+
+    int numObservations;
+    qint64 observations;
+    int numReadings;
+    qint64 readings;
+
+    int numInputElements; //input elements of all functions
+    qint64 inputElements;
+
+    qint64 statistics; //statistic matrices and vectors of the geometries
+    qint64 caches; //change tracking of the job
+};
+
 /*!
  * \brief The OiJob class
  * Represents an OpenIndy job (holds all features and active states)
@@ -39,6 +73,9 @@ enum CompatibilyCheckResult{
 class OI_CORE_EXPORT OiJob : public QObject
 {
     friend class ::ProjectExchanger;
+    friend class Function;
+    friend class Geometry;
+    friend class CoordinateSystem;
     Q_OBJECT
 
 public:
@@ -63,6 +100,7 @@ public:
     void setLoadedProjectVersion(const QString &loadedVersion);
 
     int generateUniqueId();
+    int generateUniqueIds(const int &count);
 
     bool validateFeatureName(const QString &name, const FeatureTypes &type, const bool &isNominal = false,
                              const QPointer<CoordinateSystem> &nominalSystem = QPointer<CoordinateSystem>(NULL));
@@ -99,6 +137,10 @@ public:
     QList<QPointer<FeatureWrapper> > getFeaturesByType(const FeatureTypes &type) const;
     QList<QPointer<Geometry> > getGeometriesByMConfig(const MeasurementConfigKey &key) const;
 
+    //search features by name (e.g. search as you type)
+    QList<QPointer<FeatureWrapper> > getFeaturesByNamePrefix(const QString &prefix, const int &offset = 0, const int &limit = -1) const;
+    int getFeatureCountByNamePrefix(const QString &prefix) const;
+
     //access active features
     const QPointer<FeatureWrapper> &getActiveFeature() const;
     const QPointer<Station> &getActiveStation() const;
@@ -111,6 +153,21 @@ public:
     const QString &getActiveGroup() const;
     bool setActiveGroup(const QString &group);
 
+    //get changes since a change sequence number (e.g. for polling clients)
+    const quint64 &getChangeSequence() const;
+    QList<int> getFeaturesChangedSince(const quint64 &sequence) const;
+    QList<int> getFeaturesRemovedSince(const quint64 &sequence) const;
+    QList<int> getObservationsChangedSince(const quint64 &sequence) const;
+    bool getIsChangeTracked(const quint64 &sequence) const;
+
+    //get execution statistics of the functions (e.g. to find the features that dominate a recalculation)
+    QMap<int, QList<FunctionExecutionStatistic> > getFunctionExecutionStatistics() const;
+    QList<int> getFeaturesByExecutionTime(const int &limit = -1) const;
+    void resetFunctionExecutionStatistics();
+
+    //get the approximate memory usage of the job (maintained when elements are added or removed)
+    JobMemoryUsage getMemoryUsage() const;
+
     //######################
     //add or remove features
     //######################
@@ -166,6 +223,17 @@ public:
 
     void createTemplateFromJob();
 
+    //###############################################
+    //profile of the hot paths (process wide, opt-in)
+    //###############################################
+
+    bool getIsProfilingEnabled() const;
+    void setIsProfilingEnabled(const bool &isEnabled);
+    void resetProfile();
+
+    QJsonObject getProfile() const;
+    QJsonObject getProfileTrace() const;
+
 signals:
 
     //#########################################
@@ -210,6 +278,7 @@ signals:
     void geometryStatisticChanged(const int &featureId);
     void geometrySimulationDataChanged(const int &featureId);
     void geometryMeasurementConfigChanged(const int &featureId, const QString &oldMConfig, const MeasurementConfigKey oldKey);
+    void geometryParametersChanged(const int &featureId);
 
     //coordinate system specific attributes changed
     void systemObservationsChanged(const int &featureId, const int &obsId);
@@ -278,6 +347,7 @@ private slots:
     void setGeometryStatistic(const int &featureId);
     void setGeometrySimulationData(const int &featureId);
     void setGeometryMeasurementConfig(const int &featureId, const QString &oldMConfig, const MeasurementConfigKey oldKey);
+    void setGeometryParameters(const int &featureId);
 
     //coordinate system specific attributes changed
     void setSystemObservations(const int &featureId, const int &obsId);
@@ -307,11 +377,32 @@ private:
     void connectFeature(const QPointer<FeatureWrapper> &feature);
     void disconnectFeature(const QPointer<FeatureWrapper> &feature);
 
+    //#####################
+    //update the change log
+    //#####################
+
+    void updateChangeSequence(const int &featureId, const bool &observationsChanged = false);
+    void updateRemovedSequence(const int &featureId);
+
+    //##############################################################################
+    //update the memory usage (called by features, functions and coordinate systems)
+    //##############################################################################
+
+    void addFeatureMemoryUsage(const QPointer<FeatureWrapper> &feature);
+    void releaseFeatureMemoryUsage(const int &featureId, const FeatureTypes &type);
+    static qint64 getFeatureMemoryUsage(const FeatureTypes &type);
+    void addObservationMemoryUsage(const int &count);
+    void addInputElementMemoryUsage(const int &count);
+    void addStatisticMemoryUsage(const qint64 &bytes);
+
     //##############
     //helper methods
     //##############
 
     QStringList createFeatureNames(const QString &name, const int &count) const;
+    QHash<QString, QList<QPointer<FeatureWrapper> > > getFeaturesByNames(const QStringList &names) const;
+    bool validateFeatureName(const QList<QPointer<FeatureWrapper> > &equalNameFeatures, const FeatureTypes &type,
+                             const bool &isNominal, const QPointer<CoordinateSystem> &nominalSystem) const;
     QPointer<FeatureWrapper> createFeatureWrapper(const FeatureTypes &type, bool isNominal = false) const;
     bool checkAndSetUpNewFeature(const QPointer<FeatureWrapper> &feature, bool overwrite = false);
 
@@ -361,6 +452,26 @@ private:
 
     int nextId; //the next free id an element of this job could get
 
+    //###############
+    //change tracking
+    //###############
+
+    quint64 changeSequence; //increased on every feature, observation or attribute change
+    QMap<quint64, int> featureChanges; //last change sequence number -> feature id
+    QHash<int, quint64> featureSequences; //feature id -> last change sequence number
+    QMap<quint64, int> observationChanges; //last observation change sequence number -> feature id
+    QHash<int, quint64> observationSequences; //feature id -> last observation change sequence number
+    QMap<quint64, int> removedFeatures; //removal sequence number -> feature id (only the latest maxRemovedFeatures)
+    quint64 prunedSequence; //removals up to this sequence number are no longer tracked
+    static const int maxRemovedFeatures = 10000;
+
+    //############
+    //memory usage
+    //############
+
+    JobMemoryUsage memoryUsage; //without the caches (see getMemoryUsage)
+    QSet<int> memoryUsageFeatures; //ids of the features whose size is included in memoryUsage
+
     void enableOrDisableObservations(const int &featureId, bool enable);
     void enableOrDisableStationObservations(QPointer<Station> station, bool enable);
     void enableOrDisableGeometryObservations(const int &featureId, bool enable, QPointer<Station> station);
@@ -0,0 +1,65 @@
+#ifndef OIREQUESTENCODER_H
+#define OIREQUESTENCODER_H
+
+#include <QPointer>
+#include <QList>
+#include <QByteArray>
+#include <QVariantMap>
+
+#include "oirequestresponse.h"
+
+namespace oi{
+
+class OiJob;
+
+/*!
+ * \brief The OiRequestEncoder class
+ * Reads and writes the compact encodings of OiRequestResponse (JSON or binary) straight from the job without building a DOM.
+ *
+ * JSON messages are objects {"type": <RequestType>, "error": <ErrorCode>, "requester": <id>, "data": ...}.
+ * Requests use "id" (one feature) or "ids" (list of features) as data.
+ * Delta requests additionally contain "since": <change sequence> and are answered by
+ * {"sequence": S, "features": [...], "removed": [ids]} (eGetFeatures) or {"sequence": S, "geometries": [...]} (eGetObservations).
+ *
+ * Binary messages are little-endian frames:
+ * quint32 length of the rest of the frame, quint16 RequestType, quint16 ErrorCode, qint32 requester id, payload.
+ * Strings are written as quint16 length + UTF-8 bytes, doubles as IEEE 754.
+ * Request payload: quint32 count, qint32 feature ids, optional quint64 change sequence (delta request).
+ * eGetFeatures payload: quint32 count, per feature qint32 id, quint16 FeatureTypes, quint8 flags (1 solved, 2 nominal),
+ * name, quint8 number of parameters, per parameter quint8 GeometryParameters and double value.
+ * eGetObservations payload: qint32 feature id, quint32 count, per observation qint32 id, quint8 flags (1 valid, 2 solved),
+ * x, y, z, sigma x, sigma y, sigma z.
+ * Delta eGetFeatures payload: quint64 change sequence, eGetFeatures payload, quint32 count, qint32 ids of removed features.
+ * Delta eGetObservations payload: quint64 change sequence, quint32 count, eGetObservations payload per geometry.
+ * eRealTimeReading payload: quint16 count, per entry key, quint8 tag (0 double, 1 string) and value
+ */
+class OI_CORE_EXPORT OiRequestEncoder
+{
+public:
+
+    //##############
+    //parse requests
+    //##############
+
+    static bool decodeRequest(OiRequestResponse &request, QList<int> &featureIds);
+    static bool decodeRequest(OiRequestResponse &request, QList<int> &featureIds, quint64 &sinceSequence, bool &isDelta);
+
+    //####################################
+    //write responses of the request types
+    //####################################
+
+    static bool encodeFeatures(const QPointer<OiJob> &job, OiRequestResponse &request, const QList<int> &featureIds);
+    static bool encodeObservations(const QPointer<OiJob> &job, OiRequestResponse &request, const int &featureId);
+
+    //delta responses (changes since the change sequence a client has last seen)
+    static bool encodeFeatureChanges(const QPointer<OiJob> &job, OiRequestResponse &request, const quint64 &sinceSequence);
+    static bool encodeObservationChanges(const QPointer<OiJob> &job, OiRequestResponse &request, const quint64 &sinceSequence);
+    static bool encodeRealTimeReading(const QVariantMap &reading, OiRequestResponse &response);
+
+    static void encodeError(OiRequestResponse &response, const OiRequestResponse::ErrorCode &error);
+
+};
+
+}
+
+#endif // OIREQUESTENCODER_H
@@ -2,6 +2,7 @@
 #define OIREQUESTRESPONSE_H
 
 #include <QString>
+#include <QByteArray>
 #include <QtXml>
 
 #include "types.h"
@@ -10,11 +11,13 @@ namespace oi{
 
 /*!
  * \brief The OiRequestResponse class
- * This class holds the XML request and response corresponding to a special request type
+ * This class holds the XML request and response corresponding to a special request type.
+ * Clients that do not use XML send and receive compact JSON or binary frames instead (see OiRequestEncoder)
  */
 class OiRequestResponse
 {
 public:
+    OiRequestResponse() : myRequestType(eUnknownRequest), requesterId(-1), encoding(eXmlEncoding){}
 
     enum RequestType{
 
@@ -76,7 +79,16 @@ public:
         eCreateFeatureError,
         eNoMeasurementConfigManager,
         eNoSensorConfigManager,
-        eNoMeasurementConfig
+        eNoMeasurementConfig,
+        eSequenceExpired //the changes since the requested sequence are no longer tracked (request again with sequence 0)
+
+    };
+
+    enum Encoding{
+
+        eXmlEncoding = 0, //request and response are DOM documents
+        eJsonEncoding, //requestData and responseData hold compact JSON
+        eBinaryEncoding //requestData and responseData hold length-prefixed binary frames
 
     };
 
@@ -85,6 +97,10 @@ public:
     QDomDocument response; //holds the XML structure of the response
     int requesterId; //identifies the requester so that the response is send only to him
 
+    Encoding encoding; //defines which members hold the request and response
+    QByteArray requestData; //holds the JSON or binary request
+    QByteArray responseData; //holds the JSON or binary response
+
 };
 
 }
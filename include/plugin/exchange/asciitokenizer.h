@@ -0,0 +1,68 @@
+#ifndef ASCIITOKENIZER_H
+#define ASCIITOKENIZER_H
+
+#include <QString>
+#include <QVector>
+#include <QByteArray>
+
+#include "types.h"
+
+namespace oi{
+
+/*!
+ * \brief The AsciiField class
+ * View on one field of a line (the characters are not copied)
+ */
+class OI_CORE_EXPORT AsciiField{
+public:
+    AsciiField() : begin(0), length(0){}
+    AsciiField(const char *begin, const int &length) : begin(begin), length(length){}
+
+    bool isEmpty() const{ return this->length == 0; }
+
+    bool toDouble(double &value) const;
+    QString toString() const;
+
+    const char *begin;
+    int length;
+};
+
+/*!
+ * \brief The AsciiTokenizer class
+ * Splits a contiguous block of ascii data (e.g. a mapped file) into lines and fields without copying it.
+ * Lines may end with \n or \r\n. If no delimiter char is set, fields are separated by one or more whitespaces
+ */
+class OI_CORE_EXPORT AsciiTokenizer
+{
+public:
+    AsciiTokenizer(const char *data, const qint64 &size, const char &delimiter = '\0');
+
+    //#######################
+    //tokenize the ascii data
+    //#######################
+
+    bool nextLine(QVector<AsciiField> &fields);
+    bool skipLine();
+
+    const qint64 &getPosition() const;
+    const qint64 &getSize() const;
+
+    //##############
+    //helper methods
+    //##############
+
+    static char delimiterFromString(const QString &delimiter);
+    static bool parseDouble(const char *begin, const char *end, double &value);
+
+private:
+
+    const char *data;
+    qint64 size;
+    qint64 position;
+    char delimiter;
+
+};
+
+}
+
+#endif // ASCIITOKENIZER_H
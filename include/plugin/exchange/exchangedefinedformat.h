@@ -29,6 +29,12 @@ public:
 
 protected:
 
+    //#############################################
+    //create an asynchronous export of the features
+    //#############################################
+
+    QPointer<ExportEngine> createExportEngine() const;
+
     //###########################
     //input and output parameters
     //###########################
@@ -5,10 +5,12 @@
 #include <QPointer>
 #include <QIODevice>
 #include <QStringList>
+#include <QThread>
 
 #include "pluginmetadata.h"
 #include "coordinatesystem.h"
 #include "featurewrapper.h"
+#include "exportengine.h"
 
 namespace oi{
 
@@ -39,7 +41,11 @@ public:
     const QList<GeometryTypes> &getSupportedGeometries();
 
     const QPointer<QIODevice> &getDevice() const;
-    void setDevice(const QPointer<QIODevice> &device);
+    bool setDevice(const QPointer<QIODevice> &device);
+
+    bool mapDevice(const char *&data, qint64 &size);
+    void unmapDevice();
+    bool getIsDeviceMapped() const;
 
     const QList<QPointer<FeatureWrapper> > &getFeatures() const;
     void setFeatures(const QList<QPointer<FeatureWrapper> > &features);
@@ -56,6 +62,8 @@ public:
     const QMap<DimensionType, UnitType> &getUnits() const;
     void setUnit(const DimensionType &dimension, const UnitType &unit);
 
+    bool getIsExportRunning() const;
+
 public slots:
 
     //#########################
@@ -65,6 +73,8 @@ public slots:
     virtual void importOiData();
     virtual void exportOiData();
 
+    void cancelExport();
+
 signals:
 
     //################################################
@@ -78,6 +88,12 @@ signals:
 
 protected:
 
+    //####################################
+    //run an export in a background thread
+    //####################################
+
+    bool startAsyncExport(const QPointer<ExportEngine> &engine);
+
     //###########################
     //input and output parameters
     //###########################
@@ -94,6 +110,27 @@ protected:
     PluginMetaData metaData;
     QList<GeometryTypes> supportedGeometries;
 
+private slots:
+
+    //#########################################
+    //clean up after an asynchronous export run
+    //#########################################
+
+    void asyncExportFinished(const bool &success);
+
+private:
+
+    //#################
+    //helper attributes
+    //#################
+
+    QPointer<ExportEngine> exportEngine;
+    QPointer<QThread> exportThread;
+
+    //contiguous view on the device (mapped file or buffered copy)
+    uchar *mappedData;
+    QByteArray deviceBuffer;
+
 };
 
 }
@@ -1,13 +1,19 @@
 #ifndef EXCHANGESIMPLEASCII_H
 #define EXCHANGESIMPLEASCII_H
 
+#include <functional>
+
 #include <QVariantList>
+#include <QVector>
 
 #include "exchangeinterface.h"
+#include "asciitokenizer.h"
 #include "oijob.h"
 
 namespace oi{
 
+class SimpleAsciiRow;
+
 /*!
  * \brief The ExchangeSimpleAscii class
  * Interface that shall be used for simple not standardized ascii files.
@@ -90,6 +96,18 @@ public:
 
 protected:
 
+    //#############################################
+    //create an asynchronous export of the features
+    //#############################################
+
+    QPointer<ExportEngine> createExportEngine() const;
+
+    //#############################
+    //parse the device line by line
+    //#############################
+
+    bool parseAsciiData(const std::function<bool(const SimpleAsciiRow &row)> &rowHandler);
+
     //###########################
     //input and output parameters
     //###########################
@@ -109,6 +127,33 @@ protected:
 
 };
 
+/*!
+ * \brief The SimpleAsciiRow class
+ * One parsed line of an ascii import. The fields reference the file data,
+ * values are converted to the default units when they are requested
+ */
+class OI_CORE_EXPORT SimpleAsciiRow
+{
+    friend class ExchangeSimpleAscii;
+
+public:
+    SimpleAsciiRow();
+
+    bool hasColumn(const ExchangeSimpleAscii::ColumnType &column) const;
+    bool getValue(const ExchangeSimpleAscii::ColumnType &column, double &value) const;
+    QString getText(const ExchangeSimpleAscii::ColumnType &column) const;
+
+    const QVector<AsciiField> &getFields() const;
+    const int &getLineNumber() const;
+
+private:
+    QVector<AsciiField> fields;
+    int lineNumber;
+
+    QVector<int> columnIndices; //field index for each column type (-1 if not available)
+    QVector<int> columnUnits; //unit type for each column type (-1 if the value is not converted)
+};
+
 }
 
 #ifndef STR
@@ -0,0 +1,130 @@
+#ifndef EXPORTENGINE_H
+#define EXPORTENGINE_H
+
+#include <functional>
+
+#include <QObject>
+#include <QPointer>
+#include <QIODevice>
+#include <QVariantList>
+#include <QVector>
+#include <QByteArray>
+#include <QAtomicInt>
+
+#include "types.h"
+
+namespace oi{
+
+/*!
+ * \brief The ExportRecord class
+ * One row of an export. The fields are captured in the calling thread (job snapshot),
+ * so that formatting and writing do not need to access any feature afterwards.
+ */
+class OI_CORE_EXPORT ExportRecord{
+public:
+    QVariantList fields; //ordered column values (doubles are formatted with the column digits, all other values as string)
+};
+
+/*!
+ * \brief The ExportEngine class
+ * Formats a list of export records in parallel chunks and writes them in order to a device.
+ * The engine is meant to be moved to a worker thread and started by calling run()
+ */
+class OI_CORE_EXPORT ExportEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef std::function<QByteArray(const ExportRecord &record)> RecordFormatter;
+
+    explicit ExportEngine(QObject *parent = 0);
+
+    ~ExportEngine();
+
+    //###################################
+    //set up the export before running it
+    //###################################
+
+    const QPointer<QIODevice> &getDevice() const;
+    void setDevice(const QPointer<QIODevice> &device);
+
+    const QVector<ExportRecord> &getRecords() const;
+    void setRecords(const QVector<ExportRecord> &records);
+
+    const QByteArray &getHeader() const;
+    void setHeader(const QByteArray &header);
+
+    const QString &getDelimiter() const;
+    void setDelimiter(const QString &delimiter);
+
+    const QVector<int> &getColumnDigits() const;
+    void setColumnDigits(const QVector<int> &digits);
+
+    void setFormatter(const RecordFormatter &formatter);
+
+    const int &getChunkSize() const;
+    void setChunkSize(const int &chunkSize);
+
+    const int &getBufferSize() const;
+    void setBufferSize(const int &bufferSize);
+
+    //#####################
+    //get the export status
+    //#####################
+
+    bool getIsCanceled() const;
+    const qint64 &getBytesWritten() const;
+
+public slots:
+
+    //#############################
+    //run or cancel the export task
+    //#############################
+
+    void run();
+    void cancel();
+
+signals:
+
+    //##################################
+    //inform about the export processing
+    //##################################
+
+    void sendMessage(const QString &msg, const MessageTypes &msgType, const MessageDestinations &msgDest = eConsoleMessage);
+    void updateProgress(const int &progress, const QString &msg);
+    void finished(const bool &success);
+
+private:
+
+    //##############
+    //helper methods
+    //##############
+
+    QByteArray formatChunk(const int &chunk) const;
+    QByteArray formatRecord(const ExportRecord &record) const;
+
+    bool flush(QByteArray &buffer);
+
+    //#################
+    //helper attributes
+    //#################
+
+    QPointer<QIODevice> device;
+
+    QVector<ExportRecord> records;
+    QByteArray header;
+    QString delimiter;
+    QVector<int> columnDigits;
+    RecordFormatter formatter;
+
+    int chunkSize; //number of records formatted by one task
+    int bufferSize; //number of bytes collected before the device is written
+
+    QAtomicInt isCanceled;
+    qint64 bytesWritten;
+
+};
+
+}
+
+#endif // EXPORTENGINE_H
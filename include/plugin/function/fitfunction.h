@@ -3,6 +3,7 @@
 
 #include "function.h"
 #include <random>
+#include <algorithm>
 
 namespace oi{
 
@@ -42,6 +43,12 @@ enum ApproximationTypes{
     eFirstTwoDummyPoint
 };
 
+enum RobustEstimators{
+    eNoRobustEstimator = 0,
+    eHuberEstimator,
+    eTukeyEstimator
+};
+
 /*!
  * \brief The FitFunction class
  * Function that solves geometries by fitting them using observations
@@ -85,6 +92,108 @@ class OI_CORE_EXPORT BestFitUtil: public FunctionUtil
 {
 protected:
 
+    /*!
+     * \brief getRobustEstimator
+     * Reads the robust estimator from the string parameter "robust estimator" (none, huber, tukey)
+     * and the tuning constant from the double parameter "robust tuning constant" (default 1.345 for Huber and 4.685 for Tukey)
+     * \param function
+     * \param tuningConstant
+     * \return
+     */
+    RobustEstimators getRobustEstimator(FitFunction *function, double &tuningConstant) {
+        RobustEstimators estimator = eNoRobustEstimator;
+        QString value = function->getScalarInputParams().stringParameter.value("robust estimator");
+        if(value.compare("huber", Qt::CaseInsensitive) == 0){
+            estimator = eHuberEstimator;
+            tuningConstant = 1.345;
+        }else if(value.compare("tukey", Qt::CaseInsensitive) == 0){
+            estimator = eTukeyEstimator;
+            tuningConstant = 4.685;
+        }
+        if(function->getScalarInputParams().doubleParameter.contains("robust tuning constant")
+                && function->getScalarInputParams().doubleParameter.value("robust tuning constant") > 0.0){
+            tuningConstant = function->getScalarInputParams().doubleParameter.value("robust tuning constant");
+        }
+        return estimator;
+    }
+
+    /*!
+     * \brief updateRobustWeights
+     * One reweighting step of an iteratively reweighted least squares fit. The residuals are standardized
+     * by the median absolute deviation of all residuals. Returns true if no weight changed by more than 1e-4
+     * \param residuals
+     * \param weights
+     * \param estimator
+     * \param tuningConstant
+     * \return
+     */
+    bool updateRobustWeights(const QVector<double> &residuals, QVector<double> &weights, const RobustEstimators &estimator, const double &tuningConstant) {
+
+        int n = residuals.size();
+        if(weights.size() != n){
+            weights.fill(1.0, n);
+        }
+
+        //robust scale (MAD), the scratch buffer is reused between iterations
+        this->robustScratch.resize(n);
+        for(int i = 0; i < n; i++){
+            this->robustScratch[i] = qAbs(residuals.at(i));
+        }
+        double scale = 0.0;
+        if(n > 0){
+            std::nth_element(this->robustScratch.begin(), this->robustScratch.begin() + n / 2, this->robustScratch.end());
+            scale = this->robustScratch.at(n / 2) / 0.6745;
+        }
+        if(scale <= numeric_limits<double>::epsilon()){
+            return true;
+        }
+
+        //reweight
+        double maxChange = 0.0;
+        for(int i = 0; i < n; i++){
+            double u = qAbs(residuals.at(i)) / (scale * tuningConstant);
+            double w = 1.0;
+            switch(estimator){
+            case eHuberEstimator:
+                w = u <= 1.0 ? 1.0 : 1.0 / u;
+                break;
+            case eTukeyEstimator:
+                w = u < 1.0 ? (1.0 - u * u) * (1.0 - u * u) : 0.0;
+                break;
+            default:
+                break;
+            }
+            maxChange = qMax(maxChange, qAbs(w - weights.at(i)));
+            weights[i] = w;
+        }
+
+        return maxChange < 1e-4;
+
+    }
+
+    /*!
+     * \brief writeRobustWeights
+     * Writes the weights of the observations (input elements at position 0) back to the function in one batch.
+     * Observations with a weight of 0 are marked as not used
+     * \param function
+     * \param points
+     * \param weights
+     */
+    void writeRobustWeights(FitFunction *function, const QList<IdPoint> &points, const QVector<double> &weights) {
+        QHash<int, double> elementWeights;
+        elementWeights.reserve(points.size());
+        for(int i = 0; i < points.size() && i < weights.size(); i++){
+            elementWeights.insert(points.at(i).id, weights.at(i));
+        }
+        function->setWeights(0, elementWeights);
+    }
+
+    //robust fit buffers (reused between iterations)
+    QVector<double> robustCoordinates; //x, y, z of each point
+    QVector<double> robustResiduals;
+    QVector<double> robustWeights;
+    QVector<double> robustScratch;
+
     bool hasDummyPoint(FitFunction *function) {
         return function->getInputElements().contains(InputElementKey::eDummyPoint)
                 && function->getInputElements()[InputElementKey::eDummyPoint].size() > 0;
@@ -184,6 +293,150 @@ protected:
         return true;
     }
 
+    /*!
+     * \brief bestFitPlane
+     * Fits the plane robustly if the function selects a robust estimator (see getRobustEstimator), otherwise
+     * the plain principal component analysis is used. Plane fit plugins offer the option by adding "robust estimator"
+     * (none, huber, tukey) to their stringParameters
+     * \param function
+     * \param centroid
+     * \param normal
+     * \param eVal
+     * \param points
+     * \return
+     */
+    bool bestFitPlane(FitFunction *function, OiVec &centroid, OiVec &normal, double &eVal, const QList<IdPoint> &points) {
+        double tuningConstant = 0.0;
+        RobustEstimators estimator = this->getRobustEstimator(function, tuningConstant);
+        if(estimator == eNoRobustEstimator){
+            return this->bestFitPlane(centroid, normal, eVal, points);
+        }
+        return this->bestFitPlaneRobust(function, centroid, normal, eVal, points, estimator, tuningConstant);
+    }
+
+    /*!
+     * \brief bestFitPlaneRobust
+     * Iteratively reweighted plane fit (weighted principal component analysis). The loop always ends with a solve,
+     * so the weights in robustWeights (which are written back to the function) are the ones of the returned plane.
+     * Rejected points (weight 0) are marked as not used
+     * \param function
+     * \param centroid
+     * \param normal
+     * \param eVal
+     * \param points
+     * \param estimator
+     * \param tuningConstant
+     * \param maxIterations
+     * \return
+     */
+    bool bestFitPlaneRobust(FitFunction *function, OiVec &centroid, OiVec &normal, double &eVal, const QList<IdPoint> &points,
+                            const RobustEstimators &estimator, const double &tuningConstant, const int &maxIterations = 30) {
+
+        int n = points.size();
+        if(n < 3) {
+            return false;
+        }
+
+        //copy coordinates once into a contiguous buffer
+        this->robustCoordinates.resize(3 * n);
+        for(int i = 0; i < n; i++){
+            this->robustCoordinates[3*i] = points.at(i).xyz.getAt(0);
+            this->robustCoordinates[3*i+1] = points.at(i).xyz.getAt(1);
+            this->robustCoordinates[3*i+2] = points.at(i).xyz.getAt(2);
+        }
+        this->robustWeights.fill(1.0, n);
+        this->robustResiduals.resize(n);
+        const double *xyz = this->robustCoordinates.constData();
+
+        OiMat ata(3, 3);
+        OiMat u(3, 3);
+        OiVec d(3);
+        OiMat v(3, 3);
+        OiVec mean(3);
+        int numIterations = 0;
+        bool isConverged = false;
+        for(int iteration = 0; iteration < maxIterations; iteration++){
+
+            numIterations = iteration + 1;
+
+            //weighted centroid
+            double sw = 0.0, cx = 0.0, cy = 0.0, cz = 0.0;
+            for(int i = 0; i < n; i++){
+                double w = this->robustWeights.at(i);
+                sw += w;
+                cx += w * xyz[3*i];
+                cy += w * xyz[3*i+1];
+                cz += w * xyz[3*i+2];
+            }
+            if(sw <= 0.0){
+                return false;
+            }
+            cx /= sw;
+            cy /= sw;
+            cz /= sw;
+
+            //weighted covariance matrix
+            double c[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+            for(int i = 0; i < n; i++){
+                double w = this->robustWeights.at(i);
+                double dx = xyz[3*i] - cx, dy = xyz[3*i+1] - cy, dz = xyz[3*i+2] - cz;
+                c[0] += w * dx * dx;
+                c[1] += w * dx * dy;
+                c[2] += w * dx * dz;
+                c[3] += w * dy * dy;
+                c[4] += w * dy * dz;
+                c[5] += w * dz * dz;
+            }
+            ata.setAt(0, 0, c[0]); ata.setAt(0, 1, c[1]); ata.setAt(0, 2, c[2]);
+            ata.setAt(1, 0, c[1]); ata.setAt(1, 1, c[3]); ata.setAt(1, 2, c[4]);
+            ata.setAt(2, 0, c[2]); ata.setAt(2, 1, c[4]); ata.setAt(2, 2, c[5]);
+            ata.svd(u, d, v);
+
+            //get smallest eigenvector which is n vector
+            int eigenIndex = 0;
+            for(int i = 1; i < d.getSize(); i++){
+                if(d.getAt(i) < d.getAt(eigenIndex)){
+                    eigenIndex = i;
+                }
+            }
+            eVal = d.getAt(eigenIndex);
+            u.getCol(normal, eigenIndex);
+            normal.normalize();
+            mean.setAt(0, cx);
+            mean.setAt(1, cy);
+            mean.setAt(2, cz);
+
+            if(estimator == eNoRobustEstimator){
+                isConverged = true;
+                break;
+            }
+
+            //stop after the solve with the converged (or last) weights
+            if(isConverged || iteration + 1 == maxIterations){
+                break;
+            }
+
+            //residuals and new weights
+            double nx = normal.getAt(0), ny = normal.getAt(1), nz = normal.getAt(2);
+            for(int i = 0; i < n; i++){
+                this->robustResiduals[i] = nx * (xyz[3*i] - cx) + ny * (xyz[3*i+1] - cy) + nz * (xyz[3*i+2] - cz);
+            }
+            isConverged = this->updateRobustWeights(this->robustResiduals, this->robustWeights, estimator, tuningConstant);
+
+        }
+        centroid = mean;
+
+        //report the reweighting iterations
+        if(estimator != eNoRobustEstimator){
+            function->setIterations(numIterations, maxIterations, isConverged);
+        }
+
+        //write weights and used flags back in one batch
+        this->writeRobustWeights(function, points, this->robustWeights);
+
+        return true;
+    }
+
     void addDisplayResidual(FitFunction *function, QList<InputElement> &elements, OiVec normal, double dist) {
         double distance = 0.0;
         OiVec v_plane(3);
@@ -1123,6 +1376,8 @@ protected:
 
         }while( stopXX > 0.0000000000001 && numIterations < 1000 );
 
+        function->setIterations(numIterations, 1000, numIterations < 1000);
+
         if(numIterations >= 1000){
             emit function->sendMessage(QString("to many iterations: %1").arg(numIterations), eWarningMessage);
             return false;
@@ -2,6 +2,7 @@
 #define FUNCTION_H
 
 #include <QMap>
+#include <QHash>
 #include <QMultiMap>
 #include <QStringList>
 #include <QtXml>
@@ -69,8 +70,8 @@ public:
  */
 class InputElement{
 public:
-    InputElement() : isUsed(true), shouldBeUsed(true), id(-1){}
-    InputElement(const int &id) : isUsed(true), shouldBeUsed(true), id(id){}
+    InputElement() : isUsed(true), shouldBeUsed(true), weight(1.0), id(-1){}
+    InputElement(const int &id) : isUsed(true), shouldBeUsed(true), weight(1.0), id(id){}
 
     //! custom comparison operator to compare input elements by their id
     bool operator==(const InputElement &other){
@@ -91,6 +92,7 @@ public:
 
     bool shouldBeUsed; //true if this element should be used in function calculation (user specified)
     bool isUsed; //true if this element is used in function calculation (plugin specified)
+    double weight; //weight of this element in the last function calculation, e.g. of a robust fit (plugin specified)
 
     //element pointers (only valid for the specified element type)
     QPointer<Station> station;
@@ -150,6 +152,32 @@ public:
     double value;
 };
 
+/*!
+ * \brief The FunctionExecutionStatistic class
+ * Cost of the executions of a function (times in ns). The input elements, iterations and
+ * convergence state refer to the last execution
+ */
+class FunctionExecutionStatistic{
+public:
+    FunctionExecutionStatistic() : numExecutions(0), lastTime(0), totalTime(0), maxTime(0), numInputElements(0),
+        numIterations(-1), maxIterations(-1), isConverged(false), isSolved(false){}
+
+    double getMeanTime() const{
+        return this->numExecutions > 0 ? (double)this->totalTime / (double)this->numExecutions : 0.0;
+    }
+
+    int numExecutions;
+    qint64 lastTime;
+    qint64 totalTime;
+    qint64 maxTime;
+
+    int numInputElements;
+    int numIterations; //-1 if the function did not report iterations
+    int maxIterations; //iteration limit of the function (-1 if unknown)
+    bool isConverged; //equal to isSolved if the function did not report iterations
+    bool isSolved;
+};
+
 class OI_CORE_EXPORT FunctionUtil
 {
 protected:
@@ -192,6 +220,8 @@ protected:
 class OI_CORE_EXPORT Function : public QObject
 {
     friend class Feature;
+    friend class OiJob;
+    friend class BestFitUtil;
     friend class BestFitPlaneUtil;
 
     Q_OBJECT
@@ -241,6 +271,9 @@ public:
 
     const Statistic &getStatistic() const;
 
+    const FunctionExecutionStatistic &getExecutionStatistic() const;
+    void resetExecutionStatistic();
+
     //###############
     //general getters
     //###############
@@ -331,6 +364,13 @@ protected:
     //#################################
 
     void setIsUsed(const int &position, const int &id, const bool &state);
+    void setWeights(const int &position, const QHash<int, double> &weights);
+
+    //#######################################
+    //report iterations of an iterative solve
+    //#######################################
+
+    void setIterations(const int &numIterations, const int &maxIterations, const bool &isConverged);
 
     //###########################
     //input and output parameters
@@ -371,6 +411,26 @@ protected:
     void addDisplayResidual(int elementId, double vx, double vy, double vz, double v);
     void addDisplayResidual(int elementId, double vx, double vy, double vz, double v, double vi, double vj, double vk);
 
+private:
+
+    //#############################################
+    //record executions (called by Feature::recalc)
+    //#############################################
+
+    void startExecution();
+    void finishExecution(const qint64 &time, const bool &isSolved);
+
+    FunctionExecutionStatistic executionStatistic;
+
+    //#############################################################################
+    //job whose memory usage includes the input elements (set by Feature and OiJob)
+    //#############################################################################
+
+    void setJob(const QPointer<OiJob> &job);
+    int getNumInputElements() const;
+
+    QPointer<OiJob> job;
+
 };
 
 }
@@ -11,6 +11,7 @@
 #include "pluginmetadata.h"
 #include "oijob.h"
 #include "types.h"
+#include "bundleengine.h"
 
 namespace oi{
 
@@ -207,8 +208,26 @@ private:
     void connectJob();
     void disconnectJob();
 
+private slots:
+
+    //#########################################
+    //invalidate parts of the previous solution
+    //#########################################
+
+    void systemObservationsChanged(const int &featureId, const int &obsId);
+    void stationSensorChanged(const int &featureId);
+
 protected:
 
+    //#####################################################
+    //solve the station network with the core bundle engine
+    //#####################################################
+
+    bool solveStationNetwork();
+    bool solveStationNetwork(const BundleInput &input);
+
+    bool createBundleInput(BundleInput &input) const;
+
     //###########################
     //input and output parameters
     //###########################
@@ -238,6 +257,9 @@ protected:
     //OpenIndy job
     QPointer<OiJob> currentJob;
 
+    //sparse least squares solver (solver parameters and quality of the last solution)
+    BundleEngine bundleEngine;
+
     //##################
     //general attributes
     //##################
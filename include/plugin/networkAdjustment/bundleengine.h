@@ -0,0 +1,155 @@
+#ifndef BUNDLEENGINE_H
+#define BUNDLEENGINE_H
+
+#include <QList>
+#include <QVector>
+#include <QString>
+#include <QHash>
+#include <QSet>
+
+#include "types.h"
+#include "bundleinput.h"
+
+class BundleEngineTest;
+
+namespace oi{
+
+class BundleStation;
+class BundleGeometry;
+class BundleTransformation;
+
+/*!
+ * \brief The BundleEngine class
+ * Reusable least squares solver for the station network problem: each station observes geometries (points) in its own system,
+ * the unknowns are the transformation parameters of each station (tx, ty, tz, rx, ry, rz, m) and the point coordinates in the bundle system.
+ *
+ * The points are eliminated from the normal equations (Schur complement), so that only the reduced station system has to be solved.
+ * It is stored and factorized block-sparse: a station block only exists if two stations have common points.
+ * The base station defines the datum and is not estimated.
+ *
+ * Rotations use the convention of TrafoParam (X = t + m * Rz * Ry * Rx * x).
+ *
+ * The engine keeps its last solution: a following solve starts from it, so adding a station or re-measuring
+ * some points only needs a resection of the changed stations and usually one or two iterations.
+ */
+class OI_CORE_EXPORT BundleEngine
+{
+    friend class ::BundleEngineTest;
+
+public:
+    BundleEngine();
+
+    //#################
+    //solver parameters
+    //#################
+
+    const int &getMaxIterations() const;
+    void setMaxIterations(const int &maxIterations);
+
+    const double &getConvergenceThreshold() const;
+    void setConvergenceThreshold(const double &threshold);
+
+    //#####################################
+    //warm start from the previous solution
+    //#####################################
+
+    const bool &getIsWarmStartEnabled() const;
+    void setIsWarmStartEnabled(const bool &enabled);
+
+    bool getHasPreviousSolution() const;
+    void invalidateStation(const int &id);
+    void clearPreviousSolution();
+
+    //#################################
+    //solve the station network problem
+    //#################################
+
+    bool solve(const QList<BundleStation> &stations, const BundleStation &baseStation,
+               QList<BundleGeometry> &geometries, QList<BundleTransformation> &transformations);
+    bool solve(const BundleInput &input, QList<BundleGeometry> &geometries, QList<BundleTransformation> &transformations);
+
+    //####################
+    //get solution results
+    //####################
+
+    const QString &getErrorMessage() const;
+    const int &getIterations() const;
+    const double &getSigma0() const;
+    const int &getRedundancy() const;
+
+private:
+
+    //###########################
+    //flat problem representation
+    //###########################
+
+    class Station{
+    public:
+        int id;
+        bool isFree[7]; //tx, ty, tz, rx, ry, rz, m
+        double params[7];
+        int offset; //first index in the reduced station system
+        int size; //number of free parameters
+        bool isApproximated;
+    };
+
+    class Point{
+    public:
+        int id;
+        double xyz[3];
+        bool isApproximated;
+    };
+
+    class Observation{
+    public:
+        int station;
+        int point;
+        double xyz[3]; //coordinates in the station system
+    };
+
+    //##############
+    //helper methods
+    //##############
+
+    bool setUpProblem(const BundleInput &input);
+    bool approximate();
+    bool iterate(double &maxCorrection);
+    void computeResults(QList<BundleGeometry> &geometries, QList<BundleTransformation> &transformations);
+    void storeSolution();
+
+    bool factorize(const int &numStations, QVector<QVector<double> > &blocks) const;
+    void solveFactorized(const int &numStations, const QVector<QVector<double> > &blocks, QVector<double> &x) const;
+
+    //#################
+    //helper attributes
+    //#################
+
+    //solver parameters
+    int maxIterations;
+    double convergenceThreshold;
+
+    //problem
+    QVector<Station> stations;
+    QVector<Point> points;
+    QVector<Observation> observations;
+    QVector<QVector<int> > pointObservations; //observation indices for each point
+    int baseStation; //index of the base station
+
+    //previous solution (warm start)
+    bool isWarmStartEnabled;
+    int previousBaseStation; //id of the base station of the previous solution (-1 = no solution)
+    QHash<int, QVector<double> > previousStations; //station id -> tx, ty, tz, rx, ry, rz, m
+    QHash<int, QVector<double> > previousPoints; //geometry id -> x, y, z
+    QSet<int> dirtyStations; //ids of stations whose previous parameters are outdated
+
+    //results
+    QString errorMessage;
+    int iterations;
+    double sigma0;
+    int redundancy;
+
+};
+
+}
+
+#endif // BUNDLEENGINE_H
@@ -0,0 +1,98 @@
+#ifndef BUNDLEINPUT_H
+#define BUNDLEINPUT_H
+
+#include <QList>
+#include <QVector>
+#include <QHash>
+
+#include "types.h"
+
+namespace oi{
+
+class BundleStation;
+
+/*!
+ * \brief The BundleInput class
+ * Flat representation of the bundle inputs: a station table, a geometry table and a dense observation table
+ * with station and geometry index columns. Unknowns are numbered by the parameter offset tables
+ * (free station parameters first, then three coordinates per geometry), so that solvers only touch contiguous memory.
+ */
+class OI_CORE_EXPORT BundleInput
+{
+public:
+    BundleInput();
+
+    //free station parameters (bit mask)
+    enum StationParameter{
+        eTX = 0x01,
+        eTY = 0x02,
+        eTZ = 0x04,
+        eRX = 0x08,
+        eRY = 0x10,
+        eRZ = 0x20,
+        eM = 0x40,
+        eAllParameters = 0x7F
+    };
+
+    //###############
+    //build the input
+    //###############
+
+    void clear();
+    void reserve(const int &numStations, const int &numGeometries, const int &numObservations);
+
+    int addStation(const int &id, const quint8 &freeParameters);
+    int addGeometry(const int &id);
+    void addObservation(const int &stationIndex, const int &geometryIndex, const double &x, const double &y, const double &z);
+
+    void setBaseStation(const int &stationIndex);
+    void updateParameterOffsets();
+
+    static BundleInput fromStations(const QList<BundleStation> &stations, const BundleStation &baseStation);
+    static quint8 getFreeParameters(const BundleStation &station);
+
+    //#################
+    //access the tables
+    //#################
+
+    int getNumStations() const;
+    int getNumGeometries() const;
+    int getNumObservations() const;
+    int getNumUnknowns() const;
+
+    int getBaseStation() const;
+
+    int getStationIndex(const int &id) const;
+    int getGeometryIndex(const int &id) const;
+
+    //station table
+    QVector<int> stationIds;
+    QVector<quint8> stationFreeParameters;
+    QVector<int> stationParameterOffsets; //first unknown of each station
+
+    //geometry table
+    QVector<int> geometryIds;
+    QVector<int> geometryParameterOffsets; //first unknown (x) of each geometry
+
+    //observation table
+    QVector<int> observationStations;
+    QVector<int> observationGeometries;
+    QVector<double> observationValues; //x, y, z in the station system for each observation
+
+private:
+
+    //#################
+    //helper attributes
+    //#################
+
+    int baseStation;
+    int numUnknowns;
+
+    QHash<int, int> stationIndices; //station id -> index
+    QHash<int, int> geometryIndices; //geometry id -> index
+
+};
+
+}
+
+#endif // BUNDLEINPUT_H
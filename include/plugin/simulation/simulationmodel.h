@@ -6,6 +6,9 @@
 #include <QMap>
 #include <QMultiMap>
 #include <QString>
+#include <QVector>
+#include <QPair>
+#include <random>
 
 #include "pluginmetadata.h"
 #include "reading.h"
@@ -50,13 +53,137 @@ public:
     QMap<QString, UncertaintyComponent> humanUncertainties;
 };
 
+/*!
+ * \brief The OnlineStatistic class
+ * Welford accumulator for count, mean, variance, minimum and maximum of a data series (constant memory)
+ */
+class OI_CORE_EXPORT OnlineStatistic{
+public:
+    OnlineStatistic();
+
+    void add(const double &x);
+    void merge(const OnlineStatistic &other);
+    void clear();
+
+    const qint64 &getCount() const;
+    const double &getMean() const;
+    double getVariance() const; //sample variance
+    double getStandardDeviation() const;
+    const double &getMinimum() const;
+    const double &getMaximum() const;
+
+private:
+    qint64 count;
+    double mean;
+    double m2;
+    double minValue;
+    double maxValue;
+};
+
+/*!
+ * \brief The OnlineCovariance class
+ * Online accumulator for the covariance and correlation of two data series (constant memory)
+ */
+class OI_CORE_EXPORT OnlineCovariance{
+public:
+    OnlineCovariance();
+
+    void add(const double &x, const double &y);
+    void merge(const OnlineCovariance &other);
+    void clear();
+
+    const qint64 &getCount() const;
+    double getCovariance() const; //sample covariance
+    double getCorrelation() const;
+
+private:
+    qint64 count;
+    double meanX;
+    double meanY;
+    double m2X;
+    double m2Y;
+    double cXY;
+};
+
+/*!
+ * \brief The P2QuantileEstimator class
+ * Estimates one quantile of a data series with the P-square algorithm (Jain and Chlamtac) using five markers
+ */
+class OI_CORE_EXPORT P2QuantileEstimator{
+public:
+    P2QuantileEstimator(const double &probability = 0.5);
+
+    void add(const double &x);
+    void merge(const P2QuantileEstimator &other);
+    void clear();
+
+    const double &getProbability() const;
+    const qint64 &getCount() const;
+    double getQuantile() const;
+
+private:
+    double parabolic(const int &i, const double &d) const;
+    double linear(const int &i, const int &d) const;
+
+    double probability;
+    qint64 count;
+    double heights[5]; //marker heights
+    double positions[5]; //actual marker positions
+    double desired[5]; //desired marker positions
+    double increments[5]; //increments of the desired marker positions
+};
+
+/*!
+ * \brief The OnlineHistogram class
+ * Histogram with a fixed number of equally sized bins between a lower and an upper limit
+ */
+class OI_CORE_EXPORT OnlineHistogram{
+public:
+    OnlineHistogram();
+    OnlineHistogram(const double &lowerLimit, const double &upperLimit, const int &numBins);
+
+    void add(const double &x);
+    bool merge(const OnlineHistogram &other);
+    void clear();
+
+    bool getIsValid() const;
+
+    const double &getLowerLimit() const;
+    const double &getUpperLimit() const;
+    const QVector<qint64> &getBins() const;
+    const qint64 &getUnderflow() const;
+    const qint64 &getOverflow() const;
+
+private:
+    double lowerLimit;
+    double upperLimit;
+    QVector<qint64> bins;
+    qint64 underflow;
+    qint64 overflow;
+};
+
 /*!
  * \brief The UncertaintyData class
  * Save information about simulation results for one geometry parameter
  */
 class OI_CORE_EXPORT UncertaintyData{
 public:
-    QList<double> values; //randomly shuffled values produced distortion of readings and recalculation
+    UncertaintyData();
+
+    //######################################
+    //streaming collection of simulated data
+    //######################################
+
+    void addValue(const double &x);
+    void merge(const UncertaintyData &other);
+    void updateResults();
+
+    QList<double> values; //randomly shuffled values produced distortion of readings and recalculation (only filled if storeValues is true)
+    bool storeValues;
+
+    OnlineStatistic statistic; //always updated by addValue
+    QList<P2QuantileEstimator> quantiles; //optional quantiles (add estimators before the first value)
+    OnlineHistogram histogram; //optional histogram (set up before the first value)
 
     //maximum and minimum of the data series
     double maxValue;
@@ -113,11 +240,21 @@ public:
 
     UncertaintyData uncertaintyLength;
 
+    UncertaintyData *getUncertaintyData(const GeometryParameters &parameter);
+    const UncertaintyData *getUncertaintyData(const GeometryParameters &parameter) const;
+
     //###############################
     //correlations between parameters
     //###############################
 
     QMap<QString, double> correlations;
+    QMap<QPair<GeometryParameters, GeometryParameters>, OnlineCovariance> covariances; //online accumulators the correlations are derived from
+
+    void addSample(const QMap<GeometryParameters, double> &parameters);
+    void merge(const SimulationData &other);
+    void updateResults();
+
+    static QString getCorrelationKey(const GeometryParameters &x, const GeometryParameters &y);
 
 };
 
@@ -181,6 +318,8 @@ public:
     const QMap<QString, UncertaintyComponent> &getEnviromentUncertainties() const;
     const QMap<QString, UncertaintyComponent> &getHumanInfluence() const;
 
+    void setRandomSeed(const quint32 &seed);
+
     virtual bool distort(const QPointer<Reading> &r, const OiMat &objectRelation, const bool &newIterationStart);
     virtual bool analyseSimulationData(UncertaintyData &d);
     virtual double getCorrelationCoefficient(const QList<double> &x, const QList<double> &y);
@@ -214,6 +353,9 @@ protected:
     QMap<QString, UncertaintyComponent> environmentUncertainties;
     QMap<QString, UncertaintyComponent> humanInfluence;
 
+    //random number generator that shall be used in distort (seeded by the simulation runner)
+    std::mt19937 randomGenerator;
+
 };
 
 }
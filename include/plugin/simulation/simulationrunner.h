@@ -0,0 +1,125 @@
+#ifndef SIMULATIONRUNNER_H
+#define SIMULATIONRUNNER_H
+
+#include <functional>
+
+#include <QObject>
+#include <QPointer>
+#include <QList>
+#include <QMap>
+#include <QAtomicInt>
+
+#include "simulationmodel.h"
+
+namespace oi{
+
+/*!
+ * \brief SimulationModelFactory
+ * Creates a new simulation model instance (e.g. Plugin::createSimulation). Each worker thread uses its own model
+ */
+typedef std::function<QPointer<SimulationModel>()> SimulationModelFactory;
+
+/*!
+ * \brief SimulationEvaluator
+ * Recalculates the geometry from a set of distorted readings and returns its unknown parameters
+ */
+typedef std::function<bool(const QList<QPointer<Reading> > &readings, QMap<GeometryParameters, double> &parameters)> SimulationEvaluator;
+
+/*!
+ * \brief SimulationEvaluatorFactory
+ * Creates an evaluator for one worker thread. The evaluator may keep its own copies of the features and functions
+ * that are needed to recalculate the geometry, because it is only called from that one thread
+ */
+typedef std::function<SimulationEvaluator()> SimulationEvaluatorFactory;
+
+/*!
+ * \brief The SimulationRunner class
+ * Runs a Monte-Carlo simulation (distort -> recalc -> collect) in parallel worker threads.
+ * Every worker distorts its own copies of the readings with its own simulation model and seeded random generator.
+ * The results are aggregated with streaming statistics, so that the memory does not grow with the number of iterations.
+ */
+class OI_CORE_EXPORT SimulationRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SimulationRunner(QObject *parent = 0);
+
+    ~SimulationRunner();
+
+    //#######################
+    //set up a simulation run
+    //#######################
+
+    void setModelFactory(const SimulationModelFactory &factory);
+    void setEvaluatorFactory(const SimulationEvaluatorFactory &factory);
+
+    void setSimulationConfiguration(const SimulationConfiguration &sConfig);
+
+    void setReadings(const QList<QPointer<Reading> > &readings);
+    void setObjectRelation(const OiMat &objectRelation);
+
+    const int &getIterations() const;
+    void setIterations(const int &iterations);
+
+    const quint32 &getSeed() const;
+    void setSeed(const quint32 &seed);
+
+    const int &getNumberOfThreads() const;
+    void setNumberOfThreads(const int &numberOfThreads);
+
+    //#####################
+    //run or cancel the run
+    //#####################
+
+    bool run(SimulationData &result);
+    void cancel();
+
+    const int &getValidIterations() const;
+
+signals:
+
+    //####################################
+    //inform about the simulation progress
+    //####################################
+
+    void sendMessage(const QString &msg, const MessageTypes &msgType, const MessageDestinations &msgDest = eConsoleMessage);
+    void updateProgress(const int &progress, const QString &msg);
+
+private:
+
+    //##############
+    //helper methods
+    //##############
+
+    class WorkerResult;
+
+    WorkerResult runWorker(const int &workerIndex, const int &iterations);
+
+    //#################
+    //helper attributes
+    //#################
+
+    SimulationModelFactory modelFactory;
+    SimulationEvaluatorFactory evaluatorFactory;
+
+    SimulationConfiguration sConfig;
+
+    QList<QPointer<Reading> > readings; //snapshot of the original readings (owned by the runner)
+    OiMat objectRelation;
+
+    int iterations;
+    quint32 seed;
+    int numberOfThreads;
+
+    SimulationData workerTemplate; //initial simulation data of each worker
+
+    QAtomicInt isCanceled;
+    QAtomicInt finishedIterations;
+    int validIterations;
+
+};
+
+}
+
+#endif // SIMULATIONRUNNER_H
@@ -0,0 +1,97 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+
+#include <QJsonObject>
+
+#include "types.h"
+
+namespace oi{
+
+/*!
+ * \brief The Profiler class
+ * Opt-in instrumentation of hot paths. Scopes (OI_PROFILE_SCOPE) and counters (OI_PROFILE_COUNT) are recorded
+ * into a buffer of the calling thread without locking and aggregated when the profile is queried.
+ *
+ * The profiler is disabled by default: a scope then costs one relaxed atomic load.
+ * Define OI_NO_PROFILER to remove all scopes and counters at compile time.
+ * Names have to be string literals (only the pointer is recorded)
+ */
+class OI_CORE_EXPORT Profiler
+{
+public:
+
+    //####################################
+    //enable, disable or reset the profile
+    //####################################
+
+    static bool getIsEnabled(){
+        return Profiler::enabled.load(std::memory_order_relaxed);
+    }
+    static void setIsEnabled(const bool &isEnabled);
+
+    static void reset();
+
+    //#################
+    //query the profile
+    //#################
+
+    static QJsonObject getSummary();
+    static QJsonObject getChromeTrace();
+
+    //############################################
+    //record events (use the macros below instead)
+    //############################################
+
+    static qint64 getTime();
+
+    static void addScope(const char *name, const qint64 &start, const qint64 &duration);
+    static void addCount(const char *name, const qint64 &value);
+
+private:
+    static std::atomic<bool> enabled;
+
+};
+
+/*!
+ * \brief The ProfilerScope class
+ * Records the time between its construction and its destruction (if the profiler was enabled on construction)
+ */
+class ProfilerScope
+{
+public:
+    explicit ProfilerScope(const char *name) : name(name), start(-1){
+        if(Profiler::getIsEnabled()){
+            this->start = Profiler::getTime();
+        }
+    }
+
+    ~ProfilerScope(){
+        if(this->start >= 0){
+            Profiler::addScope(this->name, this->start, Profiler::getTime() - this->start);
+        }
+    }
+
+private:
+    ProfilerScope(const ProfilerScope &copy);
+    ProfilerScope &operator=(const ProfilerScope &copy);
+
+    const char *name;
+    qint64 start; //ns (-1 if disabled)
+
+};
+
+}
+
+#ifdef OI_NO_PROFILER
+#define OI_PROFILE_SCOPE(name)
+#define OI_PROFILE_COUNT(name, value)
+#else
+#define OI_PROFILE_CONCAT_HELPER(a, b) a##b
+#define OI_PROFILE_CONCAT(a, b) OI_PROFILE_CONCAT_HELPER(a, b)
+#define OI_PROFILE_SCOPE(name) oi::ProfilerScope OI_PROFILE_CONCAT(oiProfilerScope, __LINE__)(name)
+#define OI_PROFILE_COUNT(name, value) do{ if(oi::Profiler::getIsEnabled()){ oi::Profiler::addCount(name, value); } }while(0)
+#endif
+
+#endif // PROFILER_H
@@ -0,0 +1,95 @@
+#ifndef READINGSTORE_H
+#define READINGSTORE_H
+
+#include <QPointer>
+#include <QList>
+#include <QVector>
+#include <QHash>
+
+#include "types.h"
+
+namespace oi{
+
+class Reading;
+
+/*!
+ * \brief The ReadingStore class
+ * Stores all readings of a station in one append-only array of fixed size chunks (existing entries are never moved on append).
+ * Each entry is tagged with its reading type and each type keeps a list of the positions of its entries.
+ * Readings are removed in O(1) by marking their entry as removed, the array is compacted once more than half of it is removed.
+ * Readings that are deleted without being removed are dropped as soon as a count or an iteration finds them
+ */
+class OI_CORE_EXPORT ReadingStore{
+
+public:
+    ReadingStore();
+
+    //######################
+    //access stored readings
+    //######################
+
+    int getCount() const;
+    int getCount(const ReadingTypes &type) const;
+
+    bool contains(const QPointer<Reading> &reading) const;
+
+    QList<QPointer<Reading> > getReadings() const;
+    QList<QPointer<Reading> > getReadings(const ReadingTypes &type) const;
+
+    //######################
+    //add or remove readings
+    //######################
+
+    bool add(const QPointer<Reading> &reading);
+    bool remove(const QPointer<Reading> &reading);
+
+    void clear();
+
+private:
+
+    //##############
+    //helper methods
+    //##############
+
+    class Entry{
+    public:
+        Entry() : key(0), type(eUndefinedReading), isRemoved(true){}
+
+        QPointer<Reading> reading;
+        const Reading *key; //address of the reading (QPointer is reset when the reading is deleted)
+        ReadingTypes type;
+        bool isRemoved;
+    };
+
+    Entry &getEntry(const int &index);
+    const Entry &getEntry(const int &index) const;
+
+    void removeEntry(const int &index) const;
+    void dropDeletedReadings(const ReadingTypes &type) const;
+    void dropDeletedReadings() const;
+    void compactIfNeeded();
+    void compact();
+
+    //#################
+    //helper attributes
+    //#################
+
+    static const int chunkBits = 12; //4096 entries per chunk
+    static const int chunkSize = 1 << chunkBits;
+    static const int numReadingTypes = eCartesianReading6D + 1;
+
+    //(mutable, because the const methods drop the entries of deleted readings)
+    mutable QVector<QVector<Entry> > chunks;
+    int numEntries; //number of used entries (including removed ones)
+    mutable int numRemoved;
+
+    QVector<QVector<int> > typeIndices; //positions of the entries of each reading type
+    mutable QVector<int> typeCounts; //number of not removed entries of each reading type
+
+    mutable QHash<const Reading *, int> readingIndices; //position of the entry of each stored reading
+
+};
+
+}
+
+#endif // READINGSTORE_H
@@ -117,6 +117,13 @@ public slots:
     void startStatusMonitoringStream();
     void stopStatusMonitoringStream();
 
+    //watch window (processes the reading stream in the sensor worker thread)
+    void startWatchWindow();
+    void stopWatchWindow();
+    void setWatchWindowTransformation(const OiMat &trafo);
+    void setWatchWindowGeometry(const QPointer<FeatureWrapper> &feature);
+    void setWatchWindowDisplayRate(const int &displayRate);
+
     void finishMeasurement();
 signals:
 
@@ -127,6 +134,7 @@ signals:
     //real time data
     void realTimeReading(QVariantMap reading);
     void realTimeStatus(QMap<QString, QString> status);
+    void watchWindowReading(QVariantMap reading);
 
     //connection information
     void connectionLost();
@@ -9,6 +9,7 @@
 
 #include "sensor.h"
 #include "sensorworkermessage.h"
+#include "watchwindowengine.h"
 
 namespace oi{
 
@@ -25,6 +26,9 @@ public:
 
     ~SensorWorker();
 
+    //watch window engine (processes the reading stream in the thread of the worker)
+    const QPointer<WatchWindowEngine> &getWatchWindow() const;
+
 signals:
 
     //##############################
@@ -34,6 +38,7 @@ signals:
     //real time data
     void realTimeReading(QVariantMap reading);
     void realTimeStatus(QMap<QString, QString> status);
+    void watchWindowReading(QVariantMap reading);
 
     //connection information
     void connectionLost();
@@ -165,6 +170,9 @@ private:
     //reading stream format
     ReadingTypes streamFormat;
 
+    //watch window
+    QPointer<WatchWindowEngine> watchWindow;
+
     //stream states
     bool isReadingStreamStarted;
     bool isConnectionStreamStarted;
@@ -6,6 +6,7 @@
 #include <QPointer>
 
 #include "sensorcontrol.h"
+#include "readingstore.h"
 #include "feature.h"
 #include "point.h"
 
@@ -74,6 +75,9 @@ public:
     //get geometries measured from this station
     QList<QPointer<Geometry> > getTargetGeometries() const;
 
+    //get readings made by this station (by type)
+    const ReadingStore &getReadings() const;
+
     //####################################################
     //get information about the currently connected sensor
     //####################################################
@@ -176,6 +180,13 @@ signals:
     void startStatusMonitoringStream();
     void stopStatusMonitoringStream();
 
+    //watch window
+    void startWatchWindow();
+    void stopWatchWindow();
+    void setWatchWindowTransformation(const OiMat &trafo);
+    void setWatchWindowGeometry(const QPointer<FeatureWrapper> &feature);
+    void setWatchWindowDisplayRate(const int &displayRate);
+
     //##############################
     //inform about streaming results
     //##############################
@@ -183,6 +194,7 @@ signals:
     //real time data
     void realTimeReading(QVariantMap reading);
     void realTimeStatus(QMap<QString, QString> status);
+    void watchWindowReading(QVariantMap reading);
 
     //connection information
     void connectionLost();
@@ -240,13 +252,22 @@ private:
     //readings made by this station
     //#############################
 
-    QList<QPointer<Reading> > cartesianReadings;
-    QList<QPointer<Reading> > directionReadings;
-    QList<QPointer<Reading> > distanceReadings;
-    QList<QPointer<Reading> > polarReadings;
-    QList<QPointer<Reading> > levelReadings;
-    QList<QPointer<Reading> > temperatureRadings;
-    QList<QPointer<Reading> > undefinedReadings;
+    ReadingStore readings; //all readings tagged with their type
+
+    //###################################################
+    //target geometries of the observations (Observation)
+    //###################################################
+
+    class TargetGeometry{
+    public:
+        QPointer<Geometry> geometry;
+        int numObservations;
+    };
+
+    QMap<int, TargetGeometry> targetGeometries; //target geometries of all observations of this station with their id as key
+
+    void addTargetGeometry(const QPointer<Geometry> &geometry);
+    void removeTargetGeometry(const int &geometryId);
 
 private slots:
 
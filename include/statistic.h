@@ -2,6 +2,7 @@
 #define STATISTIC_H
 
 #include <QList>
+#include <QSharedDataPointer>
 
 #include "oivec.h"
 #include "oimat.h"
@@ -23,8 +24,13 @@ public:
     DimensionType dimension; //dimension of the correction values
 };
 
+class StatisticData;
+
 /*!
  * \brief The Statistic class
+ * The matrices and the residual vector are shared between copies (copy-on-write), so that copying a statistic
+ * (e.g. from a function to its geometry) does not copy them. A diagonal weight matrix is only stored as its diagonal,
+ * the full matrix is created when it is requested by getP
  */
 class OI_CORE_EXPORT Statistic
 {
@@ -33,6 +39,8 @@ public:
     Statistic();
     Statistic(const Statistic &copy);
 
+    ~Statistic();
+
     Statistic& operator=(const Statistic &other);
 
     //###################################
@@ -60,8 +68,13 @@ public:
     const OiMat &getP() const;
     void setP(const OiMat &p);
 
+    bool getIsPDiagonal() const;
+    OiVec getPDiagonal() const;
+    void setPDiagonal(const OiVec &p);
+
     const OiMat &getQxx() const;
     void setQxx(const OiMat &qxx);
+    OiVec getQxxDiagonal() const;
 
     const OiVec &getV() const;
     void setV(const OiVec &v);
@@ -73,6 +86,12 @@ public:
     void setFormError(const double &formError);
     const double &getFormError() const;
 
+    //################################
+    //get the approximate memory usage
+    //################################
+
+    qint64 getMemoryUsage() const;
+
 private:
     bool isValid;
 
@@ -85,10 +104,8 @@ private:
 
     double stdev; //standard deviation of vertical distances from geometry surface
 
-    OiMat p;
-    OiMat qxx;
+    QSharedDataPointer<StatisticData> d; //p, qxx and v (shared between copies)
 
-    OiVec v; //vertical distances from geometry surface
     QMap<int, Residual> displayResidualsMap; //map of display residuals (key: element id that the residual belongs to)
 
     double formError;
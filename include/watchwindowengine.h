@@ -0,0 +1,100 @@
+#ifndef WATCHWINDOWENGINE_H
+#define WATCHWINDOWENGINE_H
+
+#include <QObject>
+#include <QPointer>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QVariantMap>
+
+#include "types.h"
+#include "oimat.h"
+
+namespace oi{
+
+class FeatureWrapper;
+class Geometry;
+
+/*!
+ * \brief The WatchWindowEngine class
+ * Processes the real time readings of a sensor in the thread of the sensor worker:
+ * each sample is transformed into the active coordinate system with a cached transformation matrix,
+ * its deviation from the active geometry is computed and the results are published at display rate.
+ *
+ * The setters may be called from any thread. setGeometry has to be called in the thread of the feature,
+ * because the engine works on a private copy of the geometry that is not changed by a recalculation
+ */
+class OI_CORE_EXPORT WatchWindowEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit WatchWindowEngine(QObject *parent = 0);
+
+    ~WatchWindowEngine();
+
+    //#######################################
+    //set up the engine (thread safe setters)
+    //#######################################
+
+    bool getIsStarted();
+    void start();
+    void stop();
+
+    bool setTransformation(const OiMat &trafo);
+    void setGeometry(const QPointer<FeatureWrapper> &feature);
+
+    int getDisplayRate();
+    void setDisplayRate(const int &displayRate);
+
+public slots:
+
+    //#####################################################
+    //process a stream sample (thread of the sensor worker)
+    //#####################################################
+
+    void addReading(const QVariantMap &reading);
+
+signals:
+
+    //########################################
+    //inform about decimated watch window data
+    //########################################
+
+    void watchWindowReading(const QVariantMap &reading);
+
+private:
+
+    //##############
+    //helper methods
+    //##############
+
+    bool getPosition(const QVariantMap &reading, double *xyz) const;
+
+    static Geometry *copyGeometry(const QPointer<FeatureWrapper> &feature);
+
+    //#################
+    //helper attributes
+    //#################
+
+    QMutex mutex;
+
+    bool isStarted;
+
+    //cached transformation from the station system into the active system (rows of the 3x4 part of the homogeneous matrix)
+    double trafo[12];
+
+    //private copy of the active geometry (0 if no geometry is set)
+    Geometry *geometry;
+    int geometryId;
+
+    //decimation
+    int displayRate; //published readings per second
+    QElapsedTimer publishTimer;
+    int numSamples; //stream samples since the last published reading
+
+};
+
+}
+
+#endif // WATCHWINDOWENGINE_H
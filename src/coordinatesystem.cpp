@@ -6,6 +6,7 @@
 #include "trafoparam.h"
 #include "oijob.h"
 #include "bundleadjustment.h"
+#include "profiler.h"
 
 using namespace oi;
 using namespace oi::math;
@@ -300,6 +301,11 @@ bool CoordinateSystem::addObservation(const QPointer<Observation> &observation){
         this->observationsList.append(observation);
         this->observationsMap.insert(observation->getId(), observation);
 
+        //update the memory usage of the job
+        if(!this->job.isNull()){
+            this->job->addObservationMemoryUsage(1);
+        }
+
         emit this->observationsChanged(this->id, observation->getId());
 
         return true;
@@ -583,6 +589,8 @@ void CoordinateSystem::recalc(){
  */
 QDomElement CoordinateSystem::toOpenIndyXML(QDomDocument &xmlDoc){
 
+    OI_PROFILE_SCOPE("CoordinateSystem::toOpenIndyXML");
+
     QDomElement coordinateSystem = Feature::toOpenIndyXML(xmlDoc);
 
     if(coordinateSystem.isNull()){
@@ -709,6 +717,8 @@ QDomElement CoordinateSystem::toOpenIndyXML(QDomDocument &xmlDoc){
  */
 bool CoordinateSystem::fromOpenIndyXML(QDomElement &xmlElem){
 
+    OI_PROFILE_SCOPE("CoordinateSystem::fromOpenIndyXML");
+
     bool result = Feature::fromOpenIndyXML(xmlElem);
 
     if(result){
@@ -1032,7 +1042,10 @@ void CoordinateSystem::removeObservation(const QPointer<Observation> &obs){
         return;
     }
 
-    this->observationsList.removeOne(obs);
+    //update the memory usage of the job
+    if(this->observationsList.removeOne(obs) && !this->job.isNull()){
+        this->job->addObservationMemoryUsage(-1);
+    }
     this->observationsMap.remove(obs->getId());
 
 }
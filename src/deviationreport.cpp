@@ -0,0 +1,406 @@
+#include "deviationreport.h"
+
+#include <limits>
+#include <functional>
+
+#include <QtConcurrent>
+#include <QThread>
+#include <QSet>
+
+#include "featurewrapper.h"
+#include "util.h"
+
+using namespace oi;
+
+/*!
+ * \brief DeviationTable::DeviationTable
+ */
+DeviationTable::DeviationTable(){
+
+}
+
+/*!
+ * \brief DeviationTable::getRowCount
+ * \return
+ */
+int DeviationTable::getRowCount() const{
+    return this->actualIds.size();
+}
+
+/*!
+ * \brief DeviationTable::getColumnIndex
+ * Returns the column of the given parameter or -1 if the table does not contain it
+ * \param parameter
+ * \return
+ */
+int DeviationTable::getColumnIndex(const GeometryParameters &parameter) const{
+    return this->parameters.indexOf(parameter);
+}
+
+/*!
+ * \brief DeviationTable::clear
+ */
+void DeviationTable::clear(){
+    this->actualIds.clear();
+    this->nominalIds.clear();
+    this->names.clear();
+    this->types.clear();
+    this->parameters.clear();
+    this->actuals.clear();
+    this->nominals.clear();
+    this->deviations.clear();
+}
+
+/*!
+ * \brief DeviationReport::DeviationReport
+ * \param parent
+ */
+DeviationReport::DeviationReport(QObject *parent) : QObject(parent), chunkSize(256), isCanceled(0){
+
+}
+
+/*!
+ * \brief DeviationReport::~DeviationReport
+ */
+DeviationReport::~DeviationReport(){
+
+}
+
+/*!
+ * \brief DeviationReport::setFeatures
+ * Collects all pairs of an actual geometry and each of its nominals
+ * \param features
+ */
+void DeviationReport::setFeatures(const QList<QPointer<FeatureWrapper> > &features){
+
+    this->pairs.clear();
+
+    foreach(const QPointer<FeatureWrapper> &feature, features){
+
+        //only actual geometries
+        if(feature.isNull() || feature->getGeometry().isNull() || feature->getGeometry()->getIsNominal()){
+            continue;
+        }
+
+        foreach(const QPointer<Geometry> &nominal, feature->getGeometry()->getNominals()){
+            if(nominal.isNull() || nominal->getFeatureWrapper().isNull()){
+                continue;
+            }
+            Pair pair;
+            pair.actual = feature;
+            pair.nominal = nominal->getFeatureWrapper();
+            this->pairs.append(pair);
+        }
+
+    }
+
+}
+
+/*!
+ * \brief DeviationReport::getParameters
+ * \return
+ */
+const QList<GeometryParameters> &DeviationReport::getParameters() const{
+    return this->parameters;
+}
+
+/*!
+ * \brief DeviationReport::setParameters
+ * Set the columns of the report. If no parameters are set, all parameters of the geometry types of the pairs are used
+ * \param parameters
+ */
+void DeviationReport::setParameters(const QList<GeometryParameters> &parameters){
+    this->parameters = parameters;
+}
+
+/*!
+ * \brief DeviationReport::getChunkSize
+ * \return
+ */
+const int &DeviationReport::getChunkSize() const{
+    return this->chunkSize;
+}
+
+/*!
+ * \brief DeviationReport::setChunkSize
+ * \param chunkSize
+ */
+void DeviationReport::setChunkSize(const int &chunkSize){
+    if(chunkSize > 0){
+        this->chunkSize = chunkSize;
+    }
+}
+
+/*!
+ * \brief DeviationReport::getNumberOfPairs
+ * \return
+ */
+int DeviationReport::getNumberOfPairs() const{
+    return this->pairs.size();
+}
+
+/*!
+ * \brief DeviationReport::run
+ * Computes the table for all pairs. Row attributes are set up in the calling thread,
+ * the parameter values and deviations are computed in parallel chunks.
+ * The method blocks until all chunks have finished
+ * \param table
+ * \return
+ */
+bool DeviationReport::run(DeviationTable &table){
+
+    this->isCanceled.store(0);
+    table.clear();
+
+    //set up columns
+    if(!this->parameters.isEmpty()){
+        table.parameters = this->parameters;
+    }else{
+        QSet<GeometryTypes> types;
+        foreach(const Pair &pair, this->pairs){
+            if(!pair.actual.isNull()){
+                types.insert(getGeometryTypeEnum(pair.actual->getFeatureTypeEnum()));
+            }
+        }
+        foreach(const GeometryParameters &parameter, getAvailableGeometryParameters()){
+            foreach(const GeometryTypes &type, types){
+                if(getGeometryParameters(type).contains(parameter)){
+                    table.parameters.append(parameter);
+                    break;
+                }
+            }
+        }
+    }
+
+    //set up rows
+    int numRows = this->pairs.size();
+    int numColumns = table.parameters.size();
+    table.actualIds.resize(numRows);
+    table.nominalIds.resize(numRows);
+    table.types.resize(numRows);
+    table.names.reserve(numRows);
+    for(int i = 0; i < numRows; i++){
+        const Pair &pair = this->pairs.at(i);
+        bool isValid = !pair.actual.isNull() && !pair.nominal.isNull();
+        table.actualIds[i] = isValid ? pair.actual->getFeature()->getId() : -1;
+        table.nominalIds[i] = isValid ? pair.nominal->getFeature()->getId() : -1;
+        table.types[i] = isValid ? getGeometryTypeEnum(pair.actual->getFeatureTypeEnum()) : eUndefinedGeometry;
+        table.names.append(isValid ? pair.actual->getFeature()->getFeatureName() : QString());
+    }
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    table.actuals.fill(QVector<double>(numRows, nan), numColumns);
+    table.nominals.fill(QVector<double>(numRows, nan), numColumns);
+    table.deviations.fill(QVector<double>(numRows, nan), numColumns);
+
+    //detach all columns before they are written by the worker threads
+    ColumnPointers columns;
+    for(int j = 0; j < numColumns; j++){
+        columns.actuals.append(table.actuals[j].data());
+        columns.nominals.append(table.nominals[j].data());
+        columns.deviations.append(table.deviations[j].data());
+    }
+    const QList<GeometryParameters> &parameters = table.parameters;
+
+    //compute chunks in parallel
+    QVector<int> chunks;
+    for(int i = 0; i * this->chunkSize < numRows; i++){
+        chunks.append(i);
+    }
+    std::function<void(int &)> computeChunk = [this, &parameters, &columns](int &chunk){
+        this->computeChunk(chunk, parameters, columns);
+    };
+    QtConcurrent::blockingMap(chunks, computeChunk);
+
+    if(this->isCanceled.load() != 0){
+        emit this->sendMessage("Deviation report canceled by user", eWarningMessage, eConsoleMessage);
+        return false;
+    }
+
+    emit this->updateProgress(100, QString("Deviations of %1 actual/nominal pairs computed").arg(numRows));
+
+    return true;
+
+}
+
+/*!
+ * \brief DeviationReport::cancel
+ * Can be called from any thread
+ */
+void DeviationReport::cancel(){
+    this->isCanceled.store(1);
+}
+
+/*!
+ * \brief DeviationReport::getParameterValue
+ * Returns the numeric value of a geometry parameter in default units.
+ * Returns false if the feature is not solved or the parameter is not defined for its type
+ * \param feature
+ * \param parameter
+ * \param value
+ * \return
+ */
+bool DeviationReport::getParameterValue(const QPointer<FeatureWrapper> &feature, const GeometryParameters &parameter, double &value){
+
+    if(feature.isNull() || feature->getGeometry().isNull()){
+        return false;
+    }
+
+    const QPointer<Geometry> &geometry = feature->getGeometry();
+    if(!geometry->getIsSolved()){
+        return false;
+    }
+
+    switch(parameter){
+    case eUnknownX:
+    case eUnknownY:
+    case eUnknownZ:
+        if(!geometry->hasPosition()){
+            return false;
+        }
+        value = geometry->getPosition().getVector().getAt(parameter - eUnknownX);
+        return true;
+    case eUnknownPrimaryI:
+    case eUnknownPrimaryJ:
+    case eUnknownPrimaryK:
+        if(!geometry->hasDirection()){
+            return false;
+        }
+        value = geometry->getDirection().getVector().getAt(parameter - eUnknownPrimaryI);
+        return true;
+    case eUnknownSecondaryI:
+    case eUnknownSecondaryJ:
+    case eUnknownSecondaryK:
+        if(!feature->getEllipse().isNull()){
+            value = feature->getEllipse()->getSemiMajorAxisDirection().getVector().getAt(parameter - eUnknownSecondaryI);
+            return true;
+        }else if(!feature->getSlottedHole().isNull()){
+            value = feature->getSlottedHole()->getHoleAxis().getVector().getAt(parameter - eUnknownSecondaryI);
+            return true;
+        }
+        return false;
+    case eUnknownRadiusA:
+        if(!geometry->hasRadius()){
+            return false;
+        }
+        value = geometry->getRadius().getRadius();
+        return true;
+    case eUnknownRadiusB:
+        if(!feature->getTorus().isNull()){
+            value = feature->getTorus()->getSmallRadius().getRadius();
+            return true;
+        }
+        return false;
+    case eUnknownAperture:
+        if(!feature->getCone().isNull()){
+            value = feature->getCone()->getAperture();
+            return true;
+        }
+        return false;
+    case eUnknownA:
+        if(!feature->getEllipse().isNull()){
+            value = feature->getEllipse()->getA();
+            return true;
+        }else if(!feature->getEllipsoid().isNull()){
+            value = feature->getEllipsoid()->getA();
+            return true;
+        }else if(!feature->getHyperboloid().isNull()){
+            value = feature->getHyperboloid()->getA();
+            return true;
+        }else if(!feature->getParaboloid().isNull()){
+            value = feature->getParaboloid()->getA();
+            return true;
+        }
+        return false;
+    case eUnknownB:
+        if(!feature->getEllipse().isNull()){
+            value = feature->getEllipse()->getB();
+            return true;
+        }else if(!feature->getEllipsoid().isNull()){
+            value = feature->getEllipsoid()->getB();
+            return true;
+        }
+        return false;
+    case eUnknownC:
+        if(!feature->getHyperboloid().isNull()){
+            value = feature->getHyperboloid()->getC();
+            return true;
+        }
+        return false;
+    case eUnknownAngle:
+        if(!feature->getScalarEntityAngle().isNull()){
+            value = feature->getScalarEntityAngle()->getAngle();
+            return true;
+        }
+        return false;
+    case eUnknownDistance:
+        if(!feature->getScalarEntityDistance().isNull()){
+            value = feature->getScalarEntityDistance()->getDistance();
+            return true;
+        }
+        return false;
+    case eUnknownMeasurementSeries:
+        if(!feature->getScalarEntityMeasurementSeries().isNull()){
+            value = feature->getScalarEntityMeasurementSeries()->getSeriesValue();
+            return true;
+        }
+        return false;
+    case eUnknownTemperature:
+        if(!feature->getScalarEntityTemperature().isNull()){
+            value = feature->getScalarEntityTemperature()->getTemperature();
+            return true;
+        }
+        return false;
+    case eUnknownLength:
+        if(!feature->getSlottedHole().isNull()){
+            value = feature->getSlottedHole()->getLength();
+            return true;
+        }
+        return false;
+    }
+
+    return false;
+
+}
+
+/*!
+ * \brief DeviationReport::computeChunk
+ * Executed in a worker thread: writes the values of the rows of one chunk (each row is written by exactly one task)
+ * \param chunk
+ * \param parameters
+ * \param columns
+ */
+void DeviationReport::computeChunk(const int &chunk, const QList<GeometryParameters> &parameters, const ColumnPointers &columns) const{
+
+    if(this->isCanceled.load() != 0){
+        return;
+    }
+
+    int begin = chunk * this->chunkSize;
+    int end = qMin(begin + this->chunkSize, this->pairs.size());
+
+    for(int j = 0; j < parameters.size(); j++){
+
+        const GeometryParameters parameter = parameters.at(j);
+        double *actuals = columns.actuals.at(j);
+        double *nominals = columns.nominals.at(j);
+        double *deviations = columns.deviations.at(j);
+
+        for(int i = begin; i < end; i++){
+            const Pair &pair = this->pairs.at(i);
+            double actual = 0.0, nominal = 0.0;
+            bool hasActual = DeviationReport::getParameterValue(pair.actual, parameter, actual);
+            bool hasNominal = DeviationReport::getParameterValue(pair.nominal, parameter, nominal);
+            if(hasActual){
+                actuals[i] = actual;
+            }
+            if(hasNominal){
+                nominals[i] = nominal;
+            }
+            if(hasActual && hasNominal){
+                deviations[i] = actual - nominal;
+            }
+        }
+
+    }
+
+}
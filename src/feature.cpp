@@ -1,8 +1,11 @@
 #include "feature.h"
 
+#include <QElapsedTimer>
+
 #include "oijob.h"
 #include "function.h"
 #include "featurewrapper.h"
+#include "profiler.h"
 
 using namespace oi;
 
@@ -262,6 +265,7 @@ void Feature::addFunction(const QPointer<Function> &function){
         //let the current job generate a unique id if it is valid
         if(!this->job.isNull()){
             function->id = this->job->generateUniqueId();
+            function->setJob(this->job);
         }
 
         this->functionList.append(function);
@@ -277,6 +281,9 @@ void Feature::addFunction(const QPointer<Function> &function){
  */
 void Feature::removeFunction(const int &index){
     if(this->functionList.size() > index && index >= 0){
+        if(!this->functionList.at(index).isNull()){
+            this->functionList.at(index)->setJob(QPointer<OiJob>());
+        }
         this->functionList.removeAt(index);
         this->isUpdated = false;
         emit this->featureFunctionListChanged(this->id);
@@ -475,12 +482,16 @@ bool Feature::removePreviouslyNeeded(const QPointer<FeatureWrapper> &feature){
  */
 void Feature::recalc(){
 
+    OI_PROFILE_SCOPE("Feature::recalc");
+
     this->isSolved = false;
 
     try {
         //execute all functions in the specified order
         foreach(const QPointer<Function> &function, this->functionList){
 
+            OI_PROFILE_SCOPE("Function::exec");
+
             //break if the function pointer is not valid
             if(function.isNull()){
                 this->isSolved = false;
@@ -488,7 +499,11 @@ void Feature::recalc(){
             }
 
             //try to solve the current function
+            QElapsedTimer timer;
+            function->startExecution();
+            timer.start();
             this->isSolved = function->exec(this->selfFeature);
+            function->finishExecution(timer.nsecsElapsed(), this->isSolved);
             if(!this->isSolved){
                 break;
             }
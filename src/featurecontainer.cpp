@@ -129,23 +129,69 @@ QPointer<FeatureWrapper> FeatureContainer::getFeatureById(const int &featureId)
 /*!
  * \brief FeatureContainer::getFeaturesByName
  * \param name
- * \param startWith use name as "start with" pattern
+ * \param startWith use name as "start with" pattern (case insensitive, sorted by name)
  * \return
  */
 QList<QPointer<FeatureWrapper> > FeatureContainer::getFeaturesByName(const QString &name, const bool startWith) const{
     if(startWith) {
-        QList<QPointer<FeatureWrapper> > result;
-        foreach(const QPointer<FeatureWrapper> &feature, this->featuresList){
-            if(!feature.isNull() && !feature->getFeature().isNull() && feature->getFeature()->getFeatureName().startsWith(name, Qt::CaseInsensitive)){
-                result.append(feature);
-            }
-        }
-        return result;
+        return this->getFeaturesByNamePrefix(name);
     } else {
         return this->featuresNameMap.values(name);
     }
 }
 
+/*!
+ * \brief FeatureContainer::getFeaturesByNamePrefix
+ * Returns the features whose name starts with the given prefix (case insensitive) sorted by name.
+ * The index is searched in O(log n), so that the cost only depends on the number of returned (and skipped) features
+ * \param prefix
+ * \param offset number of matching features that are skipped
+ * \param limit maximum number of returned features (-1: all)
+ * \return
+ */
+QList<QPointer<FeatureWrapper> > FeatureContainer::getFeaturesByNamePrefix(const QString &prefix, const int &offset, const int &limit) const{
+
+    QList<QPointer<FeatureWrapper> > result;
+    if(limit == 0){
+        return result;
+    }
+
+    QString foldedPrefix = prefix.toCaseFolded();
+    int index = 0;
+    QMultiMap<QString, QPointer<FeatureWrapper> >::const_iterator it = this->featuresFoldedNameMap.lowerBound(foldedPrefix);
+    for(; it != this->featuresFoldedNameMap.constEnd() && it.key().startsWith(foldedPrefix); ++it, ++index){
+        if(index < offset){
+            continue;
+        }
+        result.append(it.value());
+        if(limit > 0 && result.size() == limit){
+            break;
+        }
+    }
+
+    return result;
+
+}
+
+/*!
+ * \brief FeatureContainer::getFeatureCountByNamePrefix
+ * Returns the number of features whose name starts with the given prefix (case insensitive)
+ * \param prefix
+ * \return
+ */
+int FeatureContainer::getFeatureCountByNamePrefix(const QString &prefix) const{
+
+    QString foldedPrefix = prefix.toCaseFolded();
+    int count = 0;
+    QMultiMap<QString, QPointer<FeatureWrapper> >::const_iterator it = this->featuresFoldedNameMap.lowerBound(foldedPrefix);
+    for(; it != this->featuresFoldedNameMap.constEnd() && it.key().startsWith(foldedPrefix); ++it){
+        count++;
+    }
+
+    return count;
+
+}
+
 /*!
  * \brief FeatureContainer::getFeaturesByGroup
  * \param group
@@ -228,6 +274,7 @@ bool FeatureContainer::addFeature(const QPointer<FeatureWrapper> &feature){
     this->featuresList.append(feature);
     this->featuresIdMap.insert(feature->getFeature()->getId(), feature);
     this->featuresNameMap.insert(feature->getFeature()->getFeatureName(), feature);
+    this->featuresFoldedNameMap.insert(feature->getFeature()->getFeatureName().toCaseFolded(), feature);
     this->featuresTypeMap.insert(feature->getFeatureTypeEnum(), feature);
     if(feature->getFeature()->getGroupName().compare("") != 0){
         this->featuresGroupMap.insert(feature->getFeature()->getGroupName(), feature);
@@ -299,6 +346,7 @@ bool FeatureContainer::removeFeature(const int &featureId){
     this->featuresList.removeOne(feature);
     this->featuresIdMap.remove(featureId);
     this->featuresNameMap.remove(feature->getFeature()->getFeatureName(), feature);
+    this->featuresFoldedNameMap.remove(feature->getFeature()->getFeatureName().toCaseFolded(), feature);
     this->featuresTypeMap.remove(feature->getFeatureTypeEnum(), feature);
     if(feature->getFeature()->getGroupName().compare("") != 0){
         this->featuresGroupMap.remove(feature->getFeature()->getGroupName(), feature);
@@ -391,6 +439,7 @@ void FeatureContainer::checkAndClean(const int &featureId, const QString &name,
     //clean feature maps
     this->featuresIdMap.remove(featureId);
     this->featuresNameMap.remove(name, feature);
+    this->featuresFoldedNameMap.remove(name.toCaseFolded(), feature);
     this->featuresGroupMap.remove(group, feature);
     this->featuresTypeMap.remove(type, feature);
     if(!feature->getGeometry().isNull()){
@@ -437,6 +486,7 @@ void FeatureContainer::removeAll(){
     this->geometriesList.clear();
     this->featuresIdMap.clear();
     this->featuresNameMap.clear();
+    this->featuresFoldedNameMap.clear();
     this->featuresGroupMap.clear();
     this->featuresTypeMap.clear();
     this->geometriesMConfigMap.clear();
@@ -469,9 +519,12 @@ bool FeatureContainer::featureNameChanged(const int &featureId, const QString &o
         return false;
     }
 
-    //update lists and maps
-    if(this->featuresNameMap.contains(oldName)){
-        this->featuresNameMap.insert(feature->getFeature()->getFeatureName(), this->featuresNameMap.take(oldName));
+    //update lists and maps (only the entries of this feature are moved)
+    if(this->featuresNameMap.remove(oldName, feature) > 0){
+        this->featuresNameMap.insert(feature->getFeature()->getFeatureName(), feature);
+    }
+    if(this->featuresFoldedNameMap.remove(oldName.toCaseFolded(), feature) > 0){
+        this->featuresFoldedNameMap.insert(feature->getFeature()->getFeatureName().toCaseFolded(), feature);
     }
     if(!this->featuresNameMap.contains(oldName)){
         this->featureNames.removeOne(oldName);
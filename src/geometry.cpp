@@ -77,6 +77,11 @@ Geometry &Geometry::operator=(const Geometry &copy){
  */
 Geometry::~Geometry(){
 
+    //release the statistic from the memory usage of the job
+    if(!this->job.isNull()){
+        this->job->addStatisticMemoryUsage(-this->statistic.getMemoryUsage());
+    }
+
     if(this->isNominal){
 
         //delete this geometry from the nominal list of its actual
@@ -377,7 +382,15 @@ const Statistic &Geometry::getStatistic() const{
  * \param myStatistic
  */
 void Geometry::setStatistic(const Statistic &myStatistic){
+
+    qint64 previousBytes = this->statistic.getMemoryUsage();
     this->statistic = myStatistic;
+
+    //update the memory usage of the job
+    if(!this->job.isNull()){
+        this->job->addStatisticMemoryUsage(this->statistic.getMemoryUsage() - previousBytes);
+    }
+
 }
 
 /*!
@@ -480,6 +493,46 @@ void Geometry::setUnknownParameters(const QMap<GeometryParameters, double> &para
     return;
 }
 
+/*!
+ * \brief Geometry::computeDeviations
+ * Computes the deviations of many points from this geometry in one call.
+ * points contains x, y, z of each point (numPoints * 3 values), deviations receives one distance per point
+ * and footPoints (optional) the nearest point on the geometry for each point (numPoints * 3 values).
+ * Geometry types that support this reimplement the method, the default implementation returns false
+ * \param points
+ * \param numPoints
+ * \param deviations
+ * \param footPoints
+ * \return
+ */
+bool Geometry::computeDeviations(const double *points, const int &numPoints, double *deviations, double *footPoints) const{
+    Q_UNUSED(points);
+    Q_UNUSED(numPoints);
+    Q_UNUSED(deviations);
+    Q_UNUSED(footPoints);
+    return false;
+}
+
+/*!
+ * \brief Geometry::getDeviations
+ * Convenience version of computeDeviations for QVector buffers (resized as needed)
+ * \param points
+ * \param deviations
+ * \param footPoints
+ * \return
+ */
+bool Geometry::getDeviations(const QVector<double> &points, QVector<double> &deviations, QVector<double> *footPoints) const{
+
+    int numPoints = points.size() / 3;
+    deviations.resize(numPoints);
+    if(footPoints != 0){
+        footPoints->resize(numPoints * 3);
+    }
+
+    return this->computeDeviations(points.constData(), numPoints, deviations.data(), footPoints != 0 ? footPoints->data() : 0);
+
+}
+
 /*!
  * \brief Geometry::recalc
  */
@@ -494,7 +547,11 @@ void Geometry::recalc(){
 
     //reset statistic if not solved
     if(!this->isSolved){
+        qint64 previousBytes = this->statistic.getMemoryUsage();
         this->statistic.reset();
+        if(!this->job.isNull() && previousBytes != 0){
+            this->job->addStatisticMemoryUsage(-previousBytes);
+        }
     }
 
 }
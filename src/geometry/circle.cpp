@@ -1,6 +1,7 @@
 #include "circle.h"
 
 #include "featurewrapper.h"
+#include "profiler.h"
 
 using namespace oi;
 using namespace oi::math;
@@ -192,6 +193,50 @@ void Circle::setUnknownParameters(const QMap<GeometryParameters, double> &parame
 
 }
 
+/*!
+ * \brief Circle::computeDeviations
+ * Distances to the circle line and foot points of many points (x, y, z each).
+ * The sign of a distance is the sign of the radial deviation (positive outside)
+ * \param points
+ * \param numPoints
+ * \param deviations
+ * \param footPoints
+ * \return
+ */
+bool Circle::computeDeviations(const double *points, const int &numPoints, double *deviations, double *footPoints) const{
+
+    if(!this->isSolved || points == 0 || deviations == 0 || numPoints < 0){
+        return false;
+    }
+
+    const double cx = this->xyz.getVector().getAt(0), cy = this->xyz.getVector().getAt(1), cz = this->xyz.getVector().getAt(2);
+    const double nx = this->ijk.getVector().getAt(0), ny = this->ijk.getVector().getAt(1), nz = this->ijk.getVector().getAt(2);
+    const double r = this->radius.getRadius();
+
+    for(int i = 0; i < numPoints; i++){
+
+        //split into normal and in-plane part
+        double wx = points[3*i] - cx, wy = points[3*i+1] - cy, wz = points[3*i+2] - cz;
+        double h = wx * nx + wy * ny + wz * nz;
+        double qx = wx - h * nx, qy = wy - h * ny, qz = wz - h * nz;
+        double length = qSqrt(qx * qx + qy * qy + qz * qz);
+        double radial = length - r;
+        double distance = qSqrt(radial * radial + h * h);
+        deviations[i] = radial < 0.0 ? -distance : distance;
+
+        if(footPoints != 0){
+            double scale = length > 0.0 ? r / length : 0.0;
+            footPoints[3*i] = cx + scale * qx;
+            footPoints[3*i+1] = cy + scale * qy;
+            footPoints[3*i+2] = cz + scale * qz;
+        }
+
+    }
+
+    return true;
+
+}
+
 /*!
  * \brief Circle::recalc
  */
@@ -215,6 +260,8 @@ void Circle::recalc(){
  */
 QDomElement Circle::toOpenIndyXML(QDomDocument &xmlDoc) const{
 
+    OI_PROFILE_SCOPE("Circle::toOpenIndyXML");
+
     QDomElement circle = Geometry::toOpenIndyXML(xmlDoc);
 
     if(circle.isNull()){
@@ -234,6 +281,8 @@ QDomElement Circle::toOpenIndyXML(QDomDocument &xmlDoc) const{
  */
 bool Circle::fromOpenIndyXML(QDomElement &xmlElem){
 
+    OI_PROFILE_SCOPE("Circle::fromOpenIndyXML");
+
     bool result = Geometry::fromOpenIndyXML(xmlElem);
 
     if(result){
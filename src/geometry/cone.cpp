@@ -1,6 +1,7 @@
 #include "cone.h"
 
 #include "featurewrapper.h"
+#include "profiler.h"
 
 using namespace oi;
 using namespace oi::math;
@@ -194,6 +195,58 @@ void Cone::setUnknownParameters(const QMap<GeometryParameters, double> &paramete
 
 }
 
+/*!
+ * \brief Cone::computeDeviations
+ * Signed distances (positive outside) and foot points of many points (x, y, z each).
+ * The axis points from the apex into the cone, points behind the apex are projected onto the apex
+ * \param points
+ * \param numPoints
+ * \param deviations
+ * \param footPoints
+ * \return
+ */
+bool Cone::computeDeviations(const double *points, const int &numPoints, double *deviations, double *footPoints) const{
+
+    if(!this->isSolved || points == 0 || deviations == 0 || numPoints < 0){
+        return false;
+    }
+
+    const double ax = this->xyz.getVector().getAt(0), ay = this->xyz.getVector().getAt(1), az = this->xyz.getVector().getAt(2);
+    const double ux = this->ijk.getVector().getAt(0), uy = this->ijk.getVector().getAt(1), uz = this->ijk.getVector().getAt(2);
+    const double sinAlpha = qSin(this->aperture / 2.0), cosAlpha = qCos(this->aperture / 2.0);
+
+    for(int i = 0; i < numPoints; i++){
+
+        //split into axial and radial part
+        double wx = points[3*i] - ax, wy = points[3*i+1] - ay, wz = points[3*i+2] - az;
+        double t = wx * ux + wy * uy + wz * uz;
+        double qx = wx - t * ux, qy = wy - t * uy, qz = wz - t * uz;
+        double rho = qSqrt(qx * qx + qy * qy + qz * qz);
+
+        //distance to the surface line in the plane of axis and point
+        double normal = rho * cosAlpha - t * sinAlpha;
+        double along = t * cosAlpha + rho * sinAlpha;
+        if(along < 0.0){
+            along = 0.0;
+            deviations[i] = qSqrt(t * t + rho * rho);
+        }else{
+            deviations[i] = normal;
+        }
+
+        if(footPoints != 0){
+            double axial = along * cosAlpha;
+            double radial = rho > 0.0 ? along * sinAlpha / rho : 0.0;
+            footPoints[3*i] = ax + axial * ux + radial * qx;
+            footPoints[3*i+1] = ay + axial * uy + radial * qy;
+            footPoints[3*i+2] = az + axial * uz + radial * qz;
+        }
+
+    }
+
+    return true;
+
+}
+
 /*!
  * \brief Cone::recalc
  */
@@ -217,6 +270,8 @@ void Cone::recalc(){
  */
 QDomElement Cone::toOpenIndyXML(QDomDocument &xmlDoc) const{
 
+    OI_PROFILE_SCOPE("Cone::toOpenIndyXML");
+
     QDomElement cone = Geometry::toOpenIndyXML(xmlDoc);
 
     if(cone.isNull()){
@@ -245,6 +300,8 @@ QDomElement Cone::toOpenIndyXML(QDomDocument &xmlDoc) const{
  */
 bool Cone::fromOpenIndyXML(QDomElement &xmlElem){
 
+    OI_PROFILE_SCOPE("Cone::fromOpenIndyXML");
+
     bool result = Geometry::fromOpenIndyXML(xmlElem);
 
     if(result){
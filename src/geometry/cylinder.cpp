@@ -1,6 +1,7 @@
 #include "cylinder.h"
 
 #include "featurewrapper.h"
+#include "profiler.h"
 
 using namespace oi;
 using namespace oi::math;
@@ -194,6 +195,47 @@ void Cylinder::setUnknownParameters(const QMap<GeometryParameters, double> &para
 
 }
 
+/*!
+ * \brief Cylinder::computeDeviations
+ * Signed distances (positive outside) and foot points of many points (x, y, z each)
+ * \param points
+ * \param numPoints
+ * \param deviations
+ * \param footPoints
+ * \return
+ */
+bool Cylinder::computeDeviations(const double *points, const int &numPoints, double *deviations, double *footPoints) const{
+
+    if(!this->isSolved || points == 0 || deviations == 0 || numPoints < 0){
+        return false;
+    }
+
+    const double ax = this->xyz.getVector().getAt(0), ay = this->xyz.getVector().getAt(1), az = this->xyz.getVector().getAt(2);
+    const double ux = this->ijk.getVector().getAt(0), uy = this->ijk.getVector().getAt(1), uz = this->ijk.getVector().getAt(2);
+    const double r = this->radius.getRadius();
+
+    for(int i = 0; i < numPoints; i++){
+
+        //split into axial and radial part
+        double wx = points[3*i] - ax, wy = points[3*i+1] - ay, wz = points[3*i+2] - az;
+        double t = wx * ux + wy * uy + wz * uz;
+        double qx = wx - t * ux, qy = wy - t * uy, qz = wz - t * uz;
+        double length = qSqrt(qx * qx + qy * qy + qz * qz);
+        deviations[i] = length - r;
+
+        if(footPoints != 0){
+            double scale = length > 0.0 ? r / length : 0.0;
+            footPoints[3*i] = ax + t * ux + scale * qx;
+            footPoints[3*i+1] = ay + t * uy + scale * qy;
+            footPoints[3*i+2] = az + t * uz + scale * qz;
+        }
+
+    }
+
+    return true;
+
+}
+
 /*!
  * \brief Cylinder::recalc
  */
@@ -217,6 +259,8 @@ void Cylinder::recalc(){
  */
 QDomElement Cylinder::toOpenIndyXML(QDomDocument &xmlDoc) const{
 
+    OI_PROFILE_SCOPE("Cylinder::toOpenIndyXML");
+
     QDomElement cylinder = Geometry::toOpenIndyXML(xmlDoc);
 
     if(cylinder.isNull()){
@@ -236,6 +280,8 @@ QDomElement Cylinder::toOpenIndyXML(QDomDocument &xmlDoc) const{
  */
 bool Cylinder::fromOpenIndyXML(QDomElement &xmlElem){
 
+    OI_PROFILE_SCOPE("Cylinder::fromOpenIndyXML");
+
     bool result = Geometry::fromOpenIndyXML(xmlElem);
 
     if(result){
@@ -1,6 +1,7 @@
 #include "ellipse.h"
 
 #include "featurewrapper.h"
+#include "profiler.h"
 
 using namespace oi;
 using namespace oi::math;
@@ -267,6 +268,8 @@ void Ellipse::recalc(){
  */
 QDomElement Ellipse::toOpenIndyXML(QDomDocument &xmlDoc) const{
 
+    OI_PROFILE_SCOPE("Ellipse::toOpenIndyXML");
+
     QDomElement ellipse = Geometry::toOpenIndyXML(xmlDoc);
 
     if(ellipse.isNull()){
@@ -317,6 +320,8 @@ QDomElement Ellipse::toOpenIndyXML(QDomDocument &xmlDoc) const{
  */
 bool Ellipse::fromOpenIndyXML(QDomElement &xmlElem){
 
+    OI_PROFILE_SCOPE("Ellipse::fromOpenIndyXML");
+
     bool result = Geometry::fromOpenIndyXML(xmlElem);
 
     if(result){
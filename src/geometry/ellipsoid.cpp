@@ -1,10 +1,97 @@
 #include "ellipsoid.h"
 
 #include "featurewrapper.h"
+#include "profiler.h"
 
 using namespace oi;
 using namespace oi::math;
 
+namespace{
+
+/*!
+ * \brief robustLength
+ * \param v0
+ * \param v1
+ * \return
+ */
+double robustLength(const double &v0, const double &v1){
+    double m = qMax(qAbs(v0), qAbs(v1));
+    if(m == 0.0){
+        return 0.0;
+    }
+    return m * qSqrt((v0 / m) * (v0 / m) + (v1 / m) * (v1 / m));
+}
+
+/*!
+ * \brief closestPointOnEllipse
+ * Closest point (x0, x1) on the ellipse with semi axes e0 >= e1 to the point (y0, y1) in the first quadrant (bisection, D. Eberly).
+ * Returns the distance
+ * \param e0
+ * \param e1
+ * \param y0
+ * \param y1
+ * \param x0
+ * \param x1
+ * \return
+ */
+double closestPointOnEllipse(const double &e0, const double &e1, const double &y0, const double &y1, double &x0, double &x1){
+
+    if(y1 > 0.0){
+        if(y0 > 0.0){
+            double z0 = y0 / e0;
+            double z1 = y1 / e1;
+            double g = z0 * z0 + z1 * z1 - 1.0;
+            if(g != 0.0){
+                double r0 = (e0 / e1) * (e0 / e1);
+                double n0 = r0 * z0;
+                double s0 = z1 - 1.0;
+                double s1 = g < 0.0 ? 0.0 : robustLength(n0, z1) - 1.0;
+                double s = 0.0;
+                for(int i = 0; i < 150; i++){
+                    s = 0.5 * (s0 + s1);
+                    if(s == s0 || s == s1){
+                        break;
+                    }
+                    double ratio0 = n0 / (s + r0);
+                    double ratio1 = z1 / (s + 1.0);
+                    g = ratio0 * ratio0 + ratio1 * ratio1 - 1.0;
+                    if(g > 0.0){
+                        s0 = s;
+                    }else if(g < 0.0){
+                        s1 = s;
+                    }else{
+                        break;
+                    }
+                }
+                x0 = r0 * y0 / (s + r0);
+                x1 = y1 / (s + 1.0);
+                return qSqrt((x0 - y0) * (x0 - y0) + (x1 - y1) * (x1 - y1));
+            }
+            x0 = y0;
+            x1 = y1;
+            return 0.0;
+        }
+        x0 = 0.0;
+        x1 = e1;
+        return qAbs(y1 - e1);
+    }
+
+    double numer0 = e0 * y0;
+    double denom0 = e0 * e0 - e1 * e1;
+    if(numer0 < denom0){
+        double xde0 = numer0 / denom0;
+        x0 = e0 * xde0;
+        x1 = e1 * qSqrt(1.0 - xde0 * xde0);
+        return qSqrt((x0 - y0) * (x0 - y0) + x1 * x1);
+    }
+    x0 = e0;
+    x1 = 0.0;
+    return qAbs(y0 - e0);
+
+}
+
+}
+
 /*!
  * \brief Ellipsoid::Ellipsoid
  * \param isNominal
@@ -217,6 +304,64 @@ void Ellipsoid::setUnknownParameters(const QMap<GeometryParameters, double> &par
 
 }
 
+/*!
+ * \brief Ellipsoid::computeDeviations
+ * Signed distances (positive outside) and foot points of many points (x, y, z each).
+ * The problem is reduced to the closest point on the meridian ellipse (a along the major axis, b perpendicular to it)
+ * \param points
+ * \param numPoints
+ * \param deviations
+ * \param footPoints
+ * \return
+ */
+bool Ellipsoid::computeDeviations(const double *points, const int &numPoints, double *deviations, double *footPoints) const{
+
+    if(!this->isSolved || points == 0 || deviations == 0 || numPoints < 0 || this->a <= 0.0 || this->b <= 0.0){
+        return false;
+    }
+
+    const double cx = this->xyz.getVector().getAt(0), cy = this->xyz.getVector().getAt(1), cz = this->xyz.getVector().getAt(2);
+    const double ux = this->ijk.getVector().getAt(0), uy = this->ijk.getVector().getAt(1), uz = this->ijk.getVector().getAt(2);
+
+    //the closest point algorithm needs the larger semi axis first
+    const bool swapAxes = this->a < this->b;
+    const double e0 = swapAxes ? this->b : this->a;
+    const double e1 = swapAxes ? this->a : this->b;
+
+    for(int i = 0; i < numPoints; i++){
+
+        //meridian coordinates
+        double wx = points[3*i] - cx, wy = points[3*i+1] - cy, wz = points[3*i+2] - cz;
+        double t = wx * ux + wy * uy + wz * uz;
+        double qx = wx - t * ux, qy = wy - t * uy, qz = wz - t * uz;
+        double rho = qSqrt(qx * qx + qy * qy + qz * qz);
+
+        //closest point in the first quadrant
+        double y0 = swapAxes ? rho : qAbs(t);
+        double y1 = swapAxes ? qAbs(t) : rho;
+        double x0 = 0.0, x1 = 0.0;
+        double distance = closestPointOnEllipse(e0, e1, y0, y1, x0, x1);
+        bool isInside = (y0 / e0) * (y0 / e0) + (y1 / e1) * (y1 / e1) < 1.0;
+        deviations[i] = isInside ? -distance : distance;
+
+        if(footPoints != 0){
+            double footT = swapAxes ? x1 : x0;
+            double footRho = swapAxes ? x0 : x1;
+            if(t < 0.0){
+                footT = -footT;
+            }
+            double radial = rho > 0.0 ? footRho / rho : 0.0;
+            footPoints[3*i] = cx + footT * ux + radial * qx;
+            footPoints[3*i+1] = cy + footT * uy + radial * qy;
+            footPoints[3*i+2] = cz + footT * uz + radial * qz;
+        }
+
+    }
+
+    return true;
+
+}
+
 /*!
  * \brief Ellipsoid::recalc
  */
@@ -241,6 +386,8 @@ void Ellipsoid::recalc(){
  */
 QDomElement Ellipsoid::toOpenIndyXML(QDomDocument &xmlDoc) const{
 
+    OI_PROFILE_SCOPE("Ellipsoid::toOpenIndyXML");
+
     QDomElement ellipsoid = Geometry::toOpenIndyXML(xmlDoc);
 
     if(ellipsoid.isNull()){
@@ -278,6 +425,8 @@ QDomElement Ellipsoid::toOpenIndyXML(QDomDocument &xmlDoc) const{
  */
 bool Ellipsoid::fromOpenIndyXML(QDomElement &xmlElem){
 
+    OI_PROFILE_SCOPE("Ellipsoid::fromOpenIndyXML");
+
     bool result = Geometry::fromOpenIndyXML(xmlElem);
 
     if(result){
@@ -1,6 +1,7 @@
 #include "hyperboloid.h"
 
 #include "featurewrapper.h"
+#include "profiler.h"
 
 using namespace oi;
 using namespace oi::math;
@@ -235,6 +236,8 @@ void Hyperboloid::recalc(){
  */
 QDomElement Hyperboloid::toOpenIndyXML(QDomDocument &xmlDoc) const{
 
+    OI_PROFILE_SCOPE("Hyperboloid::toOpenIndyXML");
+
     QDomElement hyperboloid = Geometry::toOpenIndyXML(xmlDoc);
 
     if(hyperboloid.isNull()){
@@ -272,6 +275,8 @@ QDomElement Hyperboloid::toOpenIndyXML(QDomDocument &xmlDoc) const{
  */
 bool Hyperboloid::fromOpenIndyXML(QDomElement &xmlElem){
 
+    OI_PROFILE_SCOPE("Hyperboloid::fromOpenIndyXML");
+
     bool result = Geometry::fromOpenIndyXML(xmlElem);
 
     if(result){
@@ -1,6 +1,7 @@
 #include "line.h"
 
 #include "featurewrapper.h"
+#include "profiler.h"
 
 using namespace oi;
 using namespace oi::math;
@@ -175,6 +176,40 @@ void Line::setUnknownParameters(const QMap<GeometryParameters, double> &paramete
 
 }
 
+/*!
+ * \brief Line::computeDeviations
+ * Distances (unsigned) and foot points of many points (x, y, z each)
+ * \param points
+ * \param numPoints
+ * \param deviations
+ * \param footPoints
+ * \return
+ */
+bool Line::computeDeviations(const double *points, const int &numPoints, double *deviations, double *footPoints) const{
+
+    if(!this->isSolved || points == 0 || deviations == 0 || numPoints < 0){
+        return false;
+    }
+
+    const double ax = this->xyz.getVector().getAt(0), ay = this->xyz.getVector().getAt(1), az = this->xyz.getVector().getAt(2);
+    const double ux = this->ijk.getVector().getAt(0), uy = this->ijk.getVector().getAt(1), uz = this->ijk.getVector().getAt(2);
+
+    for(int i = 0; i < numPoints; i++){
+        double wx = points[3*i] - ax, wy = points[3*i+1] - ay, wz = points[3*i+2] - az;
+        double t = wx * ux + wy * uy + wz * uz;
+        double qx = wx - t * ux, qy = wy - t * uy, qz = wz - t * uz;
+        deviations[i] = qSqrt(qx * qx + qy * qy + qz * qz);
+        if(footPoints != 0){
+            footPoints[3*i] = ax + t * ux;
+            footPoints[3*i+1] = ay + t * uy;
+            footPoints[3*i+2] = az + t * uz;
+        }
+    }
+
+    return true;
+
+}
+
 /*!
  * \brief Line::recalc
  */
@@ -197,6 +232,8 @@ void Line::recalc(){
  */
 QDomElement Line::toOpenIndyXML(QDomDocument &xmlDoc) const{
 
+    OI_PROFILE_SCOPE("Line::toOpenIndyXML");
+
     QDomElement line = Geometry::toOpenIndyXML(xmlDoc);
 
     if(line.isNull()){
@@ -216,6 +253,8 @@ QDomElement Line::toOpenIndyXML(QDomDocument &xmlDoc) const{
  */
 bool Line::fromOpenIndyXML(QDomElement &xmlElem){
 
+    OI_PROFILE_SCOPE("Line::fromOpenIndyXML");
+
     bool result = Geometry::fromOpenIndyXML(xmlElem);
 
     if(result){
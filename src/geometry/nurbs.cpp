@@ -1,15 +1,84 @@
 #include "nurbs.h"
 
+#include <algorithm>
+#include <limits>
+#include <QVarLengthArray>
+
 #include "featurewrapper.h"
+#include "profiler.h"
 
 using namespace oi;
 
+namespace{
+
+/*!
+ * \brief boxDistance2
+ * Squared distance of a point from an axis aligned bounding box (0 inside)
+ * \param box
+ * \param xyz
+ * \return
+ */
+inline double boxDistance2(const double box[6], const double xyz[3]){
+    double d2 = 0.0;
+    for(int k = 0; k < 3; k++){
+        double d = 0.0;
+        if(xyz[k] < box[k]){
+            d = box[k] - xyz[k];
+        }else if(xyz[k] > box[k+3]){
+            d = xyz[k] - box[k+3];
+        }
+        d2 += d * d;
+    }
+    return d2;
+}
+
+inline double dot(const double a[3], const double b[3]){
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+/*!
+ * \brief numbersToString
+ * \param values
+ * \return
+ */
+QString numbersToString(const QVector<double> &values){
+    QStringList list;
+    list.reserve(values.size());
+    foreach(const double &value, values){
+        list.append(QString::number(value, 'g', 17));
+    }
+    return list.join(" ");
+}
+
+/*!
+ * \brief numbersFromString
+ * \param text
+ * \param values
+ * \return
+ */
+bool numbersFromString(const QString &text, QVector<double> &values){
+    values.clear();
+    QStringList list = text.split(' ', QString::SkipEmptyParts);
+    values.reserve(list.size());
+    foreach(const QString &item, list){
+        bool ok = false;
+        values.append(item.toDouble(&ok));
+        if(!ok){
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
 /*!
  * \brief Nurbs::Nurbs
  * \param isNominal
  * \param parent
  */
-Nurbs::Nurbs(const bool &isNominal, QObject *parent) : Geometry(isNominal, parent){
+Nurbs::Nurbs(const bool &isNominal, QObject *parent) : Geometry(isNominal, parent), degreeU(0), degreeV(0),
+    numControlPointsU(0), numControlPointsV(0){
 
     //set up feature wrapper
     if(!this->selfFeature.isNull()){
@@ -30,6 +99,18 @@ Nurbs::Nurbs(const Nurbs &copy, QObject *parent) : Geometry(copy, parent){
         this->selfFeature->setNurbs(this);
     }
 
+    this->degreeU = copy.degreeU;
+    this->degreeV = copy.degreeV;
+    this->numControlPointsU = copy.numControlPointsU;
+    this->numControlPointsV = copy.numControlPointsV;
+    this->knotsU = copy.knotsU;
+    this->knotsV = copy.knotsV;
+    this->controlPoints = copy.controlPoints;
+    this->weights = copy.weights;
+    this->homogeneousPoints = copy.homogeneousPoints;
+    this->patches = copy.patches;
+    this->bvh = copy.bvh;
+
 }
 
 /*!
@@ -44,6 +125,18 @@ Nurbs &Nurbs::operator=(const Nurbs &copy){
         this->selfFeature->setNurbs(this);
     }
 
+    this->degreeU = copy.degreeU;
+    this->degreeV = copy.degreeV;
+    this->numControlPointsU = copy.numControlPointsU;
+    this->numControlPointsV = copy.numControlPointsV;
+    this->knotsU = copy.knotsU;
+    this->knotsV = copy.knotsV;
+    this->controlPoints = copy.controlPoints;
+    this->weights = copy.weights;
+    this->homogeneousPoints = copy.homogeneousPoints;
+    this->patches = copy.patches;
+    this->bvh = copy.bvh;
+
     return *this;
 
 }
@@ -55,6 +148,306 @@ Nurbs::~Nurbs(){
 
 }
 
+/*!
+ * \brief Nurbs::setNurbs
+ * Sets the control net. controlPoints contains x, y, z of each control point (index = i * numControlPointsV + j),
+ * the knot vectors need numControlPoints + degree + 1 non-decreasing values. Without weights a non-rational surface is defined.
+ * Returns false if the control net is invalid
+ * \param degreeU
+ * \param degreeV
+ * \param numControlPointsU
+ * \param numControlPointsV
+ * \param knotsU
+ * \param knotsV
+ * \param controlPoints
+ * \param weights
+ * \return
+ */
+bool Nurbs::setNurbs(const int &degreeU, const int &degreeV, const int &numControlPointsU, const int &numControlPointsV,
+                     const QVector<double> &knotsU, const QVector<double> &knotsV,
+                     const QVector<double> &controlPoints, const QVector<double> &weights){
+
+    //check degrees and sizes
+    if(degreeU < 1 || degreeV < 1 || degreeU > Nurbs::maxDegree || degreeV > Nurbs::maxDegree
+            || numControlPointsU <= degreeU || numControlPointsV <= degreeV
+            || knotsU.size() != numControlPointsU + degreeU + 1 || knotsV.size() != numControlPointsV + degreeV + 1
+            || controlPoints.size() != 3 * numControlPointsU * numControlPointsV
+            || (!weights.isEmpty() && weights.size() != numControlPointsU * numControlPointsV)){
+        return false;
+    }
+
+    //check knots and weights
+    for(int i = 1; i < knotsU.size(); i++){
+        if(knotsU.at(i) < knotsU.at(i-1)){
+            return false;
+        }
+    }
+    for(int i = 1; i < knotsV.size(); i++){
+        if(knotsV.at(i) < knotsV.at(i-1)){
+            return false;
+        }
+    }
+    foreach(const double &weight, weights){
+        if(weight <= 0.0){
+            return false;
+        }
+    }
+
+    //set the given parameters
+    this->degreeU = degreeU;
+    this->degreeV = degreeV;
+    this->numControlPointsU = numControlPointsU;
+    this->numControlPointsV = numControlPointsV;
+    this->knotsU = knotsU;
+    this->knotsV = knotsV;
+    this->controlPoints = controlPoints;
+    this->weights = weights;
+    if(this->weights.isEmpty()){
+        this->weights.fill(1.0, numControlPointsU * numControlPointsV);
+    }
+
+    this->buildCache();
+
+    emit this->geomParametersChanged(this->id);
+
+    return true;
+
+}
+
+/*!
+ * \brief Nurbs::hasControlNet
+ * \return
+ */
+bool Nurbs::hasControlNet() const{
+    return !this->patches.isEmpty();
+}
+
+/*!
+ * \brief Nurbs::getDegreeU
+ * \return
+ */
+const int &Nurbs::getDegreeU() const{
+    return this->degreeU;
+}
+
+/*!
+ * \brief Nurbs::getDegreeV
+ * \return
+ */
+const int &Nurbs::getDegreeV() const{
+    return this->degreeV;
+}
+
+/*!
+ * \brief Nurbs::getNumControlPointsU
+ * \return
+ */
+const int &Nurbs::getNumControlPointsU() const{
+    return this->numControlPointsU;
+}
+
+/*!
+ * \brief Nurbs::getNumControlPointsV
+ * \return
+ */
+const int &Nurbs::getNumControlPointsV() const{
+    return this->numControlPointsV;
+}
+
+/*!
+ * \brief Nurbs::getKnotsU
+ * \return
+ */
+const QVector<double> &Nurbs::getKnotsU() const{
+    return this->knotsU;
+}
+
+/*!
+ * \brief Nurbs::getKnotsV
+ * \return
+ */
+const QVector<double> &Nurbs::getKnotsV() const{
+    return this->knotsV;
+}
+
+/*!
+ * \brief Nurbs::getControlPoints
+ * \return
+ */
+const QVector<double> &Nurbs::getControlPoints() const{
+    return this->controlPoints;
+}
+
+/*!
+ * \brief Nurbs::getWeights
+ * \return
+ */
+const QVector<double> &Nurbs::getWeights() const{
+    return this->weights;
+}
+
+/*!
+ * \brief Nurbs::evaluate
+ * Surface point at (u, v). Parameters outside of the domain are clamped
+ * \param u
+ * \param v
+ * \param xyz
+ * \return
+ */
+bool Nurbs::evaluate(const double &u, const double &v, double xyz[3]) const{
+
+    if(!this->hasControlNet()){
+        return false;
+    }
+
+    double cu = qBound(this->knotsU.at(this->degreeU), u, this->knotsU.at(this->numControlPointsU));
+    double cv = qBound(this->knotsV.at(this->degreeV), v, this->knotsV.at(this->numControlPointsV));
+    int spanU = this->findSpan(this->knotsU, this->degreeU, this->numControlPointsU, cu);
+    int spanV = this->findSpan(this->knotsV, this->degreeV, this->numControlPointsV, cv);
+
+    double su[3], sv[3], suu[3], suv[3], svv[3];
+    this->evaluateDerivatives(spanU, spanV, cu, cv, xyz, su, sv, suu, suv, svv);
+
+    return true;
+
+}
+
+/*!
+ * \brief Nurbs::evaluateNormal
+ * Unit surface normal (Su x Sv) at (u, v)
+ * \param u
+ * \param v
+ * \param normal
+ * \return
+ */
+bool Nurbs::evaluateNormal(const double &u, const double &v, double normal[3]) const{
+
+    if(!this->hasControlNet()){
+        return false;
+    }
+
+    double cu = qBound(this->knotsU.at(this->degreeU), u, this->knotsU.at(this->numControlPointsU));
+    double cv = qBound(this->knotsV.at(this->degreeV), v, this->knotsV.at(this->numControlPointsV));
+    int spanU = this->findSpan(this->knotsU, this->degreeU, this->numControlPointsU, cu);
+    int spanV = this->findSpan(this->knotsV, this->degreeV, this->numControlPointsV, cv);
+
+    double s[3], su[3], sv[3], suu[3], suv[3], svv[3];
+    this->evaluateDerivatives(spanU, spanV, cu, cv, s, su, sv, suu, suv, svv);
+
+    normal[0] = su[1] * sv[2] - su[2] * sv[1];
+    normal[1] = su[2] * sv[0] - su[0] * sv[2];
+    normal[2] = su[0] * sv[1] - su[1] * sv[0];
+    double length = qSqrt(dot(normal, normal));
+    if(length <= 0.0){
+        return false;
+    }
+    normal[0] /= length;
+    normal[1] /= length;
+    normal[2] /= length;
+
+    return true;
+
+}
+
+/*!
+ * \brief Nurbs::closestPoint
+ * Projects a point onto the surface. Returns the parameters and the foot point
+ * \param xyz
+ * \param u
+ * \param v
+ * \param footPoint
+ * \return
+ */
+bool Nurbs::closestPoint(const double xyz[3], double &u, double &v, double footPoint[3]) const{
+
+    if(!this->hasControlNet()){
+        return false;
+    }
+
+    double best = std::numeric_limits<double>::max();
+    QVarLengthArray<int, 64> stack;
+    stack.append(0);
+    while(!stack.isEmpty()){
+
+        const BvhNode &node = this->bvh.at(stack.last());
+        stack.removeLast();
+
+        //the patch cannot contain a nearer point
+        if(boxDistance2(node.box, xyz) >= best){
+            continue;
+        }
+
+        //refine on the patch
+        if(node.patch >= 0){
+            double pu = 0.0, pv = 0.0, foot[3];
+            double d2 = this->projectOnPatch(this->patches.at(node.patch), xyz, pu, pv, foot);
+            if(d2 < best){
+                best = d2;
+                u = pu;
+                v = pv;
+                footPoint[0] = foot[0];
+                footPoint[1] = foot[1];
+                footPoint[2] = foot[2];
+            }
+            continue;
+        }
+
+        //visit the nearer child first
+        double left = boxDistance2(this->bvh.at(node.left).box, xyz);
+        double right = boxDistance2(this->bvh.at(node.right).box, xyz);
+        if(left < right){
+            stack.append(node.right);
+            stack.append(node.left);
+        }else{
+            stack.append(node.left);
+            stack.append(node.right);
+        }
+
+    }
+
+    return best < std::numeric_limits<double>::max();
+
+}
+
+/*!
+ * \brief Nurbs::computeDeviations
+ * Signed distances (positive in direction of Su x Sv) and foot points of many points (x, y, z each)
+ * \param points
+ * \param numPoints
+ * \param deviations
+ * \param footPoints
+ * \return
+ */
+bool Nurbs::computeDeviations(const double *points, const int &numPoints, double *deviations, double *footPoints) const{
+
+    if(!this->isSolved || !this->hasControlNet() || points == 0 || deviations == 0 || numPoints < 0){
+        return false;
+    }
+
+    for(int i = 0; i < numPoints; i++){
+
+        const double *xyz = points + 3 * i;
+        double u = 0.0, v = 0.0, foot[3], normal[3];
+        if(!this->closestPoint(xyz, u, v, foot)){
+            return false;
+        }
+
+        double diff[3] = {xyz[0] - foot[0], xyz[1] - foot[1], xyz[2] - foot[2]};
+        double distance = qSqrt(dot(diff, diff));
+        deviations[i] = (this->evaluateNormal(u, v, normal) && dot(diff, normal) < 0.0) ? -distance : distance;
+
+        if(footPoints != 0){
+            footPoints[3*i] = foot[0];
+            footPoints[3*i+1] = foot[1];
+            footPoints[3*i+2] = foot[2];
+        }
+
+    }
+
+    return true;
+
+}
+
 /*!
  * \brief Nurbs::recalc
  */
@@ -71,6 +464,8 @@ void Nurbs::recalc(){
  */
 QDomElement Nurbs::toOpenIndyXML(QDomDocument &xmlDoc) const{
 
+    OI_PROFILE_SCOPE("Nurbs::toOpenIndyXML");
+
     QDomElement nurbs = Geometry::toOpenIndyXML(xmlDoc);
 
     if(nurbs.isNull()){
@@ -79,6 +474,35 @@ QDomElement Nurbs::toOpenIndyXML(QDomDocument &xmlDoc) const{
 
     nurbs.setAttribute("type", getGeometryTypeName(eNurbsGeometry));
 
+    //add control net
+    if(this->hasControlNet()){
+
+        QDomElement controlNet = xmlDoc.createElement("controlNet");
+        controlNet.setAttribute("degreeU", this->degreeU);
+        controlNet.setAttribute("degreeV", this->degreeV);
+        controlNet.setAttribute("numControlPointsU", this->numControlPointsU);
+        controlNet.setAttribute("numControlPointsV", this->numControlPointsV);
+
+        QDomElement knotsU = xmlDoc.createElement("knotsU");
+        knotsU.appendChild(xmlDoc.createTextNode(numbersToString(this->knotsU)));
+        controlNet.appendChild(knotsU);
+
+        QDomElement knotsV = xmlDoc.createElement("knotsV");
+        knotsV.appendChild(xmlDoc.createTextNode(numbersToString(this->knotsV)));
+        controlNet.appendChild(knotsV);
+
+        QDomElement controlPoints = xmlDoc.createElement("controlPoints");
+        controlPoints.appendChild(xmlDoc.createTextNode(numbersToString(this->controlPoints)));
+        controlNet.appendChild(controlPoints);
+
+        QDomElement weights = xmlDoc.createElement("weights");
+        weights.appendChild(xmlDoc.createTextNode(numbersToString(this->weights)));
+        controlNet.appendChild(weights);
+
+        nurbs.appendChild(controlNet);
+
+    }
+
     return nurbs;
 
 }
@@ -90,14 +514,468 @@ QDomElement Nurbs::toOpenIndyXML(QDomDocument &xmlDoc) const{
  */
 bool Nurbs::fromOpenIndyXML(QDomElement &xmlElem){
 
+    OI_PROFILE_SCOPE("Nurbs::fromOpenIndyXML");
+
     bool result = Geometry::fromOpenIndyXML(xmlElem);
 
     if(result){
 
+        //set control net (optional)
+        QDomElement controlNet = xmlElem.firstChildElement("controlNet");
+        if(controlNet.isNull()){
+            return result;
+        }
+
+        if(!controlNet.hasAttribute("degreeU") || !controlNet.hasAttribute("degreeV")
+                || !controlNet.hasAttribute("numControlPointsU") || !controlNet.hasAttribute("numControlPointsV")){
+            return false;
+        }
 
+        QVector<double> knotsU, knotsV, controlPoints, weights;
+        if(!numbersFromString(controlNet.firstChildElement("knotsU").text(), knotsU)
+                || !numbersFromString(controlNet.firstChildElement("knotsV").text(), knotsV)
+                || !numbersFromString(controlNet.firstChildElement("controlPoints").text(), controlPoints)
+                || !numbersFromString(controlNet.firstChildElement("weights").text(), weights)){
+            return false;
+        }
+
+        result = this->setNurbs(controlNet.attribute("degreeU").toInt(), controlNet.attribute("degreeV").toInt(),
+                                controlNet.attribute("numControlPointsU").toInt(), controlNet.attribute("numControlPointsV").toInt(),
+                                knotsU, knotsV, controlPoints, weights);
 
     }
 
     return result;
 
 }
+
+/*!
+ * \brief Nurbs::buildCache
+ * Sets up homogeneous control points, patches with sampled surface points and the bounding volume hierarchy
+ */
+void Nurbs::buildCache(){
+
+    this->homogeneousPoints.clear();
+    this->patches.clear();
+    this->bvh.clear();
+
+    //homogeneous control points
+    int numPoints = this->numControlPointsU * this->numControlPointsV;
+    this->homogeneousPoints.resize(4 * numPoints);
+    for(int i = 0; i < numPoints; i++){
+        double w = this->weights.at(i);
+        this->homogeneousPoints[4*i] = w * this->controlPoints.at(3*i);
+        this->homogeneousPoints[4*i+1] = w * this->controlPoints.at(3*i+1);
+        this->homogeneousPoints[4*i+2] = w * this->controlPoints.at(3*i+2);
+        this->homogeneousPoints[4*i+3] = w;
+    }
+
+    //one patch per non-empty knot span pair
+    for(int spanU = this->degreeU; spanU < this->numControlPointsU; spanU++){
+        if(this->knotsU.at(spanU) >= this->knotsU.at(spanU + 1)){
+            continue;
+        }
+        for(int spanV = this->degreeV; spanV < this->numControlPointsV; spanV++){
+            if(this->knotsV.at(spanV) >= this->knotsV.at(spanV + 1)){
+                continue;
+            }
+
+            Patch patch;
+            patch.spanU = spanU;
+            patch.spanV = spanV;
+            patch.uMin = this->knotsU.at(spanU);
+            patch.uMax = this->knotsU.at(spanU + 1);
+            patch.vMin = this->knotsV.at(spanV);
+            patch.vMax = this->knotsV.at(spanV + 1);
+
+            //bounding box of the influencing control points (convex hull property)
+            for(int k = 0; k < 3; k++){
+                patch.box[k] = std::numeric_limits<double>::max();
+                patch.box[k+3] = -std::numeric_limits<double>::max();
+            }
+            for(int i = spanU - this->degreeU; i <= spanU; i++){
+                for(int j = spanV - this->degreeV; j <= spanV; j++){
+                    const double *p = this->controlPoints.constData() + 3 * (i * this->numControlPointsV + j);
+                    for(int k = 0; k < 3; k++){
+                        patch.box[k] = qMin(patch.box[k], p[k]);
+                        patch.box[k+3] = qMax(patch.box[k+3], p[k]);
+                    }
+                }
+            }
+
+            //sampled surface points
+            patch.samples.resize(3 * (Nurbs::sampleCount + 1) * (Nurbs::sampleCount + 1));
+            double s[3], su[3], sv[3], suu[3], suv[3], svv[3];
+            for(int a = 0; a <= Nurbs::sampleCount; a++){
+                double u = patch.uMin + (patch.uMax - patch.uMin) * a / Nurbs::sampleCount;
+                for(int b = 0; b <= Nurbs::sampleCount; b++){
+                    double v = patch.vMin + (patch.vMax - patch.vMin) * b / Nurbs::sampleCount;
+                    this->evaluateDerivatives(spanU, spanV, u, v, s, su, sv, suu, suv, svv);
+                    int index = 3 * (a * (Nurbs::sampleCount + 1) + b);
+                    patch.samples[index] = s[0];
+                    patch.samples[index+1] = s[1];
+                    patch.samples[index+2] = s[2];
+                }
+            }
+
+            this->patches.append(patch);
+
+        }
+    }
+
+    //bounding volume hierarchy
+    if(!this->patches.isEmpty()){
+        QVector<int> patchIndices(this->patches.size());
+        for(int i = 0; i < patchIndices.size(); i++){
+            patchIndices[i] = i;
+        }
+        this->bvh.reserve(2 * this->patches.size());
+        this->buildBvh(patchIndices, 0, patchIndices.size());
+    }
+
+}
+
+/*!
+ * \brief Nurbs::buildBvh
+ * Builds the hierarchy for the patches [begin, end) by median splits along the longest axis. Returns the node index
+ * \param patchIndices
+ * \param begin
+ * \param end
+ * \return
+ */
+int Nurbs::buildBvh(QVector<int> &patchIndices, const int &begin, const int &end){
+
+    //set up node
+    BvhNode node;
+    node.left = -1;
+    node.right = -1;
+    node.patch = -1;
+    for(int k = 0; k < 3; k++){
+        node.box[k] = std::numeric_limits<double>::max();
+        node.box[k+3] = -std::numeric_limits<double>::max();
+    }
+    for(int i = begin; i < end; i++){
+        const Patch &patch = this->patches.at(patchIndices.at(i));
+        for(int k = 0; k < 3; k++){
+            node.box[k] = qMin(node.box[k], patch.box[k]);
+            node.box[k+3] = qMax(node.box[k+3], patch.box[k+3]);
+        }
+    }
+
+    int index = this->bvh.size();
+    if(end - begin == 1){
+        node.patch = patchIndices.at(begin);
+        this->bvh.append(node);
+        return index;
+    }
+    this->bvh.append(node);
+
+    //split at the median of the patch centers
+    int axis = 0;
+    for(int k = 1; k < 3; k++){
+        if(node.box[k+3] - node.box[k] > node.box[axis+3] - node.box[axis]){
+            axis = k;
+        }
+    }
+    int middle = (begin + end) / 2;
+    const QVector<Patch> &patches = this->patches;
+    std::nth_element(patchIndices.begin() + begin, patchIndices.begin() + middle, patchIndices.begin() + end,
+                     [&patches, axis](const int &a, const int &b){
+        return patches.at(a).box[axis] + patches.at(a).box[axis+3] < patches.at(b).box[axis] + patches.at(b).box[axis+3];
+    });
+
+    int left = this->buildBvh(patchIndices, begin, middle);
+    int right = this->buildBvh(patchIndices, middle, end);
+    this->bvh[index].left = left;
+    this->bvh[index].right = right;
+
+    return index;
+
+}
+
+/*!
+ * \brief Nurbs::findSpan
+ * Knot span index of t (binary search)
+ * \param knots
+ * \param degree
+ * \param numControlPoints
+ * \param t
+ * \return
+ */
+int Nurbs::findSpan(const QVector<double> &knots, const int &degree, const int &numControlPoints, const double &t) const{
+
+    int n = numControlPoints - 1;
+    if(t >= knots.at(n + 1)){
+        //last non-empty span
+        int span = n;
+        while(span > degree && knots.at(span) >= knots.at(span + 1)){
+            span--;
+        }
+        return span;
+    }
+    if(t <= knots.at(degree)){
+        return degree;
+    }
+
+    int low = degree;
+    int high = n + 1;
+    int middle = (low + high) / 2;
+    while(t < knots.at(middle) || t >= knots.at(middle + 1)){
+        if(t < knots.at(middle)){
+            high = middle;
+        }else{
+            low = middle;
+        }
+        middle = (low + high) / 2;
+    }
+
+    return middle;
+
+}
+
+/*!
+ * \brief Nurbs::basisFunctionDerivatives
+ * Nonzero basis functions and their first and second derivatives at t (span is the knot span of t)
+ * \param knots
+ * \param degree
+ * \param span
+ * \param t
+ * \param ders
+ */
+void Nurbs::basisFunctionDerivatives(const QVector<double> &knots, const int &degree, const int &span, const double &t,
+                                     double ders[3][maxDegree + 1]) const{
+
+    const int p = degree;
+    const int n = qMin(2, p);
+    const double *u = knots.constData();
+
+    double ndu[maxDegree + 1][maxDegree + 1];
+    double left[maxDegree + 1], right[maxDegree + 1];
+    double a[2][maxDegree + 1];
+
+    //basis functions and knot differences
+    ndu[0][0] = 1.0;
+    for(int j = 1; j <= p; j++){
+        left[j] = t - u[span + 1 - j];
+        right[j] = u[span + j] - t;
+        double saved = 0.0;
+        for(int r = 0; r < j; r++){
+            ndu[j][r] = right[r + 1] + left[j - r];
+            double temp = ndu[r][j - 1] / ndu[j][r];
+            ndu[r][j] = saved + right[r + 1] * temp;
+            saved = left[j - r] * temp;
+        }
+        ndu[j][j] = saved;
+    }
+    for(int j = 0; j <= p; j++){
+        ders[0][j] = ndu[j][p];
+        ders[1][j] = 0.0;
+        ders[2][j] = 0.0;
+    }
+
+    //derivatives
+    for(int r = 0; r <= p; r++){
+        int s1 = 0, s2 = 1;
+        a[0][0] = 1.0;
+        for(int k = 1; k <= n; k++){
+            double d = 0.0;
+            int rk = r - k;
+            int pk = p - k;
+            if(r >= k){
+                a[s2][0] = a[s1][0] / ndu[pk + 1][rk];
+                d = a[s2][0] * ndu[rk][pk];
+            }
+            int j1 = (rk >= -1) ? 1 : -rk;
+            int j2 = (r - 1 <= pk) ? k - 1 : p - r;
+            for(int j = j1; j <= j2; j++){
+                a[s2][j] = (a[s1][j] - a[s1][j - 1]) / ndu[pk + 1][rk + j];
+                d += a[s2][j] * ndu[rk + j][pk];
+            }
+            if(r <= pk){
+                a[s2][k] = -a[s1][k - 1] / ndu[pk + 1][r];
+                d += a[s2][k] * ndu[r][pk];
+            }
+            ders[k][r] = d;
+            std::swap(s1, s2);
+        }
+    }
+    double factor = p;
+    for(int k = 1; k <= n; k++){
+        for(int j = 0; j <= p; j++){
+            ders[k][j] *= factor;
+        }
+        factor *= (p - k);
+    }
+
+}
+
+/*!
+ * \brief Nurbs::evaluateDerivatives
+ * Surface point and first and second partial derivatives at (u, v) in the given knot spans
+ * \param spanU
+ * \param spanV
+ * \param u
+ * \param v
+ * \param s
+ * \param su
+ * \param sv
+ * \param suu
+ * \param suv
+ * \param svv
+ */
+void Nurbs::evaluateDerivatives(const int &spanU, const int &spanV, const double &u, const double &v,
+                                double s[3], double su[3], double sv[3], double suu[3], double suv[3], double svv[3]) const{
+
+    double nu[3][maxDegree + 1], nv[3][maxDegree + 1];
+    this->basisFunctionDerivatives(this->knotsU, this->degreeU, spanU, u, nu);
+    this->basisFunctionDerivatives(this->knotsV, this->degreeV, spanV, v, nv);
+
+    //derivatives of the homogeneous surface (tensor product: first v, then u)
+    double a00[4] = {0.0, 0.0, 0.0, 0.0}, a10[4] = {0.0, 0.0, 0.0, 0.0}, a20[4] = {0.0, 0.0, 0.0, 0.0};
+    double a01[4] = {0.0, 0.0, 0.0, 0.0}, a11[4] = {0.0, 0.0, 0.0, 0.0}, a02[4] = {0.0, 0.0, 0.0, 0.0};
+    const double *pw = this->homogeneousPoints.constData();
+    for(int i = 0; i <= this->degreeU; i++){
+        double t0[4] = {0.0, 0.0, 0.0, 0.0}, t1[4] = {0.0, 0.0, 0.0, 0.0}, t2[4] = {0.0, 0.0, 0.0, 0.0};
+        const double *row = pw + 4 * ((spanU - this->degreeU + i) * this->numControlPointsV + spanV - this->degreeV);
+        for(int j = 0; j <= this->degreeV; j++){
+            for(int k = 0; k < 4; k++){
+                t0[k] += nv[0][j] * row[4*j+k];
+                t1[k] += nv[1][j] * row[4*j+k];
+                t2[k] += nv[2][j] * row[4*j+k];
+            }
+        }
+        for(int k = 0; k < 4; k++){
+            a00[k] += nu[0][i] * t0[k];
+            a10[k] += nu[1][i] * t0[k];
+            a20[k] += nu[2][i] * t0[k];
+            a01[k] += nu[0][i] * t1[k];
+            a11[k] += nu[1][i] * t1[k];
+            a02[k] += nu[0][i] * t2[k];
+        }
+    }
+
+    //rational surface
+    double w = a00[3];
+    for(int k = 0; k < 3; k++){
+        s[k] = a00[k] / w;
+        su[k] = (a10[k] - a10[3] * s[k]) / w;
+        sv[k] = (a01[k] - a01[3] * s[k]) / w;
+        suu[k] = (a20[k] - 2.0 * a10[3] * su[k] - a20[3] * s[k]) / w;
+        suv[k] = (a11[k] - a10[3] * sv[k] - a01[3] * su[k] - a11[3] * s[k]) / w;
+        svv[k] = (a02[k] - 2.0 * a01[3] * sv[k] - a02[3] * s[k]) / w;
+    }
+
+}
+
+/*!
+ * \brief Nurbs::projectOnPatch
+ * Closest point on one patch: starts at the nearest sample and refines with Newton iterations inside of the patch domain.
+ * Returns the squared distance
+ * \param patch
+ * \param xyz
+ * \param u
+ * \param v
+ * \param footPoint
+ * \return
+ */
+double Nurbs::projectOnPatch(const Patch &patch, const double xyz[3], double &u, double &v, double footPoint[3]) const{
+
+    //nearest sample
+    int nearest = 0;
+    double nearestDistance = std::numeric_limits<double>::max();
+    const double *samples = patch.samples.constData();
+    for(int i = 0; i < (Nurbs::sampleCount + 1) * (Nurbs::sampleCount + 1); i++){
+        double dx = samples[3*i] - xyz[0], dy = samples[3*i+1] - xyz[1], dz = samples[3*i+2] - xyz[2];
+        double d2 = dx * dx + dy * dy + dz * dz;
+        if(d2 < nearestDistance){
+            nearestDistance = d2;
+            nearest = i;
+        }
+    }
+    u = patch.uMin + (patch.uMax - patch.uMin) * (nearest / (Nurbs::sampleCount + 1)) / Nurbs::sampleCount;
+    v = patch.vMin + (patch.vMax - patch.vMin) * (nearest % (Nurbs::sampleCount + 1)) / Nurbs::sampleCount;
+
+    //Newton iterations on f = (S - P) * (Su, Sv)
+    double s[3], su[3], sv[3], suu[3], suv[3], svv[3], r[3];
+    double distance = nearestDistance;
+    double lastDistance = std::numeric_limits<double>::max(), lastU = u, lastV = v;
+    for(int iteration = 0; iteration < 30; iteration++){
+
+        this->evaluateDerivatives(patch.spanU, patch.spanV, u, v, s, su, sv, suu, suv, svv);
+        r[0] = s[0] - xyz[0];
+        r[1] = s[1] - xyz[1];
+        r[2] = s[2] - xyz[2];
+        distance = dot(r, r);
+
+        //halve the last step if the distance increased
+        if(distance > lastDistance){
+            u = 0.5 * (u + lastU);
+            v = 0.5 * (v + lastV);
+            continue;
+        }
+        lastDistance = distance;
+        lastU = u;
+        lastV = v;
+
+        double f0 = dot(r, su);
+        double f1 = dot(r, sv);
+        double j00 = dot(su, su) + dot(r, suu);
+        double j01 = dot(su, sv) + dot(r, suv);
+        double j11 = dot(sv, sv) + dot(r, svv);
+        double det = j00 * j11 - j01 * j01;
+        if(j00 <= 0.0 || det <= 0.0){
+            //not convex: Gauss-Newton step
+            j00 = dot(su, su);
+            j01 = dot(su, sv);
+            j11 = dot(sv, sv);
+            det = j00 * j11 - j01 * j01;
+            if(det <= 0.0){
+                break;
+            }
+        }
+
+        //parameters on a patch border that would leave the patch are kept fixed
+        bool fixU = (u <= patch.uMin && f0 > 0.0) || (u >= patch.uMax && f0 < 0.0);
+        bool fixV = (v <= patch.vMin && f1 > 0.0) || (v >= patch.vMax && f1 < 0.0);
+        double du = 0.0, dv = 0.0;
+        if(!fixU && !fixV){
+            du = -(j11 * f0 - j01 * f1) / det;
+            dv = -(j00 * f1 - j01 * f0) / det;
+        }else if(!fixU){
+            du = -f0 / j00;
+        }else if(!fixV){
+            dv = -f1 / j11;
+        }
+
+        double newU = qBound(patch.uMin, u + du, patch.uMax);
+        double newV = qBound(patch.vMin, v + dv, patch.vMax);
+        du = newU - u;
+        dv = newV - v;
+        u = newU;
+        v = newV;
+
+        //converged if the step on the surface is negligible
+        double step = qAbs(du) * qSqrt(dot(su, su)) + qAbs(dv) * qSqrt(dot(sv, sv));
+        if(step < 1e-10){
+            break;
+        }
+
+    }
+    if(distance > lastDistance){
+        u = lastU;
+        v = lastV;
+    }
+
+    //foot point at the final parameters
+    this->evaluateDerivatives(patch.spanU, patch.spanV, u, v, s, su, sv, suu, suv, svv);
+    r[0] = s[0] - xyz[0];
+    r[1] = s[1] - xyz[1];
+    r[2] = s[2] - xyz[2];
+    distance = dot(r, r);
+    footPoint[0] = s[0];
+    footPoint[1] = s[1];
+    footPoint[2] = s[2];
+
+    return distance;
+
+}
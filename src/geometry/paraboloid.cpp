@@ -1,6 +1,7 @@
 #include "paraboloid.h"
 
 #include "featurewrapper.h"
+#include "profiler.h"
 
 using namespace oi;
 using namespace oi::math;
@@ -215,6 +216,8 @@ void Paraboloid::recalc(){
  */
 QDomElement Paraboloid::toOpenIndyXML(QDomDocument &xmlDoc) const{
 
+    OI_PROFILE_SCOPE("Paraboloid::toOpenIndyXML");
+
     QDomElement paraboloid = Geometry::toOpenIndyXML(xmlDoc);
 
     if(paraboloid.isNull()){
@@ -243,6 +246,8 @@ QDomElement Paraboloid::toOpenIndyXML(QDomDocument &xmlDoc) const{
  */
 bool Paraboloid::fromOpenIndyXML(QDomElement &xmlElem){
 
+    OI_PROFILE_SCOPE("Paraboloid::fromOpenIndyXML");
+
     bool result = Geometry::fromOpenIndyXML(xmlElem);
 
     if(result){
@@ -1,6 +1,7 @@
 #include "plane.h"
 
 #include "featurewrapper.h"
+#include "profiler.h"
 
 using namespace oi;
 using namespace oi::math;
@@ -228,6 +229,40 @@ void Plane::setUnknownParameters(const QMap<GeometryParameters, double> &paramet
 
 }
 
+/*!
+ * \brief Plane::computeDeviations
+ * Signed distances (positive in normal direction) and foot points of many points (x, y, z each)
+ * \param points
+ * \param numPoints
+ * \param deviations
+ * \param footPoints
+ * \return
+ */
+bool Plane::computeDeviations(const double *points, const int &numPoints, double *deviations, double *footPoints) const{
+
+    if(!this->isSolved || points == 0 || deviations == 0 || numPoints < 0){
+        return false;
+    }
+
+    const double nx = this->ijk.getVector().getAt(0), ny = this->ijk.getVector().getAt(1), nz = this->ijk.getVector().getAt(2);
+    const double d = nx * this->xyz.getVector().getAt(0) + ny * this->xyz.getVector().getAt(1) + nz * this->xyz.getVector().getAt(2);
+
+    for(int i = 0; i < numPoints; i++){
+        deviations[i] = nx * points[3*i] + ny * points[3*i+1] + nz * points[3*i+2] - d;
+    }
+
+    if(footPoints != 0){
+        for(int i = 0; i < numPoints; i++){
+            footPoints[3*i] = points[3*i] - deviations[i] * nx;
+            footPoints[3*i+1] = points[3*i+1] - deviations[i] * ny;
+            footPoints[3*i+2] = points[3*i+2] - deviations[i] * nz;
+        }
+    }
+
+    return true;
+
+}
+
 /*!
  * \brief Plane::recalc
  */
@@ -251,6 +286,8 @@ void Plane::recalc(){
  */
 QDomElement Plane::toOpenIndyXML(QDomDocument &xmlDoc) const{
 
+    OI_PROFILE_SCOPE("Plane::toOpenIndyXML");
+
     QDomElement plane = Geometry::toOpenIndyXML(xmlDoc);
 
     if(plane.isNull()){
@@ -270,6 +307,8 @@ QDomElement Plane::toOpenIndyXML(QDomDocument &xmlDoc) const{
  */
 bool Plane::fromOpenIndyXML(QDomElement &xmlElem){
 
+    OI_PROFILE_SCOPE("Plane::fromOpenIndyXML");
+
     bool result = Geometry::fromOpenIndyXML(xmlElem);
 
     if(result){
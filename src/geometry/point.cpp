@@ -1,6 +1,7 @@
 #include "point.h"
 
 #include "featurewrapper.h"
+#include "profiler.h"
 
 using namespace oi;
 using namespace oi::math;
@@ -189,6 +190,37 @@ void Point::setUnknownParameters(const QMap<GeometryParameters, double> &paramet
 
 }
 
+/*!
+ * \brief Point::computeDeviations
+ * Distances (unsigned) of many points (x, y, z each), all foot points are the point itself
+ * \param points
+ * \param numPoints
+ * \param deviations
+ * \param footPoints
+ * \return
+ */
+bool Point::computeDeviations(const double *points, const int &numPoints, double *deviations, double *footPoints) const{
+
+    if(!this->isSolved || points == 0 || deviations == 0 || numPoints < 0){
+        return false;
+    }
+
+    const double px = this->xyz.getVector().getAt(0), py = this->xyz.getVector().getAt(1), pz = this->xyz.getVector().getAt(2);
+
+    for(int i = 0; i < numPoints; i++){
+        double vx = points[3*i] - px, vy = points[3*i+1] - py, vz = points[3*i+2] - pz;
+        deviations[i] = qSqrt(vx * vx + vy * vy + vz * vz);
+        if(footPoints != 0){
+            footPoints[3*i] = px;
+            footPoints[3*i+1] = py;
+            footPoints[3*i+2] = pz;
+        }
+    }
+
+    return true;
+
+}
+
 /*!
  * \brief Point::recalc
  */
@@ -210,6 +242,8 @@ void Point::recalc(){
  */
 QDomElement Point::toOpenIndyXML(QDomDocument &xmlDoc) const{
 
+    OI_PROFILE_SCOPE("Point::toOpenIndyXML");
+
     QDomElement point = Geometry::toOpenIndyXML(xmlDoc);
 
     if(point.isNull()){
@@ -229,6 +263,8 @@ QDomElement Point::toOpenIndyXML(QDomDocument &xmlDoc) const{
  */
 bool Point::fromOpenIndyXML(QDomElement &xmlElem){
 
+    OI_PROFILE_SCOPE("Point::fromOpenIndyXML");
+
     bool result = Geometry::fromOpenIndyXML(xmlElem);
 
     if(result){
@@ -1,6 +1,7 @@
 #include "pointcloud.h"
 
 #include "featurewrapper.h"
+#include "profiler.h"
 
 using namespace oi;
 using namespace oi::math;
@@ -166,6 +167,8 @@ void PointCloud::recalc(){
  */
 QDomElement PointCloud::toOpenIndyXML(QDomDocument &xmlDoc) const{
 
+    OI_PROFILE_SCOPE("PointCloud::toOpenIndyXML");
+
     QDomElement pointCloud = Geometry::toOpenIndyXML(xmlDoc);
 
     if(pointCloud.isNull()){
@@ -185,6 +188,8 @@ QDomElement PointCloud::toOpenIndyXML(QDomDocument &xmlDoc) const{
  */
 bool PointCloud::fromOpenIndyXML(QDomElement &xmlElem){
 
+    OI_PROFILE_SCOPE("PointCloud::fromOpenIndyXML");
+
     bool result = Geometry::fromOpenIndyXML(xmlElem);
 
     if(result){
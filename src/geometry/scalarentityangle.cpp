@@ -1,6 +1,7 @@
 #include "scalarentityangle.h"
 
 #include "featurewrapper.h"
+#include "profiler.h"
 
 using namespace oi;
 
@@ -157,6 +158,8 @@ void ScalarEntityAngle::recalc(){
  */
 QDomElement ScalarEntityAngle::toOpenIndyXML(QDomDocument &xmlDoc) const{
 
+    OI_PROFILE_SCOPE("ScalarEntityAngle::toOpenIndyXML");
+
     QDomElement entityAngle = Geometry::toOpenIndyXML(xmlDoc);
 
     if(entityAngle.isNull()){
@@ -185,6 +188,8 @@ QDomElement ScalarEntityAngle::toOpenIndyXML(QDomDocument &xmlDoc) const{
  */
 bool ScalarEntityAngle::fromOpenIndyXML(QDomElement &xmlElem){
 
+    OI_PROFILE_SCOPE("ScalarEntityAngle::fromOpenIndyXML");
+
     bool result = Geometry::fromOpenIndyXML(xmlElem);
 
     if(result){
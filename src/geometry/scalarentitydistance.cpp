@@ -1,6 +1,7 @@
 #include "scalarentitydistance.h"
 
 #include "featurewrapper.h"
+#include "profiler.h"
 
 using namespace oi;
 
@@ -157,6 +158,8 @@ void ScalarEntityDistance::recalc(){
  */
 QDomElement ScalarEntityDistance::toOpenIndyXML(QDomDocument &xmlDoc) const{
 
+    OI_PROFILE_SCOPE("ScalarEntityDistance::toOpenIndyXML");
+
     QDomElement entityDistance = Geometry::toOpenIndyXML(xmlDoc);
 
     if(entityDistance.isNull()){
@@ -185,6 +188,8 @@ QDomElement ScalarEntityDistance::toOpenIndyXML(QDomDocument &xmlDoc) const{
  */
 bool ScalarEntityDistance::fromOpenIndyXML(QDomElement &xmlElem){
 
+    OI_PROFILE_SCOPE("ScalarEntityDistance::fromOpenIndyXML");
+
     bool result = Geometry::fromOpenIndyXML(xmlElem);
 
     if(result){
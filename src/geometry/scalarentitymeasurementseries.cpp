@@ -1,6 +1,7 @@
 #include "scalarentitymeasurementseries.h"
 
 #include "featurewrapper.h"
+#include "profiler.h"
 
 using namespace oi;
 
@@ -157,6 +158,8 @@ void ScalarEntityMeasurementSeries::recalc(){
  */
 QDomElement ScalarEntityMeasurementSeries::toOpenIndyXML(QDomDocument &xmlDoc) const{
 
+    OI_PROFILE_SCOPE("ScalarEntityMeasurementSeries::toOpenIndyXML");
+
     QDomElement entityMeasurementSeries = Geometry::toOpenIndyXML(xmlDoc);
 
     if(entityMeasurementSeries.isNull()){
@@ -185,6 +188,8 @@ QDomElement ScalarEntityMeasurementSeries::toOpenIndyXML(QDomDocument &xmlDoc) c
  */
 bool ScalarEntityMeasurementSeries::fromOpenIndyXML(QDomElement &xmlElem){
 
+    OI_PROFILE_SCOPE("ScalarEntityMeasurementSeries::fromOpenIndyXML");
+
     bool result = Geometry::fromOpenIndyXML(xmlElem);
 
     if(result){
@@ -1,6 +1,7 @@
 #include "scalarentitytemperature.h"
 
 #include "featurewrapper.h"
+#include "profiler.h"
 
 using namespace oi;
 
@@ -157,6 +158,8 @@ void ScalarEntityTemperature::recalc(){
  */
 QDomElement ScalarEntityTemperature::toOpenIndyXML(QDomDocument &xmlDoc) const{
 
+    OI_PROFILE_SCOPE("ScalarEntityTemperature::toOpenIndyXML");
+
     QDomElement entityTemperature = Geometry::toOpenIndyXML(xmlDoc);
 
     if(entityTemperature.isNull()){
@@ -185,6 +188,8 @@ QDomElement ScalarEntityTemperature::toOpenIndyXML(QDomDocument &xmlDoc) const{
  */
 bool ScalarEntityTemperature::fromOpenIndyXML(QDomElement &xmlElem){
 
+    OI_PROFILE_SCOPE("ScalarEntityTemperature::fromOpenIndyXML");
+
     bool result = Geometry::fromOpenIndyXML(xmlElem);
 
     if(result){
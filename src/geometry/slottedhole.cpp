@@ -1,6 +1,7 @@
 #include "slottedhole.h"
 
 #include "featurewrapper.h"
+#include "profiler.h"
 
 using namespace oi;
 using namespace oi::math;
@@ -369,6 +370,8 @@ void SlottedHole::recalc(){
  */
 QDomElement SlottedHole::toOpenIndyXML(QDomDocument &xmlDoc) const{
 
+    OI_PROFILE_SCOPE("SlottedHole::toOpenIndyXML");
+
     QDomElement slottedHole = Geometry::toOpenIndyXML(xmlDoc);
 
     if(slottedHole.isNull()){
@@ -410,6 +413,8 @@ QDomElement SlottedHole::toOpenIndyXML(QDomDocument &xmlDoc) const{
  */
 bool SlottedHole::fromOpenIndyXML(QDomElement &xmlElem){
 
+    OI_PROFILE_SCOPE("SlottedHole::fromOpenIndyXML");
+
     bool result = Geometry::fromOpenIndyXML(xmlElem);
 
     if(result){
@@ -1,6 +1,7 @@
 #include "sphere.h"
 
 #include "featurewrapper.h"
+#include "profiler.h"
 
 using namespace oi;
 using namespace oi::math;
@@ -167,6 +168,40 @@ void Sphere::setUnknownParameters(const QMap<GeometryParameters, double> &parame
 
 }
 
+/*!
+ * \brief Sphere::computeDeviations
+ * Signed distances (positive outside) and foot points of many points (x, y, z each)
+ * \param points
+ * \param numPoints
+ * \param deviations
+ * \param footPoints
+ * \return
+ */
+bool Sphere::computeDeviations(const double *points, const int &numPoints, double *deviations, double *footPoints) const{
+
+    if(!this->isSolved || points == 0 || deviations == 0 || numPoints < 0){
+        return false;
+    }
+
+    const double cx = this->xyz.getVector().getAt(0), cy = this->xyz.getVector().getAt(1), cz = this->xyz.getVector().getAt(2);
+    const double r = this->radius.getRadius();
+
+    for(int i = 0; i < numPoints; i++){
+        double vx = points[3*i] - cx, vy = points[3*i+1] - cy, vz = points[3*i+2] - cz;
+        double length = qSqrt(vx * vx + vy * vy + vz * vz);
+        deviations[i] = length - r;
+        if(footPoints != 0){
+            double scale = length > 0.0 ? r / length : 0.0;
+            footPoints[3*i] = cx + (length > 0.0 ? scale * vx : r);
+            footPoints[3*i+1] = cy + scale * vy;
+            footPoints[3*i+2] = cz + scale * vz;
+        }
+    }
+
+    return true;
+
+}
+
 /*!
  * \brief Sphere::recalc
  */
@@ -189,6 +224,8 @@ void Sphere::recalc(){
  */
 QDomElement Sphere::toOpenIndyXML(QDomDocument &xmlDoc) const{
 
+    OI_PROFILE_SCOPE("Sphere::toOpenIndyXML");
+
     QDomElement sphere = Geometry::toOpenIndyXML(xmlDoc);
 
     if(sphere.isNull()){
@@ -208,6 +245,8 @@ QDomElement Sphere::toOpenIndyXML(QDomDocument &xmlDoc) const{
  */
 bool Sphere::fromOpenIndyXML(QDomElement &xmlElem){
 
+    OI_PROFILE_SCOPE("Sphere::fromOpenIndyXML");
+
     bool result = Geometry::fromOpenIndyXML(xmlElem);
 
     if(result){
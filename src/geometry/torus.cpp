@@ -1,6 +1,7 @@
 #include "torus.h"
 
 #include "featurewrapper.h"
+#include "profiler.h"
 
 using namespace oi;
 using namespace oi::math;
@@ -214,6 +215,54 @@ void Torus::setUnknownParameters(const QMap<GeometryParameters, double> &paramet
 
 }
 
+/*!
+ * \brief Torus::computeDeviations
+ * Signed distances (positive outside) and foot points of many points (x, y, z each)
+ * \param points
+ * \param numPoints
+ * \param deviations
+ * \param footPoints
+ * \return
+ */
+bool Torus::computeDeviations(const double *points, const int &numPoints, double *deviations, double *footPoints) const{
+
+    if(!this->isSolved || points == 0 || deviations == 0 || numPoints < 0){
+        return false;
+    }
+
+    const double cx = this->xyz.getVector().getAt(0), cy = this->xyz.getVector().getAt(1), cz = this->xyz.getVector().getAt(2);
+    const double nx = this->ijk.getVector().getAt(0), ny = this->ijk.getVector().getAt(1), nz = this->ijk.getVector().getAt(2);
+    const double rA = this->radius.getRadius();
+    const double rB = this->radiusB.getRadius();
+
+    for(int i = 0; i < numPoints; i++){
+
+        //nearest point on the center curve
+        double wx = points[3*i] - cx, wy = points[3*i+1] - cy, wz = points[3*i+2] - cz;
+        double h = wx * nx + wy * ny + wz * nz;
+        double qx = wx - h * nx, qy = wy - h * ny, qz = wz - h * nz;
+        double rho = qSqrt(qx * qx + qy * qy + qz * qz);
+        double scale = rho > 0.0 ? rA / rho : 0.0;
+        double mx = cx + scale * qx, my = cy + scale * qy, mz = cz + scale * qz;
+
+        //distance to the tube
+        double vx = points[3*i] - mx, vy = points[3*i+1] - my, vz = points[3*i+2] - mz;
+        double length = qSqrt(vx * vx + vy * vy + vz * vz);
+        deviations[i] = length - rB;
+
+        if(footPoints != 0){
+            double tube = length > 0.0 ? rB / length : 0.0;
+            footPoints[3*i] = mx + tube * vx;
+            footPoints[3*i+1] = my + tube * vy;
+            footPoints[3*i+2] = mz + tube * vz;
+        }
+
+    }
+
+    return true;
+
+}
+
 /*!
  * \brief Torus::recalc
  */
@@ -238,6 +287,8 @@ void Torus::recalc(){
  */
 QDomElement Torus::toOpenIndyXML(QDomDocument &xmlDoc) const{
 
+    OI_PROFILE_SCOPE("Torus::toOpenIndyXML");
+
     QDomElement torus = Geometry::toOpenIndyXML(xmlDoc);
 
     if(torus.isNull()){
@@ -266,6 +317,8 @@ QDomElement Torus::toOpenIndyXML(QDomDocument &xmlDoc) const{
  */
 bool Torus::fromOpenIndyXML(QDomElement &xmlElem){
 
+    OI_PROFILE_SCOPE("Torus::fromOpenIndyXML");
+
     bool result = Geometry::fromOpenIndyXML(xmlElem);
 
     if(result){
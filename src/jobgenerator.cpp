@@ -0,0 +1,411 @@
+#include "jobgenerator.h"
+
+#include <random>
+
+#include <QtCore/qmath.h>
+
+#include "oijob.h"
+#include "featurewrapper.h"
+#include "featureattributes.h"
+#include "station.h"
+#include "coordinatesystem.h"
+#include "reading.h"
+#include "util.h"
+
+using namespace oi;
+
+namespace{
+
+/*!
+ * \brief The Shape class
+ * True parameters of a generated geometry (shared by the nominal and the actual of the same name)
+ */
+class Shape{
+public:
+    double center[3];
+    double axis[3]; //unit vector
+    double radius;
+};
+
+/*!
+ * \brief createShape
+ * \param random
+ * \param extent
+ * \return
+ */
+Shape createShape(std::mt19937 &random, const double &extent){
+
+    std::uniform_real_distribution<double> position(-extent, extent);
+    std::uniform_real_distribution<double> radius(0.1 * extent, 0.2 * extent);
+    std::normal_distribution<double> direction(0.0, 1.0);
+
+    Shape shape;
+    double length = 0.0;
+    for(int i = 0; i < 3; i++){
+        shape.center[i] = position(random);
+    }
+    while(length < 1e-6){
+        length = 0.0;
+        for(int i = 0; i < 3; i++){
+            shape.axis[i] = direction(random);
+            length += shape.axis[i] * shape.axis[i];
+        }
+        length = qSqrt(length);
+    }
+    for(int i = 0; i < 3; i++){
+        shape.axis[i] /= length;
+    }
+    shape.radius = radius(random);
+
+    return shape;
+
+}
+
+/*!
+ * \brief getBasis
+ * Returns two unit vectors perpendicular to the axis of the shape and to each other
+ * \param shape
+ * \param u
+ * \param v
+ */
+void getBasis(const Shape &shape, double *u, double *v){
+
+    const double *a = shape.axis;
+
+    //start with the coordinate axis that is most perpendicular to the shape axis
+    double e[3] = {0.0, 0.0, 0.0};
+    if(qAbs(a[0]) <= qAbs(a[1]) && qAbs(a[0]) <= qAbs(a[2])){
+        e[0] = 1.0;
+    }else if(qAbs(a[1]) <= qAbs(a[2])){
+        e[1] = 1.0;
+    }else{
+        e[2] = 1.0;
+    }
+
+    //u = a x e, v = a x u
+    u[0] = a[1] * e[2] - a[2] * e[1];
+    u[1] = a[2] * e[0] - a[0] * e[2];
+    u[2] = a[0] * e[1] - a[1] * e[0];
+    double length = qSqrt(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+    for(int i = 0; i < 3; i++){
+        u[i] /= length;
+    }
+    v[0] = a[1] * u[2] - a[2] * u[1];
+    v[1] = a[2] * u[0] - a[0] * u[2];
+    v[2] = a[0] * u[1] - a[1] * u[0];
+
+}
+
+/*!
+ * \brief setNominal
+ * Sets the parameters of a nominal geometry (types without simple parameters remain unchanged)
+ * \param feature
+ * \param shape
+ */
+void setNominal(const QPointer<FeatureWrapper> &feature, const Shape &shape){
+
+    Position center(shape.center[0], shape.center[1], shape.center[2]);
+    Direction axis(shape.axis[0], shape.axis[1], shape.axis[2]);
+    Radius radius(shape.radius);
+
+    switch(feature->getFeatureTypeEnum()){
+    case eCircleFeature:
+        feature->getCircle()->setCircle(center, axis, radius);
+        break;
+    case eCylinderFeature:
+        feature->getCylinder()->setCylinder(center, axis, radius);
+        break;
+    case eLineFeature:
+        feature->getLine()->setLine(center, axis);
+        break;
+    case ePlaneFeature:
+        feature->getPlane()->setPlane(center, axis);
+        break;
+    case ePointFeature:
+        feature->getPoint()->setPoint(center);
+        break;
+    case eSphereFeature:
+        feature->getSphere()->setSphere(center, radius);
+        break;
+    default:
+        break;
+    }
+
+}
+
+/*!
+ * \brief createReadings
+ * Samples numReadings points of the shape (types without a sampling rule are sampled like spheres)
+ * \param type
+ * \param shape
+ * \param settings
+ * \param random
+ * \return
+ */
+QList<QPointer<Reading> > createReadings(const FeatureTypes &type, const Shape &shape, const JobGeneratorSettings &settings, std::mt19937 &random){
+
+    QList<QPointer<Reading> > readings;
+
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    std::uniform_real_distribution<double> angle(0.0, 2.0 * PI);
+    std::normal_distribution<double> noise(0.0, settings.noise);
+
+    double u[3], v[3];
+    getBasis(shape, u, v);
+
+    for(int i = 0; i < settings.numReadings; i++){
+
+        //point of the shape relative to its center
+        double xyz[3] = {0.0, 0.0, 0.0};
+        switch(type){
+        case ePointFeature:
+            break;
+        case eLineFeature:{
+            double t = shape.radius * uniform(random);
+            for(int j = 0; j < 3; j++){
+                xyz[j] = t * shape.axis[j];
+            }
+            break;
+        }case ePlaneFeature:{
+            double s = shape.radius * uniform(random);
+            double t = shape.radius * uniform(random);
+            for(int j = 0; j < 3; j++){
+                xyz[j] = s * u[j] + t * v[j];
+            }
+            break;
+        }case eCircleFeature:{
+            double alpha = angle(random);
+            for(int j = 0; j < 3; j++){
+                xyz[j] = shape.radius * (qCos(alpha) * u[j] + qSin(alpha) * v[j]);
+            }
+            break;
+        }case eCylinderFeature:{
+            double alpha = angle(random);
+            double t = shape.radius * uniform(random);
+            for(int j = 0; j < 3; j++){
+                xyz[j] = shape.radius * (qCos(alpha) * u[j] + qSin(alpha) * v[j]) + t * shape.axis[j];
+            }
+            break;
+        }default:{
+            double alpha = angle(random);
+            double z = uniform(random);
+            double r = qSqrt(1.0 - z * z);
+            for(int j = 0; j < 3; j++){
+                xyz[j] = shape.radius * (r * qCos(alpha) * u[j] + r * qSin(alpha) * v[j] + z * shape.axis[j]);
+            }
+            break;
+        }
+        }
+        for(int j = 0; j < 3; j++){
+            xyz[j] += shape.center[j] + noise(random);
+        }
+
+        //create reading
+        if(settings.readingType == ePolarReading){
+            OiVec polar = Reading::toPolar(xyz[0], xyz[1], xyz[2]);
+            ReadingPolar reading;
+            reading.azimuth = polar.getAt(0);
+            reading.zenith = polar.getAt(1);
+            reading.distance = polar.getAt(2);
+            reading.isValid = true;
+            readings.append(new Reading(reading));
+        }else{
+            ReadingCartesian reading;
+            reading.xyz.setAt(0, xyz[0]);
+            reading.xyz.setAt(1, xyz[1]);
+            reading.xyz.setAt(2, xyz[2]);
+            reading.isValid = true;
+            readings.append(new Reading(reading));
+        }
+
+    }
+
+    return readings;
+
+}
+
+}
+
+/*!
+ * \brief JobGenerator::JobGenerator
+ */
+JobGenerator::JobGenerator(){
+
+}
+
+/*!
+ * \brief JobGenerator::JobGenerator
+ * \param settings
+ */
+JobGenerator::JobGenerator(const JobGeneratorSettings &settings) : settings(settings){
+
+}
+
+/*!
+ * \brief JobGenerator::getSettings
+ * \return
+ */
+const JobGeneratorSettings &JobGenerator::getSettings() const{
+    return this->settings;
+}
+
+/*!
+ * \brief JobGenerator::setSettings
+ * \param settings
+ */
+void JobGenerator::setSettings(const JobGeneratorSettings &settings){
+    this->settings = settings;
+}
+
+/*!
+ * \brief JobGenerator::generate
+ * Adds stations, part systems, transformation parameters, geometries and readings to the given job.
+ * Returns false if the settings are invalid or a feature could not be created
+ * \param job
+ * \return
+ */
+bool JobGenerator::generate(const QPointer<OiJob> &job) const{
+
+    //check job and settings
+    if(job.isNull() || this->settings.numStations < 0 || this->settings.numCoordinateSystems < 0
+            || this->settings.numTrafoParams < 0 || this->settings.numNominals < 0
+            || this->settings.numActuals < 0 || this->settings.numReadings < 0){
+        return false;
+    }
+    if(this->settings.numNominals > 0 && this->settings.numCoordinateSystems == 0){ //nominals need a nominal system
+        return false;
+    }
+    if(this->settings.numActuals > 0 && this->settings.numReadings > 0 && this->settings.numStations == 0){ //readings need a station
+        return false;
+    }
+    if(this->settings.numTrafoParams > 0 && (this->settings.numStations == 0 || this->settings.numCoordinateSystems == 0)){
+        return false;
+    }
+    foreach(const FeatureTypes &type, this->settings.geometryTypes){
+        if(!getIsGeometry(type)){
+            return false;
+        }
+    }
+
+    std::mt19937 random(this->settings.seed);
+
+    //create stations and part systems
+    QList<QPointer<FeatureWrapper> > stations, systems;
+    if(this->settings.numStations > 0){
+        FeatureAttributes fAttr;
+        fAttr.typeOfFeature = eStationFeature;
+        fAttr.name = "STATION1";
+        fAttr.count = this->settings.numStations;
+        stations = job->addFeatures(fAttr);
+        if(stations.size() != this->settings.numStations){
+            return false;
+        }
+    }
+    if(this->settings.numCoordinateSystems > 0){
+        FeatureAttributes fAttr;
+        fAttr.typeOfFeature = eCoordinateSystemFeature;
+        fAttr.name = "PART1";
+        fAttr.count = this->settings.numCoordinateSystems;
+        systems = job->addFeatures(fAttr);
+        if(systems.size() != this->settings.numCoordinateSystems){
+            return false;
+        }
+    }
+
+    //create transformation parameters from the station systems to the part systems
+    for(int i = 0; i < this->settings.numTrafoParams; i++){
+        FeatureAttributes fAttr;
+        fAttr.typeOfFeature = eTrafoParamFeature;
+        fAttr.name = QString("TRAFO%1").arg(i + 1);
+        fAttr.count = 1;
+        fAttr.startSystem = stations.at(i % stations.size())->getStation()->getCoordinateSystem()->getFeatureName();
+        fAttr.destinationSystem = systems.at(i % systems.size())->getCoordinateSystem()->getFeatureName();
+        if(job->addFeatures(fAttr).size() != 1){
+            return false;
+        }
+    }
+
+    //create nominal and actual geometries (the nominal and the actual of a name share the same shape)
+    QList<QList<QPair<int, Shape> > > measuredGeometries; //actual geometries per station
+    for(int i = 0; i < stations.size(); i++){
+        measuredGeometries.append(QList<QPair<int, Shape> >());
+    }
+    int numMeasured = 0;
+    foreach(const FeatureTypes &type, this->settings.geometryTypes){
+
+        int numNames = qMax(this->settings.numNominals, this->settings.numActuals);
+        int numPairs = qMin(this->settings.numNominals, this->settings.numActuals);
+        if(numNames == 0){
+            continue;
+        }
+
+        QVector<Shape> shapes(numNames);
+        for(int i = 0; i < numNames; i++){
+            shapes[i] = createShape(random, this->settings.extent);
+        }
+
+        //names are created in batches of nominal and actual pairs, nominals only and actuals only
+        QString prefix = getFeatureTypeName(type);
+        prefix.remove(' ');
+        QList<QPointer<FeatureWrapper> > features;
+        for(int batch = 0; batch < 3; batch++){
+            FeatureAttributes fAttr;
+            fAttr.typeOfFeature = type;
+            fAttr.nominalSystem = systems.isEmpty() ? QString() : systems.first()->getCoordinateSystem()->getFeatureName();
+            fAttr.isNominal = batch != 2;
+            fAttr.isActual = batch != 1;
+            fAttr.count = batch == 0 ? numPairs : (fAttr.isNominal ? this->settings.numNominals : this->settings.numActuals) - numPairs;
+            fAttr.name = QString("%1%2").arg(prefix).arg(batch == 0 ? 1 : numPairs + 1);
+            if(fAttr.count <= 0){
+                continue;
+            }
+            QList<QPointer<FeatureWrapper> > created = job->addFeatures(fAttr);
+            if(created.isEmpty()){
+                return false;
+            }
+            features.append(created);
+        }
+
+        //names are created in ascending order, so that the first occurrence of a name gives its shape
+        QHash<QString, int> shapeIndices;
+        foreach(const QPointer<FeatureWrapper> &feature, features){
+            if(feature.isNull() || feature->getGeometry().isNull()){
+                continue;
+            }
+            QString name = feature->getGeometry()->getFeatureName();
+            if(!shapeIndices.contains(name)){
+                shapeIndices.insert(name, shapeIndices.size());
+            }
+            const Shape &shape = shapes.at(qMin(shapeIndices.value(name), numNames - 1));
+            if(feature->getGeometry()->getIsNominal()){
+                setNominal(feature, shape);
+            }else if(!stations.isEmpty()){
+                measuredGeometries[numMeasured % stations.size()].append(QPair<int, Shape>(feature->getGeometry()->getId(), shape));
+                numMeasured++;
+            }
+        }
+
+    }
+
+    //add readings station by station
+    if(this->settings.numReadings > 0){
+        for(int i = 0; i < stations.size(); i++){
+            if(measuredGeometries.at(i).isEmpty()){
+                continue;
+            }
+            stations.at(i)->getStation()->setActiveStationState(true);
+            for(int j = 0; j < measuredGeometries.at(i).size(); j++){
+                const QPair<int, Shape> &geometry = measuredGeometries.at(i).at(j);
+                QPointer<FeatureWrapper> feature = job->getFeatureById(geometry.first);
+                if(feature.isNull()){
+                    return false;
+                }
+                job->addMeasurementResults(geometry.first,
+                                           createReadings(feature->getFeatureTypeEnum(), geometry.second, this->settings, random));
+            }
+        }
+    }
+
+    return true;
+
+}
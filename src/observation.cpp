@@ -3,6 +3,7 @@
 #include "station.h"
 #include "coordinatesystem.h"
 #include "function.h"
+#include "profiler.h"
 
 using namespace oi;
 using namespace oi::math;
@@ -295,6 +296,11 @@ const QPointer<Station> &Observation::getStation() const{
 void Observation::setStation(const QPointer<Station> &station){
     if(this->station.isNull() && !station.isNull()){
         this->station = station;
+
+        //update the target geometry index of the station
+        foreach(const QPointer<Geometry> &targetGeometry, this->targetGeometriesList){
+            this->station->addTargetGeometry(targetGeometry);
+        }
     }
 }
 
@@ -324,6 +330,11 @@ void Observation::addTargetGeometry(const QPointer<Geometry> &targetGeometry){
 
         targetGeometry->addObservation(this);
 
+        //update the target geometry index of the station
+        if(!this->station.isNull()){
+            this->station->addTargetGeometry(targetGeometry);
+        }
+
         if(this->measuredTargetGeometry.isNull()){
             this->measuredTargetGeometry = targetGeometry;
         }
@@ -350,6 +361,11 @@ void Observation::removeTargetGeometry(const QPointer<Geometry> &targetGeometry)
 
         targetGeometry->removeObservation(this);
 
+        //update the target geometry index of the station
+        if(!this->station.isNull()){
+            this->station->removeTargetGeometry(targetGeometry->getId());
+        }
+
     }
 
 }
@@ -668,6 +684,8 @@ QString Observation::getDisplayIsSolved() const{
  */
 QDomElement Observation::toOpenIndyXML(QDomDocument &xmlDoc) const{
 
+    OI_PROFILE_SCOPE("Observation::toOpenIndyXML");
+
     QDomElement observation = Element::toOpenIndyXML(xmlDoc);
 
     if(observation.isNull()){
@@ -754,6 +772,8 @@ QDomElement Observation::toOpenIndyXML(QDomDocument &xmlDoc) const{
  */
 bool Observation::fromOpenIndyXML(QDomElement &xmlElem){
 
+    OI_PROFILE_SCOPE("Observation::fromOpenIndyXML");
+
     bool result = Element::fromOpenIndyXML(xmlElem);
 
     if(result){
@@ -1,12 +1,16 @@
 #include "oijob.h"
 #include "bundleadjustment.h"
+#include "profiler.h"
+
+#include <algorithm>
+
 using namespace oi;
 
 /*!
  * \brief OiJob::OiJob
  * \param parent
  */
-OiJob::OiJob(QObject *parent) : QObject(parent), nextId(1), activeGroup("All Groups"){
+OiJob::OiJob(QObject *parent) : QObject(parent), nextId(1), activeGroup("All Groups"), changeSequence(0), prunedSequence(0){
 
 }
 
@@ -122,6 +126,18 @@ int OiJob::generateUniqueId(){
     return (this->nextId - 1);
 }
 
+/*!
+ * \brief OiJob::generateUniqueIds
+ * Reserves a block of count consecutive ids and returns the first one
+ * \param count
+ * \return
+ */
+int OiJob::generateUniqueIds(const int &count){
+    int firstId = this->nextId;
+    this->nextId += qMax(count, 0);
+    return firstId;
+}
+
 /*!
  * \brief OiJob::validateFeatureName
  * \param name
@@ -140,6 +156,24 @@ bool OiJob::validateFeatureName(const QString &name, const FeatureTypes &type, c
     //get a list of features with name name
     QList<QPointer<FeatureWrapper> > features = this->featureContainer.getFeaturesByName(name);
 
+    return this->validateFeatureName(features, type, isNominal, nominalSystem);
+
+}
+
+/*!
+ * \brief OiJob::validateFeatureName
+ * Checks if a new feature may be added next to the given features with the same name
+ * \param equalNameFeatures
+ * \param type
+ * \param isNominal
+ * \param nominalSystem
+ * \return
+ */
+bool OiJob::validateFeatureName(const QList<QPointer<FeatureWrapper> > &equalNameFeatures, const FeatureTypes &type,
+                                const bool &isNominal, const QPointer<CoordinateSystem> &nominalSystem) const{
+
+    const QList<QPointer<FeatureWrapper> > &features = equalNameFeatures;
+
     //accept name if no other feature with that name exists
     if(features.size() == 0){
         return true;
@@ -349,6 +383,27 @@ QList<QPointer<FeatureWrapper> > OiJob::getFeaturesByName(const QString &name, c
     return this->featureContainer.getFeaturesByName(name, startWith);
 }
 
+/*!
+ * \brief OiJob::getFeaturesByNamePrefix
+ * Returns one page of the features whose name starts with prefix (case insensitive, sorted by name)
+ * \param prefix
+ * \param offset
+ * \param limit
+ * \return
+ */
+QList<QPointer<FeatureWrapper> > OiJob::getFeaturesByNamePrefix(const QString &prefix, const int &offset, const int &limit) const{
+    return this->featureContainer.getFeaturesByNamePrefix(prefix, offset, limit);
+}
+
+/*!
+ * \brief OiJob::getFeatureCountByNamePrefix
+ * \param prefix
+ * \return
+ */
+int OiJob::getFeatureCountByNamePrefix(const QString &prefix) const{
+    return this->featureContainer.getFeatureCountByNamePrefix(prefix);
+}
+
 /*!
  * \brief OiJob::getFeaturesByGroup
  * \param group
@@ -444,6 +499,161 @@ bool OiJob::setActiveGroup(const QString &group){
     return false;
 }
 
+/*!
+ * \brief OiJob::getChangeSequence
+ * Returns the current change sequence number. It is increased on every feature, observation or attribute change
+ * \return
+ */
+const quint64 &OiJob::getChangeSequence() const{
+    return this->changeSequence;
+}
+
+/*!
+ * \brief OiJob::getFeaturesChangedSince
+ * Returns the ids of all features that have been added or changed after the given change sequence number
+ * \param sequence
+ * \return
+ */
+QList<int> OiJob::getFeaturesChangedSince(const quint64 &sequence) const{
+    QList<int> featureIds;
+    QMap<quint64, int>::const_iterator it = this->featureChanges.upperBound(sequence);
+    for(; it != this->featureChanges.constEnd(); ++it){
+        featureIds.append(it.value());
+    }
+    return featureIds;
+}
+
+/*!
+ * \brief OiJob::getFeaturesRemovedSince
+ * Returns the ids of all features that have been removed after the given change sequence number
+ * \param sequence
+ * \return
+ */
+QList<int> OiJob::getFeaturesRemovedSince(const quint64 &sequence) const{
+    QList<int> featureIds;
+    QMap<quint64, int>::const_iterator it = this->removedFeatures.upperBound(sequence);
+    for(; it != this->removedFeatures.constEnd(); ++it){
+        featureIds.append(it.value());
+    }
+    return featureIds;
+}
+
+/*!
+ * \brief OiJob::getIsChangeTracked
+ * Returns true if the changes since the given sequence number are complete. Only the latest removals are tracked,
+ * so a client that polls too rarely has to request all features again (sequence 0)
+ * \param sequence
+ * \return
+ */
+bool OiJob::getIsChangeTracked(const quint64 &sequence) const{
+    return sequence == 0 || sequence >= this->prunedSequence;
+}
+
+/*!
+ * \brief OiJob::getObservationsChangedSince
+ * Returns the ids of all features whose observations have been changed after the given change sequence number
+ * \param sequence
+ * \return
+ */
+QList<int> OiJob::getObservationsChangedSince(const quint64 &sequence) const{
+    QList<int> featureIds;
+    QMap<quint64, int>::const_iterator it = this->observationChanges.upperBound(sequence);
+    for(; it != this->observationChanges.constEnd(); ++it){
+        featureIds.append(it.value());
+    }
+    return featureIds;
+}
+
+/*!
+ * \brief OiJob::getFunctionExecutionStatistics
+ * Returns the execution statistics of the functions of all features with functions (feature id -> statistics in function order)
+ * \return
+ */
+QMap<int, QList<FunctionExecutionStatistic> > OiJob::getFunctionExecutionStatistics() const{
+    QMap<int, QList<FunctionExecutionStatistic> > statistics;
+    foreach(const QPointer<FeatureWrapper> &feature, this->featureContainer.getFeaturesList()){
+        if(feature.isNull() || feature->getFeature().isNull() || feature->getFeature()->getFunctions().isEmpty()){
+            continue;
+        }
+        QList<FunctionExecutionStatistic> &featureStatistics = statistics[feature->getFeature()->getId()];
+        foreach(const QPointer<Function> &function, feature->getFeature()->getFunctions()){
+            featureStatistics.append(function.isNull() ? FunctionExecutionStatistic() : function->getExecutionStatistic());
+        }
+    }
+    return statistics;
+}
+
+/*!
+ * \brief OiJob::getFeaturesByExecutionTime
+ * Returns the ids of the features whose functions have been executed, sorted by the total execution time of their functions (slowest first)
+ * \param limit maximum number of returned ids (-1 for all)
+ * \return
+ */
+QList<int> OiJob::getFeaturesByExecutionTime(const int &limit) const{
+
+    //sort by negative time to get the slowest features first
+    QList<QPair<qint64, int> > times;
+    foreach(const QPointer<FeatureWrapper> &feature, this->featureContainer.getFeaturesList()){
+        if(feature.isNull() || feature->getFeature().isNull()){
+            continue;
+        }
+        qint64 totalTime = 0;
+        bool isExecuted = false;
+        foreach(const QPointer<Function> &function, feature->getFeature()->getFunctions()){
+            if(!function.isNull() && function->getExecutionStatistic().numExecutions > 0){
+                totalTime += function->getExecutionStatistic().totalTime;
+                isExecuted = true;
+            }
+        }
+        if(isExecuted){
+            times.append(QPair<qint64, int>(-totalTime, feature->getFeature()->getId()));
+        }
+    }
+    std::sort(times.begin(), times.end());
+
+    QList<int> featureIds;
+    for(int i = 0; i < times.size() && (limit < 0 || i < limit); i++){
+        featureIds.append(times.at(i).second);
+    }
+    return featureIds;
+
+}
+
+/*!
+ * \brief OiJob::resetFunctionExecutionStatistics
+ */
+void OiJob::resetFunctionExecutionStatistics(){
+    foreach(const QPointer<FeatureWrapper> &feature, this->featureContainer.getFeaturesList()){
+        if(feature.isNull() || feature->getFeature().isNull()){
+            continue;
+        }
+        foreach(const QPointer<Function> &function, feature->getFeature()->getFunctions()){
+            if(!function.isNull()){
+                function->resetExecutionStatistic();
+            }
+        }
+    }
+}
+
+/*!
+ * \brief OiJob::getMemoryUsage
+ * Returns the approximate memory usage of this job. The usage of features, observations, readings, input elements
+ * and statistics is updated whenever they are added or removed, only the size of the change tracking is added here
+ * \return
+ */
+JobMemoryUsage OiJob::getMemoryUsage() const{
+
+    JobMemoryUsage usage = this->memoryUsage;
+
+    //change tracking
+    usage.caches = (qint64)(this->featureChanges.size() + this->observationChanges.size() + this->removedFeatures.size())
+            * sizeof(QMapNode<quint64, int>)
+            + (qint64)(this->featureSequences.size() + this->observationSequences.size()) * sizeof(QHashNode<int, quint64>);
+
+    return usage;
+
+}
+
 /*!
  * \brief OiJob::addFeature
  * \param feature
@@ -548,31 +758,27 @@ QList<QPointer<FeatureWrapper> > OiJob::addFeatures(const FeatureAttributes &fAt
 
     }
 
-    //create and validate feature names
+    //create feature names and get all existing features with these names in one pass over the name index
     QStringList featureNames = this->createFeatureNames(fAttr.name, fAttr.count);
-    if(getIsGeometry(fAttr.typeOfFeature)){
-        if(fAttr.isNominal){
-            foreach(const QString &name, featureNames){
-                if(!validateFeatureName(name, fAttr.typeOfFeature, true, nominalSystem)){
-                    emit this->sendMessage("No valid feature name specified", eErrorMessage);
-                    return result;
-                }
-            }
+    QHash<QString, QList<QPointer<FeatureWrapper> > > equalNameFeatures = this->getFeaturesByNames(featureNames);
+
+    //validate feature names
+    bool isGeometry = getIsGeometry(fAttr.typeOfFeature);
+    foreach(const QString &name, featureNames){
+        const QList<QPointer<FeatureWrapper> > features = equalNameFeatures.value(name);
+        bool isValid = name.compare("") != 0;
+        if(isValid && isGeometry && fAttr.isNominal){
+            isValid = this->validateFeatureName(features, fAttr.typeOfFeature, true, nominalSystem);
         }
-        if(fAttr.isActual){
-            foreach(const QString &name, featureNames){
-                if(!validateFeatureName(name, fAttr.typeOfFeature)){
-                    emit this->sendMessage("No valid feature name specified", eErrorMessage);
-                    return result;
-                }
-            }
+        if(isValid && isGeometry && fAttr.isActual){
+            isValid = this->validateFeatureName(features, fAttr.typeOfFeature, false, QPointer<CoordinateSystem>());
         }
-    }else{
-        foreach(const QString &name, featureNames){
-            if(!validateFeatureName(name, fAttr.typeOfFeature)){
-                emit this->sendMessage("No valid feature name specified", eErrorMessage);
-                return result;
-            }
+        if(isValid && !isGeometry){
+            isValid = this->validateFeatureName(features, fAttr.typeOfFeature, false, QPointer<CoordinateSystem>());
+        }
+        if(!isValid){
+            emit this->sendMessage("No valid feature name specified", eErrorMessage);
+            return result;
         }
     }
 
@@ -582,11 +788,22 @@ QList<QPointer<FeatureWrapper> > OiJob::addFeatures(const FeatureAttributes &fAt
         isNewGroup = true;
     }
 
+    //reserve ids for all geometries (other features generate ids for their sub elements when the job is set)
+    int numFeatures = featureNames.size();
+    if(isGeometry && fAttr.isNominal && fAttr.isActual){
+        numFeatures *= 2;
+    }
+    int nextFeatureId = isGeometry ? this->generateUniqueIds(numFeatures) : -1;
+    result.reserve(numFeatures);
+
     //create the features and add them to OpenIndy
     foreach(const QString &name, featureNames){
 
+        const QList<QPointer<FeatureWrapper> > features = equalNameFeatures.value(name);
+
         //create nominal
-        if(getIsGeometry(fAttr.typeOfFeature) && fAttr.isNominal){
+        QPointer<FeatureWrapper> nominal;
+        if(isGeometry && fAttr.isNominal){
 
             //create and check feature
             QPointer<FeatureWrapper> feature = this->createFeatureWrapper(fAttr.typeOfFeature, true);
@@ -594,8 +811,9 @@ QList<QPointer<FeatureWrapper> > OiJob::addFeatures(const FeatureAttributes &fAt
                 continue;
             }
 
-            //pass the job to the feature
-            feature->getFeature()->setJob(this);
+            //pass the job and the reserved id to the feature
+            feature->getFeature()->job = this;
+            feature->getFeature()->id = nextFeatureId++;
 
             //set feature attributes
             feature->getFeature()->name = name;
@@ -613,8 +831,7 @@ QList<QPointer<FeatureWrapper> > OiJob::addFeatures(const FeatureAttributes &fAt
             }
 
             //search corresponding actual
-            QList<QPointer<FeatureWrapper> > equalNameFeatures = this->featureContainer.getFeaturesByName(name);
-            foreach(const QPointer<FeatureWrapper> &equal, equalNameFeatures){
+            foreach(const QPointer<FeatureWrapper> &equal, features){
                 if(!equal.isNull() && equal->getFeatureTypeEnum() == fAttr.typeOfFeature && !equal->getGeometry()->getIsNominal()){
                     feature->getGeometry()->actual = equal->getGeometry();
                     equal->getGeometry()->nominals.append(feature->getGeometry());
@@ -623,15 +840,17 @@ QList<QPointer<FeatureWrapper> > OiJob::addFeatures(const FeatureAttributes &fAt
 
             //add and connect feature
             this->featureContainer.addFeature(feature);
+            this->addFeatureMemoryUsage(feature);
             this->connectFeature(feature);
 
             //add feature to result list
             result.append(feature);
+            nominal = feature;
 
         }
 
         //create actual
-        if(getIsGeometry(fAttr.typeOfFeature) && fAttr.isActual){
+        if(isGeometry && fAttr.isActual){
 
             //create and check feature
             QPointer<FeatureWrapper> feature = this->createFeatureWrapper(fAttr.typeOfFeature, true);
@@ -639,8 +858,9 @@ QList<QPointer<FeatureWrapper> > OiJob::addFeatures(const FeatureAttributes &fAt
                 continue;
             }
 
-            //pass the job to the feature
-            feature->getFeature()->setJob(this);
+            //pass the job and the reserved id to the feature
+            feature->getFeature()->job = this;
+            feature->getFeature()->id = nextFeatureId++;
 
             //set feature attributes
             feature->getFeature()->name = name;
@@ -648,17 +868,21 @@ QList<QPointer<FeatureWrapper> > OiJob::addFeatures(const FeatureAttributes &fAt
             feature->getGeometry()->isNominal = false;
             feature->getGeometry()->isCommon = fAttr.isCommon;
 
-            //search corresponding nominal
-            QList<QPointer<FeatureWrapper> > equalNameFeatures = this->featureContainer.getFeaturesByName(name);
-            foreach(const QPointer<FeatureWrapper> &equal, equalNameFeatures){
+            //search corresponding nominals (existing ones and the one created above)
+            foreach(const QPointer<FeatureWrapper> &equal, features){
                 if(!equal.isNull() && equal->getFeatureTypeEnum() == fAttr.typeOfFeature && equal->getGeometry()->getIsNominal()){
                     equal->getGeometry()->actual = feature->getGeometry();
                     feature->getGeometry()->nominals.append(equal->getGeometry());
                 }
             }
+            if(!nominal.isNull()){
+                nominal->getGeometry()->actual = feature->getGeometry();
+                feature->getGeometry()->nominals.append(nominal->getGeometry());
+            }
 
             //add and connect feature
             this->featureContainer.addFeature(feature);
+            this->addFeatureMemoryUsage(feature);
             this->connectFeature(feature);
 
             //add feature to result list
@@ -667,7 +891,7 @@ QList<QPointer<FeatureWrapper> > OiJob::addFeatures(const FeatureAttributes &fAt
         }
 
         //create non-geometry feature
-        if(!getIsGeometry(fAttr.typeOfFeature)){
+        if(!isGeometry){
 
             //create and check feature
             QPointer<FeatureWrapper> feature = this->createFeatureWrapper(fAttr.typeOfFeature, true);
@@ -713,6 +937,7 @@ QList<QPointer<FeatureWrapper> > OiJob::addFeatures(const FeatureAttributes &fAt
 
             //add and connect feature
             this->featureContainer.addFeature(feature);
+            this->addFeatureMemoryUsage(feature);
             this->connectFeature(feature);
 
             //add feature to result list
@@ -820,6 +1045,10 @@ bool OiJob::removeFeature(const int &featureId){
 
     this->disconnectFeature(feature);
 
+    //the feature is disconnected, so that elementAboutToBeDeleted is not called on deletion
+    this->updateRemovedSequence(featureId);
+    this->releaseFeatureMemoryUsage(featureId, feature->getFeatureTypeEnum());
+
     bool success = this->featureContainer.removeFeature(featureId);
 
     emit this->featureSetChanged();
@@ -857,7 +1086,12 @@ bool OiJob::removeFeature(const QPointer<FeatureWrapper> &feature){
 
     this->disconnectFeature(feature);
 
-    bool success = this->featureContainer.removeFeature(feature->getFeature()->getId());
+    //the feature is disconnected, so that elementAboutToBeDeleted is not called on deletion
+    const int featureId = feature->getFeature()->getId();
+    this->updateRemovedSequence(featureId);
+    this->releaseFeatureMemoryUsage(featureId, feature->getFeatureTypeEnum());
+
+    bool success = this->featureContainer.removeFeature(featureId);
 
     emit this->featureSetChanged();
 
@@ -956,7 +1190,23 @@ bool OiJob::removeFeatures(const QList<QPointer<FeatureWrapper> > &features){
  * \brief OiJob::removeAll
  */
 void OiJob::removeAll(){
+
+    //detach the functions from the memory usage (the container does not delete the features)
+    foreach(const QPointer<FeatureWrapper> &feature, this->featureContainer.getFeaturesList()){
+        if(feature.isNull() || feature->getFeature().isNull()){
+            continue;
+        }
+        foreach(const QPointer<Function> &function, feature->getFeature()->getFunctions()){
+            if(!function.isNull()){
+                function->setJob(QPointer<OiJob>());
+            }
+        }
+    }
+
     this->featureContainer.removeAll();
+    this->memoryUsage = JobMemoryUsage();
+    this->memoryUsageFeatures.clear();
+
 }
 
 /*!
@@ -1571,6 +1821,9 @@ void OiJob::removeInputElement(const QPointer<FeatureWrapper> &target, const int
  */
 void OiJob::addMeasurementResults(const int &geomId, const QList<QPointer<Reading> > &readings){
 
+    OI_PROFILE_SCOPE("OiJob::addMeasurementResults");
+    OI_PROFILE_COUNT("OiJob::addMeasurementResults readings", readings.size());
+
     //check active station
     QPointer<Station> activeStation = this->activeStation;
     if(activeStation.isNull() || activeStation->getCoordinateSystem().isNull()){
@@ -1645,6 +1898,8 @@ void OiJob::removeObservations(const int &featureId){
         delete obs.data();
     }
 
+    this->updateChangeSequence(featureId, true);
+
     //recalculate the feature
     emit this->recalcFeature(feature->getFeature());
 
@@ -1738,6 +1993,8 @@ void OiJob::removeObservations(const int &featureId, const QList<int> selectedId
         }
     }
 
+    this->updateChangeSequence(featureId, true);
+
     //recalculate the feature
     emit this->recalcFeature(feature->getFeature());
 
@@ -1816,6 +2073,8 @@ void OiJob::setActiveFeature(const int &featureId){
         return;
     }
 
+    this->updateChangeSequence(featureId);
+
     if(feature->getFeature()->getIsActiveFeature()){ //if the feature was activated
 
         //check if feature already is the active feature
@@ -1866,6 +2125,8 @@ void OiJob::setActiveStation(const int &featureId){
         return;
     }
 
+    this->updateChangeSequence(featureId);
+
     if(feature->getStation()->getIsActiveStation()){ //if the station was activated
 
         //check if station already is the active station
@@ -1937,6 +2198,8 @@ void OiJob::setActiveCoordinateSystem(const int &featureId){
         return;
     }
 
+    this->updateChangeSequence(featureId);
+
     if(feature->getCoordinateSystem()->getIsActiveCoordinateSystem()){ //if the system was activated
 
         //check if system already is the active system
@@ -1982,6 +2245,8 @@ void OiJob::setFeatureName(const int &featureId, const QString &oldName){
         return;
     }
 
+    this->updateChangeSequence(featureId);
+
     //save the ids of renamed features
     QList<int> renamedFeatures;
 
@@ -2044,6 +2309,7 @@ void OiJob::setFeatureName(const int &featureId, const QString &oldName){
     this->featureContainer.featureNameChanged(featureId, oldName);
     foreach(const int &id, renamedFeatures){
         this->featureContainer.featureNameChanged(id, oldName);
+        this->updateChangeSequence(id);
     }
 
     emit this->featureAttributesChanged();
@@ -2064,6 +2330,8 @@ void OiJob::setFeatureGroup(const int &featureId, const QString &oldGroup){
         return;
     }
 
+    this->updateChangeSequence(featureId);
+
     //check if the group is a new group
     bool isNewGroup = false;
     if(!this->featureContainer.getFeatureGroupList().contains(feature->getFeature()->getGroupName())){
@@ -2092,6 +2360,7 @@ void OiJob::setFeatureGroup(const int &featureId, const QString &oldGroup){
  * \param featureId
  */
 void OiJob::setFeatureComment(const int &featureId){
+    this->updateChangeSequence(featureId);
     emit this->featureAttributesChanged();
     emit this->featureCommentChanged(featureId);
 }
@@ -2101,6 +2370,7 @@ void OiJob::setFeatureComment(const int &featureId){
  * \param featureId
  */
 void OiJob::setFeatureIsUpdated(const int &featureId){
+    this->updateChangeSequence(featureId);
     emit this->featureAttributesChanged();
     emit this->featureIsUpdatedChanged(featureId);
 }
@@ -2110,6 +2380,7 @@ void OiJob::setFeatureIsUpdated(const int &featureId){
  * \param featureId
  */
 void OiJob::setFeatureIsSolved(const int &featureId){
+    this->updateChangeSequence(featureId);
     emit this->featureAttributesChanged();
     emit this->featureIsSolvedChanged(featureId);
 }
@@ -2119,6 +2390,7 @@ void OiJob::setFeatureIsSolved(const int &featureId){
  * \param featureId
  */
 void OiJob::setFeatureFunctions(const int &featureId){
+    this->updateChangeSequence(featureId);
     emit this->featureAttributesChanged();
     emit this->featureFunctionsChanged(featureId);
 }
@@ -2128,6 +2400,7 @@ void OiJob::setFeatureFunctions(const int &featureId){
  * \param featureId
  */
 void OiJob::setFeatureUsedFor(const int &featureId){
+    this->updateChangeSequence(featureId);
     emit this->featureAttributesChanged();
     emit this->featureUsedForChanged(featureId);
 }
@@ -2137,6 +2410,7 @@ void OiJob::setFeatureUsedFor(const int &featureId){
  * \param featureId
  */
 void OiJob::setFeaturePreviouslyNeeded(const int &featureId){
+    this->updateChangeSequence(featureId);
     emit this->featureAttributesChanged();
     emit this->featurePreviouslyNeededChanged(featureId);
 }
@@ -2146,6 +2420,7 @@ void OiJob::setFeaturePreviouslyNeeded(const int &featureId){
  * \param featureId
  */
 void OiJob::setGeometryIsCommon(const int &featureId){
+    this->updateChangeSequence(featureId);
     emit this->geometryIsCommonChanged(featureId);
 }
 
@@ -2154,6 +2429,7 @@ void OiJob::setGeometryIsCommon(const int &featureId){
  * \param featureId
  */
 void OiJob::setGeometryNominals(const int &featureId){
+    this->updateChangeSequence(featureId);
     emit this->geometryNominalsChanged(featureId);
 }
 
@@ -2162,6 +2438,7 @@ void OiJob::setGeometryNominals(const int &featureId){
  * \param featureId
  */
 void OiJob::setGeometryActual(const int &featureId){
+    this->updateChangeSequence(featureId);
     emit this->geometryActualChanged(featureId);
 }
 
@@ -2170,6 +2447,7 @@ void OiJob::setGeometryActual(const int &featureId){
  * \param featureId
  */
 void OiJob::setGeometryObservations(const int &featureId){
+    this->updateChangeSequence(featureId, true);
     emit this->geometryObservationsChanged(featureId);
 }
 
@@ -2178,6 +2456,7 @@ void OiJob::setGeometryObservations(const int &featureId){
  * \param featureId
  */
 void OiJob::setGeometryNominalSystem(const int &featureId){
+    this->updateChangeSequence(featureId);
     emit this->geometryNominalSystemChanged(featureId);
 }
 
@@ -2186,6 +2465,7 @@ void OiJob::setGeometryNominalSystem(const int &featureId){
  * \param featureId
  */
 void OiJob::setGeometryStatistic(const int &featureId){
+    this->updateChangeSequence(featureId);
     emit this->geometryStatisticChanged(featureId);
 }
 
@@ -2194,6 +2474,7 @@ void OiJob::setGeometryStatistic(const int &featureId){
  * \param featureId
  */
 void OiJob::setGeometrySimulationData(const int &featureId){
+    this->updateChangeSequence(featureId);
     emit this->geometrySimulationDataChanged(featureId);
 }
 
@@ -2208,16 +2489,28 @@ void OiJob::setGeometryMeasurementConfig(const int &featureId, const QString &ol
     //update feature container
     this->featureContainer.geometryMeasurementConfigChanged(featureId, oldMConfig, oldKey);
 
+    this->updateChangeSequence(featureId);
+
     emit this->geometryMeasurementConfigChanged(featureId, oldMConfig, oldKey);
 
 }
 
+/*!
+ * \brief OiJob::setGeometryParameters
+ * \param featureId
+ */
+void OiJob::setGeometryParameters(const int &featureId){
+    this->updateChangeSequence(featureId);
+    emit this->geometryParametersChanged(featureId);
+}
+
 /*!
  * \brief OiJob::setSystemObservations
  * \param featureId
  * \param obsId
  */
 void OiJob::setSystemObservations(const int &featureId, const int &obsId){
+    this->updateChangeSequence(featureId, true);
     emit this->systemObservationsChanged(featureId, obsId);
 }
 
@@ -2226,6 +2519,7 @@ void OiJob::setSystemObservations(const int &featureId, const int &obsId){
  * \param featureId
  */
 void OiJob::setSystemTrafoParams(const int &featureId){
+    this->updateChangeSequence(featureId);
     emit this->systemTrafoParamsChanged(featureId);
 }
 
@@ -2234,6 +2528,7 @@ void OiJob::setSystemTrafoParams(const int &featureId){
  * \param featureId
  */
 void OiJob::setSystemsNominals(const int &featureId){
+    this->updateChangeSequence(featureId);
     emit this->systemsNominalsChanged(featureId);
 }
 
@@ -2242,6 +2537,7 @@ void OiJob::setSystemsNominals(const int &featureId){
  * \param featureId
  */
 void OiJob::setStationSensor(const int &featureId){
+    this->updateChangeSequence(featureId);
     emit this->stationSensorChanged(featureId);
 }
 
@@ -2250,6 +2546,7 @@ void OiJob::setStationSensor(const int &featureId){
  * \param featureId
  */
 void OiJob::setTrafoParamParameters(const int &featureId){
+    this->updateChangeSequence(featureId);
     emit this->trafoParamParametersChanged(featureId);
 }
 
@@ -2258,6 +2555,7 @@ void OiJob::setTrafoParamParameters(const int &featureId){
  * \param featureId
  */
 void OiJob::setTrafoParamSystems(const int &featureId){
+    this->updateChangeSequence(featureId);
     emit this->trafoParamSystemsChanged(featureId);
 }
 
@@ -2266,6 +2564,7 @@ void OiJob::setTrafoParamSystems(const int &featureId){
  * \param featureId
  */
 void OiJob::setTrafoParamIsUsed(const int &featureId){
+    this->updateChangeSequence(featureId);
     emit this->trafoParamIsUsedChanged(featureId);
 }
 
@@ -2275,6 +2574,7 @@ void OiJob::setTrafoParamIsUsed(const int &featureId){
  */
 void OiJob::setTrafoParamIsDatum(const int &featureId)
 {
+    this->updateChangeSequence(featureId);
     emit this->trafoParamIsDatumChanged(featureId);
 }
 
@@ -2305,9 +2605,240 @@ void OiJob::elementAboutToBeDeleted(const int &elementId, const QString &name, c
 
     QPointer<FeatureWrapper> feature = this->featureContainer.getFeatureById(elementId);
     this->disconnectFeature(feature);
+    if(!feature.isNull()){
+        this->updateRemovedSequence(elementId);
+    }
+    this->releaseFeatureMemoryUsage(elementId, type);
     this->featureContainer.checkAndClean(elementId, name, group, type);
 }
 
+/*!
+ * \brief OiJob::updateChangeSequence
+ * Increases the change sequence number and moves the feature to the end of the change log
+ * \param featureId
+ * \param observationsChanged
+ */
+void OiJob::updateChangeSequence(const int &featureId, const bool &observationsChanged){
+
+    this->changeSequence++;
+
+    //feature changes
+    QHash<int, quint64>::iterator it = this->featureSequences.find(featureId);
+    if(it != this->featureSequences.end()){
+        this->featureChanges.remove(it.value());
+        it.value() = this->changeSequence;
+    }else{
+        this->featureSequences.insert(featureId, this->changeSequence);
+    }
+    this->featureChanges.insert(this->changeSequence, featureId);
+
+    //observation changes
+    if(observationsChanged){
+        it = this->observationSequences.find(featureId);
+        if(it != this->observationSequences.end()){
+            this->observationChanges.remove(it.value());
+            it.value() = this->changeSequence;
+        }else{
+            this->observationSequences.insert(featureId, this->changeSequence);
+        }
+        this->observationChanges.insert(this->changeSequence, featureId);
+    }
+
+}
+
+/*!
+ * \brief OiJob::updateRemovedSequence
+ * Increases the change sequence number and moves the feature from the change log to the removed features.
+ * Only the latest maxRemovedFeatures removals are kept (see getIsChangeTracked)
+ * \param featureId
+ */
+void OiJob::updateRemovedSequence(const int &featureId){
+
+    this->changeSequence++;
+
+    if(this->featureSequences.contains(featureId)){
+        this->featureChanges.remove(this->featureSequences.take(featureId));
+    }
+    if(this->observationSequences.contains(featureId)){
+        this->observationChanges.remove(this->observationSequences.take(featureId));
+    }
+    this->removedFeatures.insert(this->changeSequence, featureId);
+
+    //prune the oldest removals
+    while(this->removedFeatures.size() > OiJob::maxRemovedFeatures){
+        this->prunedSequence = this->removedFeatures.firstKey();
+        this->removedFeatures.erase(this->removedFeatures.begin());
+    }
+
+}
+
+/*!
+ * \brief OiJob::addFeatureMemoryUsage
+ * Adds the memory usage of a feature that is added to this job.
+ * Observations are not included because they are counted by the station system (see addObservationMemoryUsage)
+ * \param feature
+ */
+void OiJob::addFeatureMemoryUsage(const QPointer<FeatureWrapper> &feature){
+
+    //check feature
+    if(feature.isNull() || feature->getFeature().isNull()){
+        return;
+    }
+
+    //check wether the feature is already included
+    if(this->memoryUsageFeatures.contains(feature->getFeature()->getId())){
+        return;
+    }
+
+    //feature (released by releaseFeatureMemoryUsage)
+    this->memoryUsageFeatures.insert(feature->getFeature()->getId());
+    const FeatureTypes &type = feature->getFeatureTypeEnum();
+    this->memoryUsage.numFeatures[type]++;
+    this->memoryUsage.features[type] += OiJob::getFeatureMemoryUsage(type);
+
+    //statistic of geometries (afterwards updated by Geometry::setStatistic and released by ~Geometry)
+    if(!feature->getGeometry().isNull()){
+        this->addStatisticMemoryUsage(feature->getGeometry()->getStatistic().getMemoryUsage());
+    }
+
+    //input elements of the functions (afterwards updated by the functions themselves and released by ~Function)
+    foreach(const QPointer<Function> &function, feature->getFeature()->getFunctions()){
+        if(!function.isNull()){
+            function->setJob(this);
+        }
+    }
+
+}
+
+/*!
+ * \brief OiJob::releaseFeatureMemoryUsage
+ * Subtracts the size of a feature that is removed from this job or deleted. Called by removeFeature and
+ * elementAboutToBeDeleted, a feature is only released once
+ * \param featureId
+ * \param type
+ */
+void OiJob::releaseFeatureMemoryUsage(const int &featureId, const FeatureTypes &type){
+    if(this->memoryUsageFeatures.remove(featureId)){
+        this->memoryUsage.numFeatures[type]--;
+        this->memoryUsage.features[type] -= OiJob::getFeatureMemoryUsage(type);
+    }
+}
+
+/*!
+ * \brief OiJob::getFeatureMemoryUsage
+ * Returns the size of a feature of the given type
+ * \param type
+ * \return
+ */
+qint64 OiJob::getFeatureMemoryUsage(const FeatureTypes &type){
+
+    qint64 bytes = sizeof(FeatureWrapper);
+    switch(type){
+    case eStationFeature:
+        bytes += sizeof(Station) + sizeof(CoordinateSystem) + sizeof(Point); //station with its system and position
+        break;
+    case eTrafoParamFeature:
+        bytes += sizeof(TrafoParam);
+        break;
+    case eCoordinateSystemFeature:
+        bytes += sizeof(CoordinateSystem);
+        break;
+    case eCircleFeature:
+        bytes += sizeof(Circle);
+        break;
+    case eConeFeature:
+        bytes += sizeof(Cone);
+        break;
+    case eCylinderFeature:
+        bytes += sizeof(Cylinder);
+        break;
+    case eEllipseFeature:
+        bytes += sizeof(Ellipse);
+        break;
+    case eEllipsoidFeature:
+        bytes += sizeof(Ellipsoid);
+        break;
+    case eHyperboloidFeature:
+        bytes += sizeof(Hyperboloid);
+        break;
+    case eLineFeature:
+        bytes += sizeof(Line);
+        break;
+    case eNurbsFeature:
+        bytes += sizeof(Nurbs);
+        break;
+    case eParaboloidFeature:
+        bytes += sizeof(Paraboloid);
+        break;
+    case ePlaneFeature:
+        bytes += sizeof(Plane);
+        break;
+    case ePointFeature:
+        bytes += sizeof(Point);
+        break;
+    case ePointCloudFeature:
+        bytes += sizeof(PointCloud);
+        break;
+    case eScalarEntityAngleFeature:
+        bytes += sizeof(ScalarEntityAngle);
+        break;
+    case eScalarEntityDistanceFeature:
+        bytes += sizeof(ScalarEntityDistance);
+        break;
+    case eScalarEntityMeasurementSeriesFeature:
+        bytes += sizeof(ScalarEntityMeasurementSeries);
+        break;
+    case eScalarEntityTemperatureFeature:
+        bytes += sizeof(ScalarEntityTemperature);
+        break;
+    case eSlottedHoleFeature:
+        bytes += sizeof(SlottedHole);
+        break;
+    case eSphereFeature:
+        bytes += sizeof(Sphere);
+        break;
+    case eTorusFeature:
+        bytes += sizeof(Torus);
+        break;
+    default:
+        bytes += sizeof(Feature);
+        break;
+    }
+    return bytes;
+
+}
+
+/*!
+ * \brief OiJob::addObservationMemoryUsage
+ * Called by CoordinateSystem when observations (each with its reading) are added (count > 0) or removed (count < 0)
+ * \param count
+ */
+void OiJob::addObservationMemoryUsage(const int &count){
+    this->memoryUsage.numObservations += count;
+    this->memoryUsage.observations += (qint64)count * sizeof(Observation);
+    this->memoryUsage.numReadings += count;
+    this->memoryUsage.readings += (qint64)count * sizeof(Reading);
+}
+
+/*!
+ * \brief OiJob::addInputElementMemoryUsage
+ * Called by Function when input elements are added (count > 0) or removed (count < 0)
+ * \param count
+ */
+void OiJob::addInputElementMemoryUsage(const int &count){
+    this->memoryUsage.numInputElements += count;
+    this->memoryUsage.inputElements += (qint64)count * sizeof(InputElement);
+}
+
+/*!
+ * \brief OiJob::addStatisticMemoryUsage
+ * Called by Geometry when its statistic changed
+ * \param bytes
+ */
+void OiJob::addStatisticMemoryUsage(const qint64 &bytes){
+    this->memoryUsage.statistics += bytes;
+}
+
 /*!
  * \brief OiJob::connectFeature
  * \param feature
@@ -2319,6 +2850,9 @@ void OiJob::connectFeature(const QPointer<FeatureWrapper> &feature){
         return;
     }
 
+    //a new feature is a change
+    this->updateChangeSequence(feature->getFeature()->getId(), getIsGeometry(feature->getFeatureTypeEnum()));
+
     //general element connects
     QObject::connect(feature->getFeature().data(), &Element::elementAboutToBeDeleted,
                      this, &OiJob::elementAboutToBeDeleted, Qt::AutoConnection);
@@ -2361,6 +2895,8 @@ void OiJob::connectFeature(const QPointer<FeatureWrapper> &feature){
                          this, &OiJob::setGeometrySimulationData, Qt::AutoConnection);
         QObject::connect(feature->getGeometry().data(), &Geometry::geomMeasurementConfigChanged,
                          this, &OiJob::setGeometryMeasurementConfig, Qt::AutoConnection);
+        QObject::connect(feature->getGeometry().data(), &Geometry::geomParametersChanged,
+                         this, &OiJob::setGeometryParameters, Qt::AutoConnection);
     }
 
     //trafo param connects
@@ -2460,6 +2996,8 @@ void OiJob::disconnectFeature(const QPointer<FeatureWrapper> &feature){
                          this, &OiJob::setGeometrySimulationData);
         QObject::disconnect(feature->getGeometry().data(), &Geometry::geomMeasurementConfigChanged,
                          this, &OiJob::setGeometryMeasurementConfig);
+        QObject::disconnect(feature->getGeometry().data(), &Geometry::geomParametersChanged,
+                         this, &OiJob::setGeometryParameters);
     }
 
     //trafo param connects
@@ -2525,11 +3063,12 @@ QStringList OiJob::createFeatureNames(const QString &name, const int &count) con
     QString baseName = name;
     QString postFix;
 
-    int index = baseName.lastIndexOf(QRegExp("[0-9]*$"), baseName.length()-1);
+    QRegExp digits("[0-9]*$");
+    int index = baseName.lastIndexOf(digits, baseName.length()-1);
     while(index > -1){
         postFix.prepend(QStringRef(&baseName, index, baseName.length() - index).toString());
         baseName.resize(index);
-        index = baseName.lastIndexOf(QRegExp("[0-9]*$"), baseName.length()-1);
+        index = baseName.lastIndexOf(digits, baseName.length()-1);
     }
 
     //add leading zero
@@ -2571,6 +3110,57 @@ QStringList OiJob::createFeatureNames(const QString &name, const int &count) con
 
 }
 
+/*!
+ * \brief OiJob::getFeaturesByNames
+ * Returns the existing features for each of the given names (names without features are not contained).
+ * Names with a common prefix (e.g. created by createFeatureNames) are looked up in one prefix query
+ * \param names
+ * \return
+ */
+QHash<QString, QList<QPointer<FeatureWrapper> > > OiJob::getFeaturesByNames(const QStringList &names) const{
+
+    QHash<QString, QList<QPointer<FeatureWrapper> > > result;
+    if(names.isEmpty()){
+        return result;
+    }
+
+    //get the common prefix of all names
+    QString prefix = names.first();
+    foreach(const QString &name, names){
+        int length = 0;
+        while(length < prefix.size() && length < name.size() && prefix.at(length) == name.at(length)){
+            length++;
+        }
+        prefix.truncate(length);
+    }
+
+    //without common prefix look up each name
+    if(prefix.isEmpty() || names.size() == 1){
+        foreach(const QString &name, names){
+            QList<QPointer<FeatureWrapper> > features = this->featureContainer.getFeaturesByName(name);
+            if(!features.isEmpty()){
+                result.insert(name, features);
+            }
+        }
+        return result;
+    }
+
+    //one query for all names
+    QSet<QString> nameSet = QSet<QString>::fromList(names);
+    foreach(const QPointer<FeatureWrapper> &feature, this->featureContainer.getFeaturesByNamePrefix(prefix)){
+        if(feature.isNull() || feature->getFeature().isNull()){
+            continue;
+        }
+        const QString &name = feature->getFeature()->getFeatureName();
+        if(nameSet.contains(name)){
+            result[name].append(feature);
+        }
+    }
+
+    return result;
+
+}
+
 /*!
  * \brief OiJob::createFeatureWrapper
  * Create a feature wrapper containing a feature of the given type
@@ -2845,6 +3435,7 @@ bool OiJob::checkAndSetUpNewFeature(const QPointer<FeatureWrapper> &feature, boo
 
     //add the feature to the internal lists and maps
     this->featureContainer.addFeature(feature);
+    this->addFeatureMemoryUsage(feature);
 
     //add nominal to nominal list of coordinate system
     if(isNominal && !nominalSystem.isNull()){
@@ -3264,9 +3855,10 @@ void OiJob::addFeaturesFromXml(const QList<QPointer<FeatureWrapper> > &features)
 
         if(!feature->getStation().isNull()){
 
-            //pass job to the station system
+            //pass job to the station system (its observations were loaded without a job and are counted here)
             if(!feature->getStation()->getCoordinateSystem().isNull()){
                 feature->getStation()->getCoordinateSystem()->job = this;
+                this->addObservationMemoryUsage(feature->getStation()->getCoordinateSystem()->getObservations().size());
             }
 
             //pass the job to the station point
@@ -3290,6 +3882,7 @@ void OiJob::addFeaturesFromXml(const QList<QPointer<FeatureWrapper> > &features)
 
         //add the feature
         this->featureContainer.addFeature(feature);
+        this->addFeatureMemoryUsage(feature);
 
         //save active feature
         if(feature->getFeature()->getIsActiveFeature()){
@@ -3373,3 +3966,46 @@ void OiJob::createTemplateFromJob() {
     }
 }
 
+
+/*!
+ * \brief OiJob::getIsProfilingEnabled
+ * \return
+ */
+bool OiJob::getIsProfilingEnabled() const{
+    return Profiler::getIsEnabled();
+}
+
+/*!
+ * \brief OiJob::setIsProfilingEnabled
+ * Enables or disables the instrumentation of the hot paths (recalc, function execution, measurements, xml, sensor streams).
+ * The profile is recorded for the whole process and not only for this job
+ * \param isEnabled
+ */
+void OiJob::setIsProfilingEnabled(const bool &isEnabled){
+    Profiler::setIsEnabled(isEnabled);
+}
+
+/*!
+ * \brief OiJob::resetProfile
+ */
+void OiJob::resetProfile(){
+    Profiler::reset();
+}
+
+/*!
+ * \brief OiJob::getProfile
+ * Returns the aggregated timings and counters recorded since the last reset (see Profiler::getSummary)
+ * \return
+ */
+QJsonObject OiJob::getProfile() const{
+    return Profiler::getSummary();
+}
+
+/*!
+ * \brief OiJob::getProfileTrace
+ * Returns all events recorded since the last reset in the Chrome trace event format
+ * \return
+ */
+QJsonObject OiJob::getProfileTrace() const{
+    return Profiler::getChromeTrace();
+}
@@ -0,0 +1,780 @@
+#include "oirequestencoder.h"
+
+#include <cstring>
+
+#include <QtEndian>
+#include <qnumeric.h>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+#include "oijob.h"
+#include "featurewrapper.h"
+#include "deviationreport.h"
+
+using namespace oi;
+
+namespace{
+
+//size of the binary frame header (length, type, error, requester)
+const int frameHeaderSize = 12;
+
+//###############
+//binary encoding
+//###############
+
+inline void appendUInt8(QByteArray &data, const quint8 &value){
+    data.append((char)value);
+}
+
+inline void appendUInt16(QByteArray &data, const quint16 &value){
+    uchar bytes[2];
+    qToLittleEndian(value, bytes);
+    data.append((const char *)bytes, 2);
+}
+
+inline void appendUInt32(QByteArray &data, const quint32 &value){
+    uchar bytes[4];
+    qToLittleEndian(value, bytes);
+    data.append((const char *)bytes, 4);
+}
+
+inline void appendInt32(QByteArray &data, const qint32 &value){
+    appendUInt32(data, (quint32)value);
+}
+
+inline void appendUInt64(QByteArray &data, const quint64 &value){
+    uchar bytes[8];
+    qToLittleEndian(value, bytes);
+    data.append((const char *)bytes, 8);
+}
+
+inline void appendDouble(QByteArray &data, const double &value){
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uchar bytes[8];
+    qToLittleEndian(bits, bytes);
+    data.append((const char *)bytes, 8);
+}
+
+inline void appendString(QByteArray &data, const QString &value){
+    QByteArray utf8 = value.toUtf8();
+    int length = qMin(utf8.size(), 0xFFFF);
+    appendUInt16(data, (quint16)length);
+    data.append(utf8.constData(), length);
+}
+
+/*!
+ * \brief beginFrame
+ * Writes the frame header. The length is set by endFrame. The capacity of data is kept, so that buffers can be reused
+ * \param data
+ * \param response
+ * \param error
+ */
+void beginFrame(QByteArray &data, const OiRequestResponse &response, const OiRequestResponse::ErrorCode &error){
+    data.resize(0);
+    appendUInt32(data, 0);
+    appendUInt16(data, (quint16)response.myRequestType);
+    appendUInt16(data, (quint16)error);
+    appendInt32(data, (qint32)response.requesterId);
+}
+
+/*!
+ * \brief endFrame
+ * \param data
+ */
+void endFrame(QByteArray &data){
+    qToLittleEndian((quint32)(data.size() - 4), (uchar *)data.data());
+}
+
+//#############
+//JSON encoding
+//#############
+
+/*!
+ * \brief appendJsonString
+ * \param data
+ * \param value
+ */
+void appendJsonString(QByteArray &data, const QString &value){
+    data.append('"');
+    QByteArray utf8 = value.toUtf8();
+    for(int i = 0; i < utf8.size(); i++){
+        const char c = utf8.at(i);
+        switch(c){
+        case '"':
+            data.append("\\\"");
+            break;
+        case '\\':
+            data.append("\\\\");
+            break;
+        case '\n':
+            data.append("\\n");
+            break;
+        case '\r':
+            data.append("\\r");
+            break;
+        case '\t':
+            data.append("\\t");
+            break;
+        default:
+            if((uchar)c < 0x20){
+                data.append(QString("\\u%1").arg((int)(uchar)c, 4, 16, QChar('0')).toLatin1());
+            }else{
+                data.append(c);
+            }
+        }
+    }
+    data.append('"');
+}
+
+/*!
+ * \brief appendJsonNumber
+ * Not finite values are written as null
+ * \param data
+ * \param value
+ */
+inline void appendJsonNumber(QByteArray &data, const double &value){
+    if(qIsFinite(value)){
+        data.append(QByteArray::number(value, 'g', 17));
+    }else{
+        data.append("null");
+    }
+}
+
+inline void appendJsonBool(QByteArray &data, const bool &value){
+    data.append(value ? "true" : "false");
+}
+
+/*!
+ * \brief beginJson
+ * Writes the message attributes and opens the data member
+ * \param data
+ * \param response
+ * \param error
+ */
+void beginJson(QByteArray &data, const OiRequestResponse &response, const OiRequestResponse::ErrorCode &error){
+    data.resize(0);
+    data.append("{\"type\":");
+    data.append(QByteArray::number((int)response.myRequestType));
+    data.append(",\"error\":");
+    data.append(QByteArray::number((int)error));
+    data.append(",\"requester\":");
+    data.append(QByteArray::number(response.requesterId));
+    data.append(",\"data\":");
+}
+
+inline void endJson(QByteArray &data){
+    data.append('}');
+}
+
+//#######################################
+//payloads shared by the response writers
+//#######################################
+
+/*!
+ * \brief writeFeatures
+ * Writes the feature list of eGetFeatures (binary: count + features, JSON: array)
+ * \param data
+ * \param features
+ * \param isBinary
+ */
+void writeFeatures(QByteArray &data, const QList<QPointer<FeatureWrapper> > &features, const bool &isBinary){
+
+    if(isBinary){
+
+        appendUInt32(data, (quint32)features.size());
+        foreach(const QPointer<FeatureWrapper> &feature, features){
+
+            const QPointer<Feature> &f = feature->getFeature();
+            bool isNominal = !feature->getGeometry().isNull() && feature->getGeometry()->getIsNominal();
+            appendInt32(data, f->getId());
+            appendUInt16(data, (quint16)feature->getFeatureTypeEnum());
+            appendUInt8(data, (f->getIsSolved() ? 1 : 0) | (isNominal ? 2 : 0));
+            appendString(data, f->getFeatureName());
+
+            //parameters
+            QList<GeometryParameters> parameters = getGeometryParameters(getGeometryTypeEnum(feature->getFeatureTypeEnum()));
+            int countPosition = data.size();
+            quint8 count = 0;
+            appendUInt8(data, 0);
+            foreach(const GeometryParameters &parameter, parameters){
+                double value = 0.0;
+                if(DeviationReport::getParameterValue(feature, parameter, value)){
+                    appendUInt8(data, (quint8)parameter);
+                    appendDouble(data, value);
+                    count++;
+                }
+            }
+            data[countPosition] = (char)count;
+
+        }
+
+        return;
+
+    }
+
+    data.append('[');
+    for(int i = 0; i < features.size(); i++){
+
+        const QPointer<FeatureWrapper> &feature = features.at(i);
+        const QPointer<Feature> &f = feature->getFeature();
+        bool isNominal = !feature->getGeometry().isNull() && feature->getGeometry()->getIsNominal();
+        if(i > 0){
+            data.append(',');
+        }
+        data.append("{\"id\":");
+        data.append(QByteArray::number(f->getId()));
+        data.append(",\"name\":");
+        appendJsonString(data, f->getFeatureName());
+        data.append(",\"type\":");
+        appendJsonString(data, getFeatureTypeName(feature->getFeatureTypeEnum()));
+        data.append(",\"solved\":");
+        appendJsonBool(data, f->getIsSolved());
+        data.append(",\"nominal\":");
+        appendJsonBool(data, isNominal);
+
+        //parameters
+        data.append(",\"parameters\":{");
+        bool isFirst = true;
+        QList<GeometryParameters> parameters = getGeometryParameters(getGeometryTypeEnum(feature->getFeatureTypeEnum()));
+        foreach(const GeometryParameters &parameter, parameters){
+            double value = 0.0;
+            if(DeviationReport::getParameterValue(feature, parameter, value)){
+                if(!isFirst){
+                    data.append(',');
+                }
+                isFirst = false;
+                appendJsonString(data, getGeometryParameterName(parameter));
+                data.append(':');
+                appendJsonNumber(data, value);
+            }
+        }
+        data.append("}}");
+
+    }
+    data.append(']');
+
+}
+
+/*!
+ * \brief writeObservations
+ * Writes the observations of one geometry (binary: id + count + observations, JSON: object with id and array)
+ * \param data
+ * \param featureId
+ * \param observations
+ * \param isBinary
+ */
+void writeObservations(QByteArray &data, const int &featureId, const QList<QPointer<Observation> > &observations, const bool &isBinary){
+
+    if(isBinary){
+
+        appendInt32(data, featureId);
+        int countPosition = data.size();
+        quint32 count = 0;
+        appendUInt32(data, 0);
+        foreach(const QPointer<Observation> &observation, observations){
+            if(observation.isNull()){
+                continue;
+            }
+            const OiVec &xyz = observation->getXYZ();
+            const OiVec &sigma = observation->getSigmaXYZ();
+            appendInt32(data, observation->getId());
+            appendUInt8(data, (observation->getIsValid() ? 1 : 0) | (observation->getIsSolved() ? 2 : 0));
+            for(int k = 0; k < 3; k++){
+                appendDouble(data, xyz.getAt(k));
+            }
+            for(int k = 0; k < 3; k++){
+                appendDouble(data, sigma.getSize() > k ? sigma.getAt(k) : 0.0);
+            }
+            count++;
+        }
+        qToLittleEndian(count, (uchar *)data.data() + countPosition);
+
+        return;
+
+    }
+
+    data.append("{\"id\":");
+    data.append(QByteArray::number(featureId));
+    data.append(",\"observations\":[");
+    bool isFirst = true;
+    foreach(const QPointer<Observation> &observation, observations){
+        if(observation.isNull()){
+            continue;
+        }
+        if(!isFirst){
+            data.append(',');
+        }
+        isFirst = false;
+        const OiVec &xyz = observation->getXYZ();
+        const OiVec &sigma = observation->getSigmaXYZ();
+        data.append("{\"id\":");
+        data.append(QByteArray::number(observation->getId()));
+        data.append(",\"valid\":");
+        appendJsonBool(data, observation->getIsValid());
+        data.append(",\"solved\":");
+        appendJsonBool(data, observation->getIsSolved());
+        data.append(",\"xyz\":[");
+        for(int k = 0; k < 3; k++){
+            if(k > 0){
+                data.append(',');
+            }
+            appendJsonNumber(data, xyz.getAt(k));
+        }
+        data.append("],\"sigma\":[");
+        for(int k = 0; k < 3; k++){
+            if(k > 0){
+                data.append(',');
+            }
+            appendJsonNumber(data, sigma.getSize() > k ? sigma.getAt(k) : 0.0);
+        }
+        data.append("]}");
+    }
+    data.append("]}");
+
+}
+
+}
+
+/*!
+ * \brief OiRequestEncoder::decodeRequest
+ * Reads the request type and the requested feature ids from the JSON or binary request data
+ * \param request
+ * \param featureIds
+ * \return
+ */
+bool OiRequestEncoder::decodeRequest(OiRequestResponse &request, QList<int> &featureIds){
+    quint64 sinceSequence = 0;
+    bool isDelta = false;
+    return OiRequestEncoder::decodeRequest(request, featureIds, sinceSequence, isDelta);
+}
+
+/*!
+ * \brief OiRequestEncoder::decodeRequest
+ * Reads the request type, the requested feature ids and the change sequence of a delta request.
+ * isDelta is set if the client only asks for the changes since sinceSequence.
+ * In JSON the sequence is either a number or (above 2^53, where doubles are no longer exact) a decimal string
+ * \param request
+ * \param featureIds
+ * \param sinceSequence
+ * \param isDelta
+ * \return
+ */
+bool OiRequestEncoder::decodeRequest(OiRequestResponse &request, QList<int> &featureIds, quint64 &sinceSequence, bool &isDelta){
+
+    featureIds.clear();
+    sinceSequence = 0;
+    isDelta = false;
+
+    switch(request.encoding){
+    case OiRequestResponse::eJsonEncoding:{
+
+        QJsonParseError parseError;
+        QJsonDocument document = QJsonDocument::fromJson(request.requestData, &parseError);
+        if(parseError.error != QJsonParseError::NoError || !document.isObject()){
+            return false;
+        }
+        QJsonObject object = document.object();
+        if(!object.contains("type")){
+            return false;
+        }
+        request.myRequestType = (OiRequestResponse::RequestType)object.value("type").toInt(OiRequestResponse::eUnknownRequest);
+        if(object.contains("requester")){
+            request.requesterId = object.value("requester").toInt(request.requesterId);
+        }
+
+        QJsonValue data = object.value("data");
+        if(data.isObject()){
+            QJsonObject dataObject = data.toObject();
+            if(dataObject.contains("id")){
+                featureIds.append(dataObject.value("id").toInt());
+            }
+            foreach(const QJsonValue &id, dataObject.value("ids").toArray()){
+                featureIds.append(id.toInt());
+            }
+            if(dataObject.contains("since")){
+                QJsonValue since = dataObject.value("since");
+                bool isValid = false;
+                if(since.isString()){
+                    sinceSequence = since.toString().toULongLong(&isValid);
+                }else if(since.isDouble()){
+                    double value = since.toDouble();
+                    isValid = value >= 0.0 && value <= 9007199254740992.0 && (double)(quint64)value == value;
+                    sinceSequence = isValid ? (quint64)value : 0;
+                }
+                if(!isValid){
+                    sinceSequence = 0;
+                    return false;
+                }
+                isDelta = true;
+            }
+        }
+
+        return true;
+
+    }case OiRequestResponse::eBinaryEncoding:{
+
+        const QByteArray &data = request.requestData;
+        if(data.size() < frameHeaderSize){
+            return false;
+        }
+        const uchar *bytes = (const uchar *)data.constData();
+        quint32 length = qFromLittleEndian<quint32>(bytes);
+        if((quint64)length + 4 != (quint64)data.size()){
+            return false;
+        }
+        request.myRequestType = (OiRequestResponse::RequestType)qFromLittleEndian<quint16>(bytes + 4);
+        request.requesterId = qFromLittleEndian<qint32>(bytes + 8);
+
+        //payload (optional)
+        if(data.size() == frameHeaderSize){
+            return true;
+        }
+        if(data.size() < frameHeaderSize + 4){
+            return false;
+        }
+        quint32 count = qFromLittleEndian<quint32>(bytes + frameHeaderSize);
+        quint64 idsSize = (quint64)4 * count; //64 bit: a crafted count must not wrap around
+        quint64 payloadSize = (quint64)(data.size() - frameHeaderSize - 4);
+        if(payloadSize != idsSize && payloadSize != idsSize + 8){
+            return false;
+        }
+        featureIds.reserve(count);
+        for(quint32 i = 0; i < count; i++){
+            featureIds.append(qFromLittleEndian<qint32>(bytes + frameHeaderSize + 4 + 4 * i));
+        }
+
+        //change sequence of a delta request (optional)
+        if(payloadSize == idsSize + 8){
+            sinceSequence = qFromLittleEndian<quint64>(bytes + frameHeaderSize + 4 + idsSize);
+            isDelta = true;
+        }
+
+        return true;
+
+    }default:
+        return false;
+    }
+
+}
+
+/*!
+ * \brief OiRequestEncoder::encodeFeatures
+ * Writes the response to eGetFeatures: id, name, type, state and the unknown parameters (default units) of each feature.
+ * If no feature ids are given all features are written
+ * \param job
+ * \param request
+ * \param featureIds
+ * \return
+ */
+bool OiRequestEncoder::encodeFeatures(const QPointer<OiJob> &job, OiRequestResponse &request, const QList<int> &featureIds){
+
+    if(request.encoding == OiRequestResponse::eXmlEncoding){
+        return false;
+    }
+
+    if(job.isNull()){
+        OiRequestEncoder::encodeError(request, OiRequestResponse::eNoJob);
+        return false;
+    }
+
+    //collect features
+    QList<QPointer<FeatureWrapper> > features;
+    if(featureIds.isEmpty()){
+        features = job->getFeaturesList();
+    }else{
+        foreach(const int &id, featureIds){
+            QPointer<FeatureWrapper> feature = job->getFeatureById(id);
+            if(feature.isNull() || feature->getFeature().isNull()){
+                OiRequestEncoder::encodeError(request, OiRequestResponse::eNoFeatureWithId);
+                return false;
+            }
+            features.append(feature);
+        }
+    }
+
+    QByteArray &data = request.responseData;
+    data.reserve(64 + 96 * features.size());
+
+    if(request.encoding == OiRequestResponse::eBinaryEncoding){
+        beginFrame(data, request, OiRequestResponse::eNoError);
+        writeFeatures(data, features, true);
+        endFrame(data);
+    }else{
+        beginJson(data, request, OiRequestResponse::eNoError);
+        writeFeatures(data, features, false);
+        endJson(data);
+    }
+
+    return true;
+
+}
+
+/*!
+ * \brief OiRequestEncoder::encodeFeatureChanges
+ * Writes the delta response to eGetFeatures: the current change sequence of the job,
+ * all features that were added or changed after the given sequence and the ids of the features removed since then.
+ * A client that polls with the returned sequence only receives what has changed in between
+ * (eSequenceExpired if the removals since then are no longer tracked, see OiJob::getIsChangeTracked)
+ * \param job
+ * \param request
+ * \param sinceSequence
+ * \return
+ */
+bool OiRequestEncoder::encodeFeatureChanges(const QPointer<OiJob> &job, OiRequestResponse &request, const quint64 &sinceSequence){
+
+    if(request.encoding == OiRequestResponse::eXmlEncoding){
+        return false;
+    }
+
+    if(job.isNull()){
+        OiRequestEncoder::encodeError(request, OiRequestResponse::eNoJob);
+        return false;
+    }
+
+    //the removals since the requested sequence may have been pruned
+    if(!job->getIsChangeTracked(sinceSequence)){
+        OiRequestEncoder::encodeError(request, OiRequestResponse::eSequenceExpired);
+        return false;
+    }
+
+    //collect changes
+    QList<QPointer<FeatureWrapper> > features;
+    foreach(const int &id, job->getFeaturesChangedSince(sinceSequence)){
+        QPointer<FeatureWrapper> feature = job->getFeatureById(id);
+        if(!feature.isNull() && !feature->getFeature().isNull()){
+            features.append(feature);
+        }
+    }
+    QList<int> removedIds = job->getFeaturesRemovedSince(sinceSequence);
+
+    QByteArray &data = request.responseData;
+    data.reserve(64 + 96 * features.size() + 4 * removedIds.size());
+
+    if(request.encoding == OiRequestResponse::eBinaryEncoding){
+
+        beginFrame(data, request, OiRequestResponse::eNoError);
+        appendUInt64(data, job->getChangeSequence());
+        writeFeatures(data, features, true);
+        appendUInt32(data, (quint32)removedIds.size());
+        foreach(const int &id, removedIds){
+            appendInt32(data, id);
+        }
+        endFrame(data);
+
+    }else{
+
+        beginJson(data, request, OiRequestResponse::eNoError);
+        data.append("{\"sequence\":");
+        data.append(QByteArray::number(job->getChangeSequence()));
+        data.append(",\"features\":");
+        writeFeatures(data, features, false);
+        data.append(",\"removed\":[");
+        for(int i = 0; i < removedIds.size(); i++){
+            if(i > 0){
+                data.append(',');
+            }
+            data.append(QByteArray::number(removedIds.at(i)));
+        }
+        data.append("]}");
+        endJson(data);
+
+    }
+
+    return true;
+
+}
+
+/*!
+ * \brief OiRequestEncoder::encodeObservations
+ * Writes the response to eGetObservations: the observations of the given geometry in the current coordinate system
+ * \param job
+ * \param request
+ * \param featureId
+ * \return
+ */
+bool OiRequestEncoder::encodeObservations(const QPointer<OiJob> &job, OiRequestResponse &request, const int &featureId){
+
+    if(request.encoding == OiRequestResponse::eXmlEncoding){
+        return false;
+    }
+
+    if(job.isNull()){
+        OiRequestEncoder::encodeError(request, OiRequestResponse::eNoJob);
+        return false;
+    }
+
+    QPointer<FeatureWrapper> feature = job->getFeatureById(featureId);
+    if(feature.isNull() || feature->getGeometry().isNull()){
+        OiRequestEncoder::encodeError(request, OiRequestResponse::eNoFeatureWithId);
+        return false;
+    }
+
+    const QList<QPointer<Observation> > &observations = feature->getGeometry()->getObservations();
+
+    QByteArray &data = request.responseData;
+    data.reserve(64 + 128 * observations.size());
+
+    if(request.encoding == OiRequestResponse::eBinaryEncoding){
+        beginFrame(data, request, OiRequestResponse::eNoError);
+        writeObservations(data, featureId, observations, true);
+        endFrame(data);
+    }else{
+        beginJson(data, request, OiRequestResponse::eNoError);
+        writeObservations(data, featureId, observations, false);
+        endJson(data);
+    }
+
+    return true;
+
+}
+
+/*!
+ * \brief OiRequestEncoder::encodeObservationChanges
+ * Writes the delta response to eGetObservations: the current change sequence of the job
+ * and the observations of all geometries whose observations were added or removed after the given sequence
+ * \param job
+ * \param request
+ * \param sinceSequence
+ * \return
+ */
+bool OiRequestEncoder::encodeObservationChanges(const QPointer<OiJob> &job, OiRequestResponse &request, const quint64 &sinceSequence){
+
+    if(request.encoding == OiRequestResponse::eXmlEncoding){
+        return false;
+    }
+
+    if(job.isNull()){
+        OiRequestEncoder::encodeError(request, OiRequestResponse::eNoJob);
+        return false;
+    }
+
+    //collect changed geometries
+    QList<QPointer<FeatureWrapper> > features;
+    int numObservations = 0;
+    foreach(const int &id, job->getObservationsChangedSince(sinceSequence)){
+        QPointer<FeatureWrapper> feature = job->getFeatureById(id);
+        if(!feature.isNull() && !feature->getGeometry().isNull()){
+            features.append(feature);
+            numObservations += feature->getGeometry()->getObservations().size();
+        }
+    }
+
+    QByteArray &data = request.responseData;
+    data.reserve(64 + 16 * features.size() + 128 * numObservations);
+
+    if(request.encoding == OiRequestResponse::eBinaryEncoding){
+
+        beginFrame(data, request, OiRequestResponse::eNoError);
+        appendUInt64(data, job->getChangeSequence());
+        appendUInt32(data, (quint32)features.size());
+        foreach(const QPointer<FeatureWrapper> &feature, features){
+            writeObservations(data, feature->getGeometry()->getId(), feature->getGeometry()->getObservations(), true);
+        }
+        endFrame(data);
+
+    }else{
+
+        beginJson(data, request, OiRequestResponse::eNoError);
+        data.append("{\"sequence\":");
+        data.append(QByteArray::number(job->getChangeSequence()));
+        data.append(",\"geometries\":[");
+        for(int i = 0; i < features.size(); i++){
+            if(i > 0){
+                data.append(',');
+            }
+            writeObservations(data, features.at(i)->getGeometry()->getId(), features.at(i)->getGeometry()->getObservations(), false);
+        }
+        data.append("]}");
+        endJson(data);
+
+    }
+
+    return true;
+
+}
+
+/*!
+ * \brief OiRequestEncoder::encodeRealTimeReading
+ * Writes an eRealTimeReading message. Numeric values are written as numbers, all other values as strings
+ * \param reading
+ * \param response
+ * \return
+ */
+bool OiRequestEncoder::encodeRealTimeReading(const QVariantMap &reading, OiRequestResponse &response){
+
+    if(response.encoding == OiRequestResponse::eXmlEncoding){
+        return false;
+    }
+
+    response.myRequestType = OiRequestResponse::eRealTimeReading;
+
+    QByteArray &data = response.responseData;
+    data.reserve(32 + 48 * reading.size());
+
+    QVariantMap::const_iterator it;
+    if(response.encoding == OiRequestResponse::eBinaryEncoding){
+
+        beginFrame(data, response, OiRequestResponse::eNoError);
+        appendUInt16(data, (quint16)qMin(reading.size(), 0xFFFF));
+        int count = 0;
+        for(it = reading.constBegin(); it != reading.constEnd() && count < 0xFFFF; ++it, ++count){
+            appendString(data, it.key());
+            bool isNumber = false;
+            double value = it.value().toDouble(&isNumber);
+            if(isNumber && it.value().type() != QVariant::String){
+                appendUInt8(data, 0);
+                appendDouble(data, value);
+            }else{
+                appendUInt8(data, 1);
+                appendString(data, it.value().toString());
+            }
+        }
+        endFrame(data);
+
+    }else{
+
+        beginJson(data, response, OiRequestResponse::eNoError);
+        data.append('{');
+        for(it = reading.constBegin(); it != reading.constEnd(); ++it){
+            if(it != reading.constBegin()){
+                data.append(',');
+            }
+            appendJsonString(data, it.key());
+            data.append(':');
+            bool isNumber = false;
+            double value = it.value().toDouble(&isNumber);
+            if(isNumber && it.value().type() != QVariant::String){
+                appendJsonNumber(data, value);
+            }else{
+                appendJsonString(data, it.value().toString());
+            }
+        }
+        data.append('}');
+        endJson(data);
+
+    }
+
+    return true;
+
+}
+
+/*!
+ * \brief OiRequestEncoder::encodeError
+ * Writes a response without data
+ * \param response
+ * \param error
+ */
+void OiRequestEncoder::encodeError(OiRequestResponse &response, const OiRequestResponse::ErrorCode &error){
+
+    if(response.encoding == OiRequestResponse::eBinaryEncoding){
+        beginFrame(response.responseData, response, error);
+        endFrame(response.responseData);
+    }else if(response.encoding == OiRequestResponse::eJsonEncoding){
+        beginJson(response.responseData, response, error);
+        response.responseData.append("null");
+        endJson(response.responseData);
+    }
+
+}
@@ -0,0 +1,303 @@
+#include "asciitokenizer.h"
+
+#include <cstring>
+
+using namespace oi;
+
+namespace{
+
+//exactly representable powers of ten
+const double exactPowersOfTen[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+inline bool isWhitespace(const char &c){
+    return c == ' ' || c == '\t';
+}
+
+}
+
+/*!
+ * \brief AsciiField::toDouble
+ * \param value
+ * \return
+ */
+bool AsciiField::toDouble(double &value) const{
+    return AsciiTokenizer::parseDouble(this->begin, this->begin + this->length, value);
+}
+
+/*!
+ * \brief AsciiField::toString
+ * \return
+ */
+QString AsciiField::toString() const{
+    return QString::fromUtf8(this->begin, this->length);
+}
+
+/*!
+ * \brief AsciiTokenizer::AsciiTokenizer
+ * \param data
+ * \param size
+ * \param delimiter
+ */
+AsciiTokenizer::AsciiTokenizer(const char *data, const qint64 &size, const char &delimiter) : data(data), size(size),
+    position(0), delimiter(delimiter){
+
+    //skip UTF-8 byte order mark
+    if(this->size >= 3 && std::memcmp(this->data, "\xEF\xBB\xBF", 3) == 0){
+        this->position = 3;
+    }
+
+}
+
+/*!
+ * \brief AsciiTokenizer::nextLine
+ * Splits the next line into fields. Returns false if the end of the data has been reached
+ * \param fields
+ * \return
+ */
+bool AsciiTokenizer::nextLine(QVector<AsciiField> &fields){
+
+    fields.resize(0);
+
+    if(this->data == 0 || this->position >= this->size){
+        return false;
+    }
+
+    //find the end of the line
+    const char *lineBegin = this->data + this->position;
+    const char *dataEnd = this->data + this->size;
+    const char *lineEnd = static_cast<const char *>(std::memchr(lineBegin, '\n', dataEnd - lineBegin));
+    if(lineEnd == 0){
+        lineEnd = dataEnd;
+        this->position = this->size;
+    }else{
+        this->position = (lineEnd - this->data) + 1;
+    }
+    if(lineEnd > lineBegin && *(lineEnd - 1) == '\r'){
+        lineEnd--;
+    }
+
+    //split the line into fields
+    const char *c = lineBegin;
+    if(this->delimiter == '\0'){
+
+        //whitespace separated
+        while(c < lineEnd){
+            while(c < lineEnd && isWhitespace(*c)){
+                c++;
+            }
+            if(c == lineEnd){
+                break;
+            }
+            const char *fieldBegin = c;
+            while(c < lineEnd && !isWhitespace(*c)){
+                c++;
+            }
+            fields.append(AsciiField(fieldBegin, c - fieldBegin));
+        }
+
+    }else{
+
+        //char separated (leading and trailing whitespaces of a field are removed)
+        while(true){
+            const char *fieldEnd = static_cast<const char *>(std::memchr(c, this->delimiter, lineEnd - c));
+            if(fieldEnd == 0){
+                fieldEnd = lineEnd;
+            }
+            const char *b = c;
+            const char *e = fieldEnd;
+            while(b < e && isWhitespace(*b)){
+                b++;
+            }
+            while(e > b && isWhitespace(*(e - 1))){
+                e--;
+            }
+            fields.append(AsciiField(b, e - b));
+            if(fieldEnd == lineEnd){
+                break;
+            }
+            c = fieldEnd + 1;
+        }
+
+    }
+
+    return true;
+
+}
+
+/*!
+ * \brief AsciiTokenizer::skipLine
+ * \return
+ */
+bool AsciiTokenizer::skipLine(){
+
+    if(this->data == 0 || this->position >= this->size){
+        return false;
+    }
+
+    const char *lineBegin = this->data + this->position;
+    const char *lineEnd = static_cast<const char *>(std::memchr(lineBegin, '\n', this->size - this->position));
+    if(lineEnd == 0){
+        this->position = this->size;
+    }else{
+        this->position = (lineEnd - this->data) + 1;
+    }
+
+    return true;
+
+}
+
+/*!
+ * \brief AsciiTokenizer::getPosition
+ * Returns the number of bytes that have been processed so far
+ * \return
+ */
+const qint64 &AsciiTokenizer::getPosition() const{
+    return this->position;
+}
+
+/*!
+ * \brief AsciiTokenizer::getSize
+ * \return
+ */
+const qint64 &AsciiTokenizer::getSize() const{
+    return this->size;
+}
+
+/*!
+ * \brief AsciiTokenizer::delimiterFromString
+ * Returns the delimiter char for a delimiter description of ExchangeSimpleAscii.
+ * Descriptions like "semicolon [;]" use the char in brackets. Whitespace delimiters return '\0'
+ * \param delimiter
+ * \return
+ */
+char AsciiTokenizer::delimiterFromString(const QString &delimiter){
+
+    QString d = delimiter;
+
+    //use the char inside of brackets
+    int open = d.lastIndexOf('[');
+    int close = d.lastIndexOf(']');
+    if(open >= 0 && close == open + 2){
+        d = d.mid(open + 1, 1);
+    }
+
+    if(d.isEmpty() || d.trimmed().isEmpty() || d.compare("whitespace", Qt::CaseInsensitive) == 0
+            || d == "\\t" || d.length() != 1 || d.at(0).unicode() > 127){
+        return '\0';
+    }
+
+    return d.at(0).toLatin1();
+
+}
+
+/*!
+ * \brief AsciiTokenizer::parseDouble
+ * Locale independent conversion of a decimal number (with '.' as decimal separator).
+ * Numbers with up to 15 significant digits and a small exponent are converted exactly without any allocation,
+ * all other numbers fall back to QByteArray::toDouble
+ * \param begin
+ * \param end
+ * \param value
+ * \return
+ */
+bool AsciiTokenizer::parseDouble(const char *begin, const char *end, double &value){
+
+    const char *c = begin;
+    if(c == end){
+        return false;
+    }
+
+    //sign
+    bool negative = false;
+    if(*c == '-' || *c == '+'){
+        negative = (*c == '-');
+        c++;
+    }
+
+    //mantissa
+    quint64 mantissa = 0;
+    int significantDigits = 0;
+    int exponent = 0;
+    bool hasDigits = false;
+    while(c < end && *c >= '0' && *c <= '9'){
+        hasDigits = true;
+        if(mantissa != 0 || *c != '0'){
+            if(significantDigits < 19){
+                mantissa = mantissa * 10 + (*c - '0');
+            }else{
+                exponent++;
+            }
+            significantDigits++;
+        }
+        c++;
+    }
+    if(c < end && *c == '.'){
+        c++;
+        while(c < end && *c >= '0' && *c <= '9'){
+            hasDigits = true;
+            if(mantissa != 0 || *c != '0'){
+                if(significantDigits < 19){
+                    mantissa = mantissa * 10 + (*c - '0');
+                    exponent--;
+                }
+                significantDigits++;
+            }else{
+                exponent--;
+            }
+            c++;
+        }
+    }
+    if(!hasDigits){
+        return false;
+    }
+
+    //exponent
+    if(c < end && (*c == 'e' || *c == 'E')){
+        c++;
+        bool negativeExponent = false;
+        if(c < end && (*c == '-' || *c == '+')){
+            negativeExponent = (*c == '-');
+            c++;
+        }
+        if(c == end || *c < '0' || *c > '9'){
+            return false;
+        }
+        int e = 0;
+        while(c < end && *c >= '0' && *c <= '9'){
+            if(e < 10000){
+                e = e * 10 + (*c - '0');
+            }
+            c++;
+        }
+        exponent += negativeExponent ? -e : e;
+    }
+
+    //trailing characters are not allowed
+    if(c != end){
+        return false;
+    }
+
+    //fast path: mantissa and power of ten are exactly representable
+    if(significantDigits <= 15 && exponent >= -22 && exponent <= 22){
+        double result = static_cast<double>(mantissa);
+        if(exponent < 0){
+            result /= exactPowersOfTen[-exponent];
+        }else{
+            result *= exactPowersOfTen[exponent];
+        }
+        value = negative ? -result : result;
+        return true;
+    }
+
+    //slow path
+    bool ok = false;
+    double result = QByteArray(begin, end - begin).toDouble(&ok);
+    if(ok){
+        value = result;
+    }
+    return ok;
+
+}
@@ -41,3 +41,50 @@ const QList<ElementTypes> &ExchangeDefinedFormat::getUsedElements() const{
 void ExchangeDefinedFormat::setUsedElements(const QList<ElementTypes> &usedElementTypes){
     this->usedElementTypes = usedElementTypes;
 }
+
+/*!
+ * \brief ExchangeDefinedFormat::createExportEngine
+ * Creates an export engine with one record (feature name, x, y, z) per geometry of the used element types that has a position.
+ * The layout of a defined format is specific to the plugin, so the header and the line format are left to it (see ExportEngine::setHeader and ExportEngine::setFormatter).
+ * The geometry values are copied here, so that the engine can format and write them in a worker thread (see startAsyncExport)
+ * \return
+ */
+QPointer<ExportEngine> ExchangeDefinedFormat::createExportEngine() const{
+
+    QPointer<ExportEngine> engine = new ExportEngine();
+
+    UnitType metricUnit = this->units.value(eMetric, eUnitMeter);
+
+    //the feature name is written as string, the coordinates with the default digits of the engine
+    engine->setDelimiter(QString(" "));
+
+    //copy the geometry values
+    QVector<ExportRecord> records;
+    records.reserve(this->features.size());
+    foreach(const QPointer<FeatureWrapper> &feature, this->features){
+
+        //check feature
+        if(feature.isNull() || feature->getGeometry().isNull()
+                || !this->usedElementTypes.contains(getElementTypeEnum(feature->getFeatureTypeEnum()))){
+            continue;
+        }
+        const QPointer<Geometry> &geometry = feature->getGeometry();
+
+        //check position
+        if(!geometry->hasPosition()){
+            continue;
+        }
+
+        ExportRecord record;
+        record.fields.append(geometry->getFeatureName());
+        for(int i = 0; i < 3; i++){
+            record.fields.append(convertFromDefault(geometry->getPosition().getVector().getAt(i), metricUnit));
+        }
+        records.append(record);
+
+    }
+    engine->setRecords(records);
+
+    return engine;
+
+}
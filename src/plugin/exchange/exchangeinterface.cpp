@@ -1,12 +1,14 @@
 #include "exchangeinterface.h"
 
+#include <QFile>
+
 using namespace oi;
 
 /*!
  * \brief ExchangeInterface::ExchangeInterface
  * \param parent
  */
-ExchangeInterface::ExchangeInterface(QObject *parent) : QObject(parent){
+ExchangeInterface::ExchangeInterface(QObject *parent) : QObject(parent), mappedData(0){
 
     //init units
     this->units.insert(eMetric, eUnitMeter);
@@ -20,6 +22,18 @@ ExchangeInterface::ExchangeInterface(QObject *parent) : QObject(parent){
  */
 ExchangeInterface::~ExchangeInterface(){
 
+    //stop a running export before the device is deleted
+    if(!this->exportThread.isNull()){
+        if(!this->exportEngine.isNull()){
+            this->exportEngine->cancel();
+        }
+        this->exportThread->quit();
+        this->exportThread->wait();
+    }
+
+    //release the memory view
+    this->unmapDevice();
+
     //delete device if not deleted yet
     if(!this->device.isNull()){
         delete this->device.data();
@@ -53,10 +67,102 @@ const QPointer<QIODevice> &ExchangeInterface::getDevice() const{
 
 /*!
  * \brief ExchangeInterface::setDevice
+ * The device cannot be changed while an asynchronous export writes to it (see getIsExportRunning)
  * \param device
+ * \return
  */
-void ExchangeInterface::setDevice(const QPointer<QIODevice> &device){
+bool ExchangeInterface::setDevice(const QPointer<QIODevice> &device){
+
+    //the export engine still writes to the current device
+    if(this->getIsExportRunning()){
+        emit this->sendMessage("Cannot change the device while an export is running", eErrorMessage, eConsoleMessage);
+        return false;
+    }
+
+    this->unmapDevice();
     this->device = device;
+
+    return true;
+
+}
+
+/*!
+ * \brief ExchangeInterface::mapDevice
+ * Returns a contiguous memory view on the whole content of the device.
+ * If the device is a QFile it is memory-mapped, otherwise the data of the device is read into a buffer.
+ * In both cases the view starts at the beginning of the device, independent of its current position
+ * (sequential devices like sockets cannot seek, for them the view contains the data that is still available).
+ * The view stays valid until unmapDevice or setDevice is called
+ * \param data
+ * \param size
+ * \return
+ */
+bool ExchangeInterface::mapDevice(const char *&data, qint64 &size){
+
+    data = 0;
+    size = 0;
+
+    //check device
+    if(this->device.isNull()){
+        return false;
+    }
+    if(!this->device->isOpen() && !this->device->open(QIODevice::ReadOnly)){
+        emit this->sendMessage(QString("Cannot open device: %1").arg(this->device->errorString()), eErrorMessage, eConsoleMessage);
+        return false;
+    }
+
+    //release a previous view
+    this->unmapDevice();
+
+    //map the file
+    QFile *file = qobject_cast<QFile *>(this->device.data());
+    if(file != 0 && file->size() > 0){
+        this->mappedData = file->map(0, file->size());
+        if(this->mappedData != 0){
+            data = reinterpret_cast<const char *>(this->mappedData);
+            size = file->size();
+            return true;
+        }
+    }
+
+    //fallback: buffered read from the beginning (like the mapped file)
+    if(!this->device->isSequential() && !this->device->seek(0)){
+        emit this->sendMessage(QString("Cannot seek device: %1").arg(this->device->errorString()), eErrorMessage, eConsoleMessage);
+        return false;
+    }
+    this->deviceBuffer = this->device->readAll();
+    data = this->deviceBuffer.constData();
+    size = this->deviceBuffer.size();
+
+    return true;
+
+}
+
+/*!
+ * \brief ExchangeInterface::unmapDevice
+ * Releases the memory view created by mapDevice
+ */
+void ExchangeInterface::unmapDevice(){
+
+    if(this->mappedData != 0){
+        QFile *file = qobject_cast<QFile *>(this->device.data());
+        if(file != 0){
+            file->unmap(this->mappedData);
+        }
+        this->mappedData = 0;
+    }
+
+    this->deviceBuffer.clear();
+
+}
+
+/*!
+ * \brief ExchangeInterface::getIsDeviceMapped
+ * Returns true if the current memory view is a mapped file (no copy of the data)
+ * \return
+ */
+bool ExchangeInterface::getIsDeviceMapped() const{
+    return this->mappedData != 0;
 }
 
 /*!
@@ -140,6 +246,14 @@ void ExchangeInterface::setUnit(const DimensionType &dimension, const UnitType &
     this->units.insert(dimension, unit);
 }
 
+/*!
+ * \brief ExchangeInterface::getIsExportRunning
+ * \return
+ */
+bool ExchangeInterface::getIsExportRunning() const{
+    return !this->exportThread.isNull() && this->exportThread->isRunning();
+}
+
 /*!
  * \brief ExchangeInterface::importOiData
  */
@@ -154,6 +268,76 @@ void ExchangeInterface::exportOiData(){
     emit this->sendMessage(QString("Exchange Plugin not implemented correctly: export method missing"), eCriticalMessage, eMessageBoxMessage);
 }
 
+/*!
+ * \brief ExchangeInterface::cancelExport
+ * Cancels a running asynchronous export (exportFinished is emitted with false)
+ */
+void ExchangeInterface::cancelExport(){
+    if(!this->exportEngine.isNull()){
+        this->exportEngine->cancel();
+    }
+}
+
+/*!
+ * \brief ExchangeInterface::startAsyncExport
+ * Runs the given export engine in a worker thread, so that large exports do not block the application.
+ * Plugins create the export records from the features (job snapshot) in exportOiData and hand them over here.
+ * The engine writes to the current device and is deleted after the export has finished.
+ * \param engine
+ * \return
+ */
+bool ExchangeInterface::startAsyncExport(const QPointer<ExportEngine> &engine){
+
+    //check engine
+    if(engine.isNull()){
+        return false;
+    }
+
+    //only one export at a time
+    if(this->getIsExportRunning()){
+        emit this->sendMessage("An export is already running", eWarningMessage, eConsoleMessage);
+        delete engine.data();
+        return false;
+    }
+
+    //check device
+    if(this->device.isNull()){
+        emit this->sendMessage("No device available for the export", eErrorMessage, eConsoleMessage);
+        delete engine.data();
+        return false;
+    }
+
+    engine->setParent(0);
+    engine->setDevice(this->device);
+
+    //move the engine to its own thread
+    this->exportEngine = engine;
+    this->exportThread = new QThread();
+    engine->moveToThread(this->exportThread);
+
+    //connect engine and thread
+    QObject::connect(this->exportThread, &QThread::started, engine, &ExportEngine::run);
+    QObject::connect(engine, &ExportEngine::updateProgress, this, &ExchangeInterface::updateProgress, Qt::QueuedConnection);
+    QObject::connect(engine, &ExportEngine::sendMessage, this, &ExchangeInterface::sendMessage, Qt::QueuedConnection);
+    QObject::connect(engine, &ExportEngine::finished, this, &ExchangeInterface::asyncExportFinished, Qt::QueuedConnection);
+    QObject::connect(engine, &ExportEngine::finished, this->exportThread, &QThread::quit);
+    QObject::connect(this->exportThread, &QThread::finished, engine, &QObject::deleteLater);
+    QObject::connect(this->exportThread, &QThread::finished, this->exportThread, &QObject::deleteLater);
+
+    this->exportThread->start();
+
+    return true;
+
+}
+
+/*!
+ * \brief ExchangeInterface::asyncExportFinished
+ * \param success
+ */
+void ExchangeInterface::asyncExportFinished(const bool &success){
+    emit this->exportFinished(success);
+}
+
 /*!
  * \brief ExchangeInterface::init
  */
@@ -202,3 +202,284 @@ double ExchangeSimpleAscii::getTemperatureDigits()
 {
     return this->temperatureDigits;
 }
+
+/*!
+ * \brief ExchangeSimpleAscii::createExportEngine
+ * Creates an export engine with one record per geometry (ordered by userDefinedColumns).
+ * The geometry values are copied here, so that the engine can format and write them in a worker thread (see startAsyncExport)
+ * \return
+ */
+QPointer<ExportEngine> ExchangeSimpleAscii::createExportEngine() const{
+
+    QPointer<ExportEngine> engine = new ExportEngine();
+
+    UnitType metricUnit = this->units.value(eMetric, eUnitMeter);
+    UnitType temperatureUnit = this->units.value(eTemperature, eUnitGrad);
+
+    //set up digits (the header is left to the plugin)
+    QVector<int> digits;
+    foreach(const ExchangeSimpleAscii::ColumnType &column, this->userDefinedColumns){
+        switch(column){
+        case eColumnPrimaryI:
+        case eColumnPrimaryJ:
+        case eColumnPrimaryK:
+        case eColumnSecondaryI:
+        case eColumnSecondaryJ:
+        case eColumnSecondaryK:
+            digits.append(6);
+            break;
+        case eColumnAngle:
+        case eColumnAperture:
+            digits.append((int)this->angleDigits);
+            break;
+        case eColumnTemperature:
+            digits.append((int)this->temperatureDigits);
+            break;
+        default:
+            digits.append((int)this->distanceDigits);
+            break;
+        }
+    }
+    engine->setColumnDigits(digits);
+
+    //resolve the delimiter description like parseAsciiData does (whitespace delimiters are written as one space)
+    char delimiter = AsciiTokenizer::delimiterFromString(this->usedDelimiter);
+    engine->setDelimiter(delimiter == '\0' ? QString(" ") : QString(QChar::fromLatin1(delimiter)));
+
+    //copy the geometry values
+    QVector<ExportRecord> records;
+    records.reserve(this->features.size());
+    foreach(const QPointer<FeatureWrapper> &feature, this->features){
+
+        //check feature
+        if(feature.isNull() || feature->getGeometry().isNull()){
+            continue;
+        }
+        const QPointer<Geometry> &geometry = feature->getGeometry();
+
+        ExportRecord record;
+        foreach(const ExchangeSimpleAscii::ColumnType &column, this->userDefinedColumns){
+            switch(column){
+            case eColumnFeatureName:
+                record.fields.append(geometry->getFeatureName());
+                break;
+            case eColumnGroupName:
+                record.fields.append(geometry->getGroupName());
+                break;
+            case eColumnComment:
+                record.fields.append(geometry->getComment());
+                break;
+            case eColumnX:
+            case eColumnY:
+            case eColumnZ:
+                if(geometry->hasPosition()){
+                    record.fields.append(convertFromDefault(geometry->getPosition().getVector().getAt(column - eColumnX), metricUnit));
+                }else{
+                    record.fields.append(QString());
+                }
+                break;
+            case eColumnPrimaryI:
+            case eColumnPrimaryJ:
+            case eColumnPrimaryK:
+                if(geometry->hasDirection()){
+                    record.fields.append(geometry->getDirection().getVector().getAt(column - eColumnPrimaryI));
+                }else{
+                    record.fields.append(QString());
+                }
+                break;
+            case eColumnRadiusA:
+                if(geometry->hasRadius()){
+                    record.fields.append(convertFromDefault(geometry->getRadius().getRadius(), metricUnit));
+                }else{
+                    record.fields.append(QString());
+                }
+                break;
+            case eColumnTemperature:
+                if(feature->getScalarEntityTemperature().isNull()){
+                    record.fields.append(QString());
+                }else{
+                    record.fields.append(convertFromDefault(feature->getScalarEntityTemperature()->getTemperature(), temperatureUnit));
+                }
+                break;
+            case eColumnCommonState:
+                record.fields.append(geometry->getIsCommon() ? QString("1") : QString("0"));
+                break;
+            default:
+                record.fields.append(QString());
+                break;
+            }
+        }
+        records.append(record);
+
+    }
+    engine->setRecords(records);
+
+    return engine;
+
+}
+
+/*!
+ * \brief ExchangeSimpleAscii::parseAsciiData
+ * Reads the device line by line and calls the row handler for each line (the first line is skipped if skipFirstLine is true).
+ * The lines are tokenized on the memory view of the device (see mapDevice) without copying them. The columns are assigned by userDefinedColumns.
+ * Parsing stops as soon as the row handler returns false
+ * \param rowHandler
+ * \return
+ */
+bool ExchangeSimpleAscii::parseAsciiData(const std::function<bool(const SimpleAsciiRow &row)> &rowHandler){
+
+    //get a memory view on the device
+    const char *data = 0;
+    qint64 size = 0;
+    if(!this->mapDevice(data, size)){
+        if(this->getDevice().isNull()){ //other errors are reported by mapDevice
+            emit this->sendMessage("No device available for the import", eErrorMessage, eConsoleMessage);
+        }
+        return false;
+    }
+
+    //set up column assignment
+    SimpleAsciiRow row;
+    row.columnIndices.fill(-1, eColumnCommonState + 1);
+    row.columnUnits.fill(-1, eColumnCommonState + 1);
+    for(int i = 0; i < this->userDefinedColumns.size(); i++){
+        ExchangeSimpleAscii::ColumnType column = this->userDefinedColumns.at(i);
+        if(column != eColumnIgnore && row.columnIndices.at(column) < 0){
+            row.columnIndices[column] = i;
+        }
+        switch(column){
+        case eColumnX:
+        case eColumnY:
+        case eColumnZ:
+        case eColumnRadiusA:
+        case eColumnRadiusB:
+        case eColumnA:
+        case eColumnB:
+        case eColumnC:
+        case eColumnDistance:
+        case eColumnLength:
+            row.columnUnits[column] = this->units.value(eMetric, eUnitMeter);
+            break;
+        case eColumnAperture:
+        case eColumnAngle:
+            row.columnUnits[column] = this->units.value(eAngular, eUnitDecimalDegree);
+            break;
+        case eColumnTemperature:
+            row.columnUnits[column] = this->units.value(eTemperature, eUnitGrad);
+            break;
+        default:
+            break;
+        }
+    }
+
+    //tokenize lines
+    AsciiTokenizer tokenizer(data, size, AsciiTokenizer::delimiterFromString(this->usedDelimiter));
+    row.lineNumber = 0;
+    if(this->skipFirstLine && tokenizer.skipLine()){
+        row.lineNumber++;
+    }
+
+    bool success = true;
+    int lastProgress = -1;
+    while(tokenizer.nextLine(row.fields)){
+
+        row.lineNumber++;
+
+        //skip empty lines
+        if(row.fields.isEmpty() || (row.fields.size() == 1 && row.fields.at(0).isEmpty())){
+            continue;
+        }
+
+        if(!rowHandler(row)){
+            success = false;
+            break;
+        }
+
+        //report progress
+        int progress = size > 0 ? (int)(100 * tokenizer.getPosition() / size) : 100;
+        if(progress != lastProgress){
+            lastProgress = progress;
+            emit this->updateProgress(progress, QString("%1 lines read").arg(row.lineNumber));
+        }
+
+    }
+
+    this->unmapDevice();
+
+    return success;
+
+}
+
+/*!
+ * \brief SimpleAsciiRow::SimpleAsciiRow
+ */
+SimpleAsciiRow::SimpleAsciiRow() : lineNumber(0){
+
+}
+
+/*!
+ * \brief SimpleAsciiRow::hasColumn
+ * Returns true if the column is available and not empty in this line
+ * \param column
+ * \return
+ */
+bool SimpleAsciiRow::hasColumn(const ExchangeSimpleAscii::ColumnType &column) const{
+    int index = this->columnIndices.value(column, -1);
+    return index >= 0 && index < this->fields.size() && !this->fields.at(index).isEmpty();
+}
+
+/*!
+ * \brief SimpleAsciiRow::getValue
+ * Returns the value of the given column converted to the default unit
+ * \param column
+ * \param value
+ * \return
+ */
+bool SimpleAsciiRow::getValue(const ExchangeSimpleAscii::ColumnType &column, double &value) const{
+
+    //check column
+    if(!this->hasColumn(column)){
+        return false;
+    }
+
+    if(!this->fields.at(this->columnIndices.at(column)).toDouble(value)){
+        return false;
+    }
+
+    //convert to default unit
+    int unit = this->columnUnits.at(column);
+    if(unit >= 0){
+        value = convertToDefault(value, (UnitType)unit);
+    }
+
+    return true;
+
+}
+
+/*!
+ * \brief SimpleAsciiRow::getText
+ * \param column
+ * \return
+ */
+QString SimpleAsciiRow::getText(const ExchangeSimpleAscii::ColumnType &column) const{
+    if(!this->hasColumn(column)){
+        return QString();
+    }
+    return this->fields.at(this->columnIndices.at(column)).toString();
+}
+
+/*!
+ * \brief SimpleAsciiRow::getFields
+ * \return
+ */
+const QVector<AsciiField> &SimpleAsciiRow::getFields() const{
+    return this->fields;
+}
+
+/*!
+ * \brief SimpleAsciiRow::getLineNumber
+ * \return
+ */
+const int &SimpleAsciiRow::getLineNumber() const{
+    return this->lineNumber;
+}
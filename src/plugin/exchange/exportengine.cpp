@@ -0,0 +1,370 @@
+#include "exportengine.h"
+
+#include <QtConcurrent>
+#include <QElapsedTimer>
+#include <QThread>
+
+using namespace oi;
+
+/*!
+ * \brief ExportEngine::ExportEngine
+ * \param parent
+ */
+ExportEngine::ExportEngine(QObject *parent) : QObject(parent), delimiter(" "), chunkSize(4096),
+    bufferSize(4 * 1024 * 1024), isCanceled(0), bytesWritten(0){
+
+    //messages are sent across threads
+    qRegisterMetaType<MessageTypes>("MessageTypes");
+    qRegisterMetaType<MessageDestinations>("MessageDestinations");
+
+}
+
+/*!
+ * \brief ExportEngine::~ExportEngine
+ */
+ExportEngine::~ExportEngine(){
+
+}
+
+/*!
+ * \brief ExportEngine::getDevice
+ * \return
+ */
+const QPointer<QIODevice> &ExportEngine::getDevice() const{
+    return this->device;
+}
+
+/*!
+ * \brief ExportEngine::setDevice
+ * The device must not be accessed by anyone else while the export is running
+ * \param device
+ */
+void ExportEngine::setDevice(const QPointer<QIODevice> &device){
+    this->device = device;
+}
+
+/*!
+ * \brief ExportEngine::getRecords
+ * \return
+ */
+const QVector<ExportRecord> &ExportEngine::getRecords() const{
+    return this->records;
+}
+
+/*!
+ * \brief ExportEngine::setRecords
+ * \param records
+ */
+void ExportEngine::setRecords(const QVector<ExportRecord> &records){
+    this->records = records;
+}
+
+/*!
+ * \brief ExportEngine::getHeader
+ * \return
+ */
+const QByteArray &ExportEngine::getHeader() const{
+    return this->header;
+}
+
+/*!
+ * \brief ExportEngine::setHeader
+ * Set a header that is written before the first record (no line break is added)
+ * \param header
+ */
+void ExportEngine::setHeader(const QByteArray &header){
+    this->header = header;
+}
+
+/*!
+ * \brief ExportEngine::getDelimiter
+ * \return
+ */
+const QString &ExportEngine::getDelimiter() const{
+    return this->delimiter;
+}
+
+/*!
+ * \brief ExportEngine::setDelimiter
+ * \param delimiter
+ */
+void ExportEngine::setDelimiter(const QString &delimiter){
+    this->delimiter = delimiter;
+}
+
+/*!
+ * \brief ExportEngine::getColumnDigits
+ * \return
+ */
+const QVector<int> &ExportEngine::getColumnDigits() const{
+    return this->columnDigits;
+}
+
+/*!
+ * \brief ExportEngine::setColumnDigits
+ * Set the number of digits for each column (columns without an entry are written with 6 digits)
+ * \param digits
+ */
+void ExportEngine::setColumnDigits(const QVector<int> &digits){
+    this->columnDigits = digits;
+}
+
+/*!
+ * \brief ExportEngine::setFormatter
+ * Replace the default delimiter separated formatting by a custom one (must be thread-safe)
+ * \param formatter
+ */
+void ExportEngine::setFormatter(const RecordFormatter &formatter){
+    this->formatter = formatter;
+}
+
+/*!
+ * \brief ExportEngine::getChunkSize
+ * \return
+ */
+const int &ExportEngine::getChunkSize() const{
+    return this->chunkSize;
+}
+
+/*!
+ * \brief ExportEngine::setChunkSize
+ * \param chunkSize
+ */
+void ExportEngine::setChunkSize(const int &chunkSize){
+    if(chunkSize > 0){
+        this->chunkSize = chunkSize;
+    }
+}
+
+/*!
+ * \brief ExportEngine::getBufferSize
+ * \return
+ */
+const int &ExportEngine::getBufferSize() const{
+    return this->bufferSize;
+}
+
+/*!
+ * \brief ExportEngine::setBufferSize
+ * \param bufferSize
+ */
+void ExportEngine::setBufferSize(const int &bufferSize){
+    if(bufferSize > 0){
+        this->bufferSize = bufferSize;
+    }
+}
+
+/*!
+ * \brief ExportEngine::getIsCanceled
+ * \return
+ */
+bool ExportEngine::getIsCanceled() const{
+    return this->isCanceled.load() != 0;
+}
+
+/*!
+ * \brief ExportEngine::getBytesWritten
+ * \return
+ */
+const qint64 &ExportEngine::getBytesWritten() const{
+    return this->bytesWritten;
+}
+
+/*!
+ * \brief ExportEngine::run
+ * Formats the records in batches of parallel chunks. While one batch is written to the device
+ * the next batch is already being formatted, so that formatting and I/O overlap.
+ */
+void ExportEngine::run(){
+
+    this->bytesWritten = 0;
+
+    //check device
+    if(this->device.isNull() || !this->device->isWritable()){
+        emit this->sendMessage("Export device is not writable", eErrorMessage, eConsoleMessage);
+        emit this->finished(false);
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QByteArray buffer;
+    buffer.reserve(this->bufferSize);
+    buffer.append(this->header);
+
+    //split records into chunks and chunks into batches (one chunk per thread)
+    int numRecords = this->records.size();
+    int numChunks = (numRecords + this->chunkSize - 1) / this->chunkSize;
+    int batchSize = qMax(1, QThread::idealThreadCount());
+
+    std::function<QByteArray(const int &)> formatChunk = [this](const int &chunk){
+        return this->formatChunk(chunk);
+    };
+
+    //start formatting the first batch
+    int nextChunk = 0;
+    QList<int> batch;
+    for(; nextChunk < numChunks && batch.size() < batchSize; nextChunk++){
+        batch.append(nextChunk);
+    }
+    QFuture<QByteArray> current = QtConcurrent::mapped(batch, formatChunk);
+
+    int writtenChunks = 0;
+    while(writtenChunks < numChunks){
+
+        //start formatting the next batch
+        batch.clear();
+        for(; nextChunk < numChunks && batch.size() < batchSize; nextChunk++){
+            batch.append(nextChunk);
+        }
+        QFuture<QByteArray> next;
+        if(!batch.isEmpty()){
+            next = QtConcurrent::mapped(batch, formatChunk);
+        }
+
+        //write the results of the current batch in order
+        current.waitForFinished();
+        int numResults = current.resultCount();
+        for(int i = 0; i < numResults; i++){
+            buffer.append(current.resultAt(i));
+            if(buffer.size() >= this->bufferSize && !this->flush(buffer)){
+                next.waitForFinished();
+                emit this->finished(false);
+                return;
+            }
+        }
+        writtenChunks += numResults;
+
+        //check cancellation
+        if(this->getIsCanceled()){
+            next.cancel();
+            next.waitForFinished();
+            this->flush(buffer);
+            emit this->sendMessage("Export canceled by user", eWarningMessage, eConsoleMessage);
+            emit this->finished(false);
+            return;
+        }
+
+        //report progress and throughput
+        int exportedRecords = qMin(writtenChunks * this->chunkSize, numRecords);
+        double seconds = qMax(timer.elapsed(), (qint64)1) / 1000.0;
+        double mbPerSecond = (this->bytesWritten + buffer.size()) / (1024.0 * 1024.0) / seconds;
+        emit this->updateProgress(numRecords > 0 ? (int)(100.0 * exportedRecords / numRecords) : 100,
+                                  QString("%1 of %2 records exported (%3 MB/s)").arg(exportedRecords)
+                                  .arg(numRecords).arg(mbPerSecond, 0, 'f', 1));
+
+        current = next;
+
+    }
+
+    //write remaining bytes
+    if(!this->flush(buffer)){
+        emit this->finished(false);
+        return;
+    }
+
+    emit this->updateProgress(100, QString("%1 records exported").arg(numRecords));
+    emit this->finished(true);
+
+}
+
+/*!
+ * \brief ExportEngine::cancel
+ * Can be called from any thread. The export stops after the batch that is currently written
+ */
+void ExportEngine::cancel(){
+    this->isCanceled.store(1);
+}
+
+/*!
+ * \brief ExportEngine::formatChunk
+ * \param chunk
+ * \return
+ */
+QByteArray ExportEngine::formatChunk(const int &chunk) const{
+
+    QByteArray result;
+
+    //skip work if the export was canceled
+    if(this->getIsCanceled()){
+        return result;
+    }
+
+    int begin = chunk * this->chunkSize;
+    int end = qMin(begin + this->chunkSize, this->records.size());
+    for(int i = begin; i < end; i++){
+        if(this->formatter){
+            result.append(this->formatter(this->records.at(i)));
+        }else{
+            result.append(this->formatRecord(this->records.at(i)));
+        }
+    }
+
+    return result;
+
+}
+
+/*!
+ * \brief ExportEngine::formatRecord
+ * Default formatting: delimiter separated fields, doubles are written with the column digits
+ * \param record
+ * \return
+ */
+QByteArray ExportEngine::formatRecord(const ExportRecord &record) const{
+
+    QByteArray line;
+    QByteArray delimiter = this->delimiter.toUtf8();
+
+    for(int i = 0; i < record.fields.size(); i++){
+
+        if(i > 0){
+            line.append(delimiter);
+        }
+
+        const QVariant &field = record.fields.at(i);
+        if(field.type() == QVariant::Double){
+            int digits = i < this->columnDigits.size() ? this->columnDigits.at(i) : 6;
+            line.append(QByteArray::number(field.toDouble(), 'f', digits));
+        }else{
+            line.append(field.toString().toUtf8());
+        }
+
+    }
+    line.append('\n');
+
+    return line;
+
+}
+
+/*!
+ * \brief ExportEngine::flush
+ * Writes the buffer to the device and clears it afterwards
+ * \param buffer
+ * \return
+ */
+bool ExportEngine::flush(QByteArray &buffer){
+
+    if(buffer.isEmpty()){
+        return true;
+    }
+
+    //check device
+    if(this->device.isNull()){
+        emit this->sendMessage("Export device has been deleted while exporting", eErrorMessage, eConsoleMessage);
+        return false;
+    }
+
+    qint64 written = this->device->write(buffer);
+    if(written != buffer.size()){
+        emit this->sendMessage(QString("Error while writing export data: %1").arg(this->device->errorString()),
+                               eErrorMessage, eConsoleMessage);
+        return false;
+    }
+
+    this->bytesWritten += written;
+    buffer.truncate(0);
+
+    return true;
+
+}
@@ -1,5 +1,7 @@
 #include "function.h"
 
+#include "oijob.h"
+
 using namespace oi;
 
 /*!
@@ -15,7 +17,7 @@ Function::Function(QObject *parent) : QObject(parent){
  * \brief Function::~Function
  */
 Function::~Function(){
-
+    this->setJob(QPointer<OiJob>());
 }
 
 /*!
@@ -214,6 +216,22 @@ const Statistic &Function::getStatistic() const{
     return this->statistic;
 }
 
+/*!
+ * \brief Function::getExecutionStatistic
+ * Returns the number and the duration of the executions of this function (see FunctionExecutionStatistic)
+ * \return
+ */
+const FunctionExecutionStatistic &Function::getExecutionStatistic() const{
+    return this->executionStatistic;
+}
+
+/*!
+ * \brief Function::resetExecutionStatistic
+ */
+void Function::resetExecutionStatistic(){
+    this->executionStatistic = FunctionExecutionStatistic();
+}
+
 /*!
  * \brief Function::getId
  * \return
@@ -324,6 +342,11 @@ void Function::addInputElement(const InputElement &element, const int &position)
         this->inputElements.insert(position, elements);
     }
 
+    //update the memory usage of the job
+    if(!this->job.isNull()){
+        this->job->addInputElementMemoryUsage(1);
+    }
+
     emit this->inputElementsChanged();
 
 }
@@ -335,7 +358,9 @@ void Function::addInputElement(const InputElement &element, const int &position)
  */
 void Function::removeInputElement(const int &id, const int &position){
     if(this->inputElements.contains(position)){
-        this->inputElements[position].removeOne(InputElement(id));
+        if(this->inputElements[position].removeOne(InputElement(id)) && !this->job.isNull()){
+            this->job->addInputElementMemoryUsage(-1);
+        }
         emit this->inputElementsChanged();
     }
 }
@@ -346,7 +371,9 @@ void Function::removeInputElement(const int &id, const int &position){
  */
 void Function::removeInputElement(const int &id){
     for(int i = 0; i < this->inputElements.size(); i++){
-        this->inputElements[i].removeOne(InputElement(id));
+        if(this->inputElements[i].removeOne(InputElement(id)) && !this->job.isNull()){
+            this->job->addInputElementMemoryUsage(-1);
+        }
         emit this->inputElementsChanged();
     }
 }
@@ -427,6 +454,9 @@ void Function::setShouldBeUsed(const int &position, const int &id, const bool &s
  * \brief Function::clear
  */
 void Function::clear(){
+    if(!this->job.isNull()){
+        this->job->addInputElementMemoryUsage(-this->getNumInputElements());
+    }
     this->inputElements.clear();
     this->fixedParameters.clear();
     this->scalarInputParams.isValid = false;
@@ -450,6 +480,7 @@ void Function::clearResults(){
     foreach(const int &key, keys){
         for(int i = 0; i < this->inputElements[key].size(); ++i){
             this->inputElements[key][i].isUsed = false;
+            this->inputElements[key][i].weight = 1.0;
         }
     }
 
@@ -852,6 +883,31 @@ void Function::setIsUsed(const int &position, const int &id, const bool &state){
 
 }
 
+/*!
+ * \brief Function::setWeights
+ * Writes the weights of many elements at position in one pass (e.g. the result of a robust fit).
+ * Elements with a weight of 0 are marked as not used, elements without a weight are not changed
+ * \param position
+ * \param weights element id -> weight
+ */
+void Function::setWeights(const int &position, const QHash<int, double> &weights){
+
+    if(!this->inputElements.contains(position)){
+        return;
+    }
+
+    QList<InputElement> &elements = this->inputElements[position];
+    for(int i = 0; i < elements.size(); i++){
+        QHash<int, double>::const_iterator weight = weights.constFind(elements.at(i).id);
+        if(weight == weights.constEnd()){
+            continue;
+        }
+        elements[i].weight = weight.value();
+        elements[i].isUsed = elements.at(i).shouldBeUsed && weight.value() > 0.0;
+    }
+
+}
+
 void Function::filterObservations(QList<QPointer<Observation> > &allUsableObservations, QList<QPointer<Observation> > &inputObservations) {
     foreach(const InputElement &element, this->getInputElements()[0]){
         if(!element.observation.isNull()
@@ -900,3 +956,87 @@ void Function::addDisplayResidual(int elementId, double vx, double vy, double vz
     residual.corrections.insert(getObservationDisplayAttributesName(eObservationDisplayVK), vk);
     this->statistic.addDisplayResidual(residual);
 }
+
+/*!
+ * \brief Function::setIterations
+ * Iterative functions report the iterations of the current execution
+ * \param numIterations
+ * \param maxIterations
+ * \param isConverged
+ */
+void Function::setIterations(const int &numIterations, const int &maxIterations, const bool &isConverged){
+    this->executionStatistic.numIterations = numIterations;
+    this->executionStatistic.maxIterations = maxIterations;
+    this->executionStatistic.isConverged = isConverged;
+}
+
+/*!
+ * \brief Function::startExecution
+ * Resets the values of the last execution
+ */
+void Function::startExecution(){
+
+    this->executionStatistic.numIterations = -1;
+    this->executionStatistic.maxIterations = -1;
+    this->executionStatistic.isConverged = false;
+
+    this->executionStatistic.numInputElements = this->getNumInputElements();
+
+}
+
+/*!
+ * \brief Function::finishExecution
+ * \param time
+ * \param isSolved
+ */
+void Function::finishExecution(const qint64 &time, const bool &isSolved){
+
+    this->executionStatistic.numExecutions++;
+    this->executionStatistic.lastTime = time;
+    this->executionStatistic.totalTime += time;
+    if(time > this->executionStatistic.maxTime){
+        this->executionStatistic.maxTime = time;
+    }
+    this->executionStatistic.isSolved = isSolved;
+
+    //functions without iterations converged if they solved the feature
+    if(this->executionStatistic.numIterations < 0){
+        this->executionStatistic.isConverged = isSolved;
+    }
+
+}
+
+/*!
+ * \brief Function::setJob
+ * Moves the input elements of this function to the memory usage of the given job
+ * \param job
+ */
+void Function::setJob(const QPointer<OiJob> &job){
+
+    if(this->job == job){
+        return;
+    }
+
+    int numInputElements = this->getNumInputElements();
+    if(!this->job.isNull()){
+        this->job->addInputElementMemoryUsage(-numInputElements);
+    }
+    this->job = job;
+    if(!this->job.isNull()){
+        this->job->addInputElementMemoryUsage(numInputElements);
+    }
+
+}
+
+/*!
+ * \brief Function::getNumInputElements
+ * \return
+ */
+int Function::getNumInputElements() const{
+    int numInputElements = 0;
+    QMap<int, QList<InputElement> >::const_iterator it;
+    for(it = this->inputElements.constBegin(); it != this->inputElements.constEnd(); ++it){
+        numInputElements += it.value().size();
+    }
+    return numInputElements;
+}
@@ -199,6 +199,7 @@ const QList<BundleTransformation> &BundleAdjustment::getOutputTransformations()
  */
 void BundleAdjustment::clear(){
     this->scalarInputParams.isValid = false;
+    this->bundleEngine.clearPreviousSolution();
     this->stations.clear();
     this->baseSystem = BundleStation();
     this->clearResults();
@@ -495,6 +496,111 @@ bool BundleAdjustment::fromOpenIndyXML(QDomElement &xmlElem){
 
 }
 
+/*!
+ * \brief BundleAdjustment::solveStationNetwork
+ * Solves the input stations with the sparse bundle engine and writes the output geometries and transformations.
+ * Bundle plugins may call this method in runBundle instead of setting up their own normal equations
+ * \return
+ */
+bool BundleAdjustment::solveStationNetwork(){
+    return this->solveStationNetwork(BundleInput::fromStations(this->stations, this->baseSystem));
+}
+
+/*!
+ * \brief BundleAdjustment::solveStationNetwork
+ * Solves a flat bundle input (e.g. created by createBundleInput) with the sparse bundle engine
+ * \param input
+ * \return
+ */
+bool BundleAdjustment::solveStationNetwork(const BundleInput &input){
+
+    this->clearResults();
+
+    if(!this->bundleEngine.solve(input, this->geometries, this->transformations)){
+        emit this->sendMessage(QString("Bundle \"%1\" failed: %2").arg(this->getMetaData().name)
+                               .arg(this->bundleEngine.getErrorMessage()), eErrorMessage, eMessageBoxMessage);
+        this->clearResults();
+        return false;
+    }
+
+    emit this->sendMessage(QString("Bundle \"%1\" converged after %2 iterations (sigma0 = %3, redundancy = %4)")
+                           .arg(this->getMetaData().name).arg(this->bundleEngine.getIterations())
+                           .arg(this->bundleEngine.getSigma0()).arg(this->bundleEngine.getRedundancy()),
+                           eInformationMessage, eConsoleMessage);
+
+    return true;
+
+}
+
+/*!
+ * \brief BundleAdjustment::createBundleInput
+ * Builds the flat bundle input directly from the observations of the current job without creating BundleGeometry objects.
+ * All valid observations of common points in the system of each input station are used (original station coordinates).
+ * The free parameters of each station are taken from the input stations
+ * \param input
+ * \return
+ */
+bool BundleAdjustment::createBundleInput(BundleInput &input) const{
+
+    input.clear();
+
+    //check job
+    if(this->currentJob.isNull()){
+        return false;
+    }
+
+    //the base station is always the first station
+    QList<BundleStation> inputStations;
+    inputStations.append(this->baseSystem);
+    foreach(const BundleStation &station, this->stations){
+        if(station.id != this->baseSystem.id){
+            inputStations.append(station);
+        }
+    }
+
+    //count observations
+    int numObservations = 0;
+    const QList<QPointer<Station> > &jobStations = this->currentJob->getStationsList();
+    foreach(const QPointer<Station> &station, jobStations){
+        if(!station.isNull() && !station->getCoordinateSystem().isNull()){
+            numObservations += station->getCoordinateSystem()->getObservations().size();
+        }
+    }
+    input.reserve(inputStations.size(), this->currentJob->getGeometriesList().size(), numObservations);
+
+    foreach(const BundleStation &bundleStation, inputStations){
+
+        //get station
+        QPointer<FeatureWrapper> feature = this->currentJob->getFeatureById(bundleStation.id);
+        if(feature.isNull() || feature->getStation().isNull() || feature->getStation()->getCoordinateSystem().isNull()){
+            continue;
+        }
+        int stationIndex = input.addStation(bundleStation.id, BundleInput::getFreeParameters(bundleStation));
+
+        //add observations of common points
+        foreach(const QPointer<Observation> &observation, feature->getStation()->getCoordinateSystem()->getObservations()){
+            if(observation.isNull() || !observation->getIsValid()){
+                continue;
+            }
+            const OiVec &xyz = observation->getOriginalXYZ();
+            foreach(const QPointer<Geometry> &geometry, observation->getTargetGeometries()){
+                if(geometry.isNull() || !geometry->getIsCommon() || geometry->getFeatureWrapper().isNull()
+                        || geometry->getFeatureWrapper()->getFeatureTypeEnum() != ePointFeature){
+                    continue;
+                }
+                input.addObservation(stationIndex, input.addGeometry(geometry->getId()), xyz.getAt(0), xyz.getAt(1), xyz.getAt(2));
+            }
+        }
+
+    }
+
+    input.setBaseStation(input.getStationIndex(this->baseSystem.id));
+    input.updateParameterOffsets();
+
+    return input.getBaseStation() >= 0 && input.getNumObservations() > 0;
+
+}
+
 /*!
  * \brief BundleAdjustment::connectJob
  */
@@ -508,6 +614,12 @@ void BundleAdjustment::connectJob(){
     QObject::connect(this, &BundleAdjustment::sendMessage,
                      this->currentJob, &OiJob::sendMessage, Qt::AutoConnection);
 
+    //changed stations are resected again by the next warm started solve
+    QObject::connect(this->currentJob, &OiJob::systemObservationsChanged,
+                     this, &BundleAdjustment::systemObservationsChanged, Qt::AutoConnection);
+    QObject::connect(this->currentJob, &OiJob::stationSensorChanged,
+                     this, &BundleAdjustment::stationSensorChanged, Qt::AutoConnection);
+
 }
 
 /*!
@@ -522,5 +634,45 @@ void BundleAdjustment::disconnectJob(){
 
     QObject::disconnect(this, &BundleAdjustment::sendMessage,
                         this->currentJob, &OiJob::sendMessage);
+    QObject::disconnect(this->currentJob, &OiJob::systemObservationsChanged,
+                        this, &BundleAdjustment::systemObservationsChanged);
+    QObject::disconnect(this->currentJob, &OiJob::stationSensorChanged,
+                        this, &BundleAdjustment::stationSensorChanged);
+
+}
 
+/*!
+ * \brief BundleAdjustment::systemObservationsChanged
+ * Marks the station of a changed station system as outdated, so that the next solve resects it again
+ * \param featureId
+ * \param obsId
+ */
+void BundleAdjustment::systemObservationsChanged(const int &featureId, const int &obsId){
+
+    Q_UNUSED(obsId);
+
+    //check job
+    if(this->currentJob.isNull()){
+        return;
+    }
+
+    //get station of the system
+    QPointer<FeatureWrapper> feature = this->currentJob->getFeatureById(featureId);
+    if(feature.isNull() || feature->getCoordinateSystem().isNull()
+            || !feature->getCoordinateSystem()->getIsStationSystem()
+            || feature->getCoordinateSystem()->getStation().isNull()){
+        return;
+    }
+
+    this->bundleEngine.invalidateStation(feature->getCoordinateSystem()->getStation()->getId());
+
+}
+
+/*!
+ * \brief BundleAdjustment::stationSensorChanged
+ * A new sensor usually means a new station setup
+ * \param featureId
+ */
+void BundleAdjustment::stationSensorChanged(const int &featureId){
+    this->bundleEngine.invalidateStation(featureId);
 }
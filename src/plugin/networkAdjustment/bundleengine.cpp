@@ -0,0 +1,1080 @@
+#include "bundleengine.h"
+
+#include <QtCore/qmath.h>
+
+#include "bundleadjustment.h"
+
+using namespace oi;
+
+namespace{
+
+/*!
+ * \brief rotationMatrices
+ * Sets up the rotation matrix R = Rz * Ry * Rx (convention of TrafoParam) and its derivatives with respect to rx, ry and rz
+ * \param rx
+ * \param ry
+ * \param rz
+ * \param r
+ * \param drx
+ * \param dry
+ * \param drz
+ */
+void rotationMatrices(const double &rx, const double &ry, const double &rz,
+                      double r[9], double drx[9], double dry[9], double drz[9]){
+
+    double sx = qSin(rx), cx = qCos(rx);
+    double sy = qSin(ry), cy = qCos(ry);
+    double sz = qSin(rz), cz = qCos(rz);
+
+    //single rotations and their derivatives
+    const double X[9] = {1.0, 0.0, 0.0, 0.0, cx, sx, 0.0, -sx, cx};
+    const double dX[9] = {0.0, 0.0, 0.0, 0.0, -sx, cx, 0.0, -cx, -sx};
+    const double Y[9] = {cy, 0.0, -sy, 0.0, 1.0, 0.0, sy, 0.0, cy};
+    const double dY[9] = {-sy, 0.0, -cy, 0.0, 0.0, 0.0, cy, 0.0, -sy};
+    const double Z[9] = {cz, sz, 0.0, -sz, cz, 0.0, 0.0, 0.0, 1.0};
+    const double dZ[9] = {-sz, cz, 0.0, -cz, -sz, 0.0, 0.0, 0.0, 0.0};
+
+    auto mul = [](const double a[9], const double b[9], double c[9]){
+        for(int i = 0; i < 3; i++){
+            for(int j = 0; j < 3; j++){
+                c[i*3+j] = a[i*3] * b[j] + a[i*3+1] * b[3+j] + a[i*3+2] * b[6+j];
+            }
+        }
+    };
+
+    double zy[9], t[9];
+    mul(Z, Y, zy);
+    mul(zy, X, r);
+    mul(zy, dX, drx);
+    mul(Z, dY, t);
+    mul(t, X, dry);
+    mul(dZ, Y, t);
+    mul(t, X, drz);
+
+}
+
+/*!
+ * \brief largestEigenvector
+ * Cyclic Jacobi method for the eigenvector of the largest eigenvalue of a symmetric 4x4 matrix
+ * \param a
+ * \param v
+ */
+void largestEigenvector(double a[16], double v[4]){
+
+    double e[16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1};
+
+    for(int sweep = 0; sweep < 50; sweep++){
+
+        double off = 0.0;
+        for(int p = 0; p < 4; p++){
+            for(int q = p + 1; q < 4; q++){
+                off += a[p*4+q] * a[p*4+q];
+            }
+        }
+        if(off < 1e-30){
+            break;
+        }
+
+        for(int p = 0; p < 4; p++){
+            for(int q = p + 1; q < 4; q++){
+                if(qAbs(a[p*4+q]) < 1e-300){
+                    continue;
+                }
+                double theta = (a[q*4+q] - a[p*4+p]) / (2.0 * a[p*4+q]);
+                double t = (theta >= 0.0 ? 1.0 : -1.0) / (qAbs(theta) + qSqrt(theta * theta + 1.0));
+                double c = 1.0 / qSqrt(t * t + 1.0);
+                double s = t * c;
+                for(int k = 0; k < 4; k++){
+                    double akp = a[k*4+p], akq = a[k*4+q];
+                    a[k*4+p] = c * akp - s * akq;
+                    a[k*4+q] = s * akp + c * akq;
+                }
+                for(int k = 0; k < 4; k++){
+                    double apk = a[p*4+k], aqk = a[q*4+k];
+                    a[p*4+k] = c * apk - s * aqk;
+                    a[q*4+k] = s * apk + c * aqk;
+                }
+                for(int k = 0; k < 4; k++){
+                    double ekp = e[k*4+p], ekq = e[k*4+q];
+                    e[k*4+p] = c * ekp - s * ekq;
+                    e[k*4+q] = s * ekp + c * ekq;
+                }
+            }
+        }
+
+    }
+
+    int best = 0;
+    for(int i = 1; i < 4; i++){
+        if(a[i*4+i] > a[best*4+best]){
+            best = i;
+        }
+    }
+    for(int k = 0; k < 4; k++){
+        v[k] = e[k*4+best];
+    }
+
+}
+
+/*!
+ * \brief similarityTransformation
+ * Closed form similarity transformation (Horn) dst = t + m * R * src. The result is written as tx, ty, tz, rx, ry, rz, m
+ * \param src
+ * \param dst
+ * \param params
+ * \return
+ */
+bool similarityTransformation(const QVector<double> &src, const QVector<double> &dst, double params[7]){
+
+    int n = src.size() / 3;
+    if(n < 3){
+        return false;
+    }
+
+    //centroids
+    double cs[3] = {0.0, 0.0, 0.0}, cd[3] = {0.0, 0.0, 0.0};
+    for(int i = 0; i < n; i++){
+        for(int k = 0; k < 3; k++){
+            cs[k] += src[i*3+k] / n;
+            cd[k] += dst[i*3+k] / n;
+        }
+    }
+
+    //cross covariance and scale
+    double s[9] = {0,0,0, 0,0,0, 0,0,0};
+    double ss = 0.0, sd = 0.0;
+    for(int i = 0; i < n; i++){
+        double a[3], b[3];
+        for(int k = 0; k < 3; k++){
+            a[k] = src[i*3+k] - cs[k];
+            b[k] = dst[i*3+k] - cd[k];
+            ss += a[k] * a[k];
+            sd += b[k] * b[k];
+        }
+        for(int j = 0; j < 3; j++){
+            for(int k = 0; k < 3; k++){
+                s[j*3+k] += a[j] * b[k];
+            }
+        }
+    }
+    if(ss <= 0.0){
+        return false;
+    }
+
+    //quaternion of the rotation
+    double sxx = s[0], sxy = s[1], sxz = s[2], syx = s[3], syy = s[4], syz = s[5], szx = s[6], szy = s[7], szz = s[8];
+    double nq[16] = {sxx + syy + szz, syz - szy, szx - sxz, sxy - syx,
+                     syz - szy, sxx - syy - szz, sxy + syx, szx + sxz,
+                     szx - sxz, sxy + syx, -sxx + syy - szz, syz + szy,
+                     sxy - syx, szx + sxz, syz + szy, -sxx - syy + szz};
+    double q[4];
+    largestEigenvector(nq, q);
+    double q0 = q[0], qx = q[1], qy = q[2], qz = q[3];
+
+    double r[9] = {q0*q0 + qx*qx - qy*qy - qz*qz, 2.0 * (qx*qy - q0*qz), 2.0 * (qx*qz + q0*qy),
+                   2.0 * (qy*qx + q0*qz), q0*q0 - qx*qx + qy*qy - qz*qz, 2.0 * (qy*qz - q0*qx),
+                   2.0 * (qz*qx - q0*qy), 2.0 * (qz*qy + q0*qx), q0*q0 - qx*qx - qy*qy + qz*qz};
+
+    double m = qSqrt(sd / ss);
+
+    //angles (R = Rz * Ry * Rx)
+    params[3] = qAtan2(-r[7], r[8]);
+    params[4] = qAsin(qBound(-1.0, r[6], 1.0));
+    params[5] = qAtan2(-r[3], r[0]);
+    params[6] = m;
+
+    //translation
+    for(int k = 0; k < 3; k++){
+        params[k] = cd[k] - m * (r[k*3] * cs[0] + r[k*3+1] * cs[1] + r[k*3+2] * cs[2]);
+    }
+
+    return true;
+
+}
+
+/*!
+ * \brief transformPoint
+ * \param params
+ * \param x
+ * \param result
+ */
+void transformPoint(const double params[7], const double x[3], double result[3]){
+    double r[9], d[9];
+    rotationMatrices(params[3], params[4], params[5], r, d, d, d);
+    for(int k = 0; k < 3; k++){
+        result[k] = params[k] + params[6] * (r[k*3] * x[0] + r[k*3+1] * x[1] + r[k*3+2] * x[2]);
+    }
+}
+
+}
+
+/*!
+ * \brief BundleEngine::BundleEngine
+ */
+BundleEngine::BundleEngine() : maxIterations(50), convergenceThreshold(1e-10), baseStation(-1), isWarmStartEnabled(true),
+    previousBaseStation(-1), iterations(0), sigma0(0.0), redundancy(0){
+
+}
+
+/*!
+ * \brief BundleEngine::getMaxIterations
+ * \return
+ */
+const int &BundleEngine::getMaxIterations() const{
+    return this->maxIterations;
+}
+
+/*!
+ * \brief BundleEngine::setMaxIterations
+ * \param maxIterations
+ */
+void BundleEngine::setMaxIterations(const int &maxIterations){
+    if(maxIterations > 0){
+        this->maxIterations = maxIterations;
+    }
+}
+
+/*!
+ * \brief BundleEngine::getConvergenceThreshold
+ * \return
+ */
+const double &BundleEngine::getConvergenceThreshold() const{
+    return this->convergenceThreshold;
+}
+
+/*!
+ * \brief BundleEngine::setConvergenceThreshold
+ * Iterations stop if the largest correction is smaller than the threshold
+ * \param threshold
+ */
+void BundleEngine::setConvergenceThreshold(const double &threshold){
+    if(threshold > 0.0){
+        this->convergenceThreshold = threshold;
+    }
+}
+
+/*!
+ * \brief BundleEngine::getIsWarmStartEnabled
+ * \return
+ */
+const bool &BundleEngine::getIsWarmStartEnabled() const{
+    return this->isWarmStartEnabled;
+}
+
+/*!
+ * \brief BundleEngine::setIsWarmStartEnabled
+ * If enabled, each solution is kept and used as approximation of the next solve.
+ * New stations and stations with changed observations are resected against the known points
+ * \param enabled
+ */
+void BundleEngine::setIsWarmStartEnabled(const bool &enabled){
+    this->isWarmStartEnabled = enabled;
+    if(!enabled){
+        this->clearPreviousSolution();
+    }
+}
+
+/*!
+ * \brief BundleEngine::getHasPreviousSolution
+ * \return
+ */
+bool BundleEngine::getHasPreviousSolution() const{
+    return this->previousBaseStation >= 0;
+}
+
+/*!
+ * \brief BundleEngine::invalidateStation
+ * Marks the previous parameters of a station as outdated (e.g. the station has been set up again or its observations changed)
+ * \param id
+ */
+void BundleEngine::invalidateStation(const int &id){
+    this->dirtyStations.insert(id);
+}
+
+/*!
+ * \brief BundleEngine::clearPreviousSolution
+ */
+void BundleEngine::clearPreviousSolution(){
+    this->previousStations.clear();
+    this->previousPoints.clear();
+    this->dirtyStations.clear();
+    this->previousBaseStation = -1;
+}
+
+/*!
+ * \brief BundleEngine::solve
+ * Solves the station network. The input geometries of each station need the parameters eUnknownX, eUnknownY and eUnknownZ.
+ * geometries receives the adjusted points in the bundle system, transformations the parameters of each station
+ * \param stations
+ * \param baseStation
+ * \param geometries
+ * \param transformations
+ * \return
+ */
+bool BundleEngine::solve(const QList<BundleStation> &stations, const BundleStation &baseStation,
+                         QList<BundleGeometry> &geometries, QList<BundleTransformation> &transformations){
+    return this->solve(BundleInput::fromStations(stations, baseStation), geometries, transformations);
+}
+
+/*!
+ * \brief BundleEngine::solve
+ * Solves the station network of a flat bundle input (see BundleInput).
+ * geometries receives the adjusted points in the bundle system, transformations the parameters of each station
+ * \param input
+ * \param geometries
+ * \param transformations
+ * \return
+ */
+bool BundleEngine::solve(const BundleInput &input, QList<BundleGeometry> &geometries, QList<BundleTransformation> &transformations){
+
+    this->errorMessage.clear();
+    this->iterations = 0;
+    this->sigma0 = 0.0;
+    this->redundancy = 0;
+
+    //set up flat problem and approximations
+    if(!this->setUpProblem(input) || !this->approximate()){
+        return false;
+    }
+
+    //Gauss-Newton iterations
+    double maxCorrection = 0.0;
+    do{
+        if(!this->iterate(maxCorrection)){
+            return false;
+        }
+        this->iterations++;
+    }while(maxCorrection > this->convergenceThreshold && this->iterations < this->maxIterations);
+
+    if(maxCorrection > this->convergenceThreshold){
+        this->errorMessage = QString("Bundle did not converge after %1 iterations").arg(this->iterations);
+        return false;
+    }
+
+    this->computeResults(geometries, transformations);
+    this->storeSolution();
+
+    return true;
+
+}
+
+/*!
+ * \brief BundleEngine::getErrorMessage
+ * \return
+ */
+const QString &BundleEngine::getErrorMessage() const{
+    return this->errorMessage;
+}
+
+/*!
+ * \brief BundleEngine::getIterations
+ * \return
+ */
+const int &BundleEngine::getIterations() const{
+    return this->iterations;
+}
+
+/*!
+ * \brief BundleEngine::getSigma0
+ * \return
+ */
+const double &BundleEngine::getSigma0() const{
+    return this->sigma0;
+}
+
+/*!
+ * \brief BundleEngine::getRedundancy
+ * \return
+ */
+const int &BundleEngine::getRedundancy() const{
+    return this->redundancy;
+}
+
+/*!
+ * \brief BundleEngine::setUpProblem
+ * Copies the station parameters and the observations of the flat input
+ * \param input
+ * \return
+ */
+bool BundleEngine::setUpProblem(const BundleInput &input){
+
+    this->stations.clear();
+    this->points.clear();
+    this->observations.clear();
+    this->pointObservations.clear();
+
+    if(input.getBaseStation() < 0){
+        this->errorMessage = "No base station for bundle adjustment";
+        return false;
+    }
+    this->baseStation = input.getBaseStation();
+
+    //set up stations (the base station is fixed)
+    int offset = 0;
+    this->stations.reserve(input.getNumStations());
+    for(int i = 0; i < input.getNumStations(); i++){
+        Station station;
+        station.id = input.stationIds.at(i);
+        bool isBase = (i == input.getBaseStation());
+        quint8 free = input.stationFreeParameters.at(i);
+        station.size = 0;
+        for(int k = 0; k < 7; k++){
+            station.isFree[k] = !isBase && ((free >> k) & 1);
+            station.params[k] = (k == 6) ? 1.0 : 0.0;
+            station.size += station.isFree[k] ? 1 : 0;
+        }
+        station.offset = offset;
+        station.isApproximated = isBase;
+        offset += station.size;
+        this->stations.append(station);
+    }
+
+    //set up points
+    this->points.reserve(input.getNumGeometries());
+    for(int i = 0; i < input.getNumGeometries(); i++){
+        Point point;
+        point.id = input.geometryIds.at(i);
+        point.xyz[0] = point.xyz[1] = point.xyz[2] = 0.0;
+        point.isApproximated = false;
+        this->points.append(point);
+    }
+    this->pointObservations.resize(input.getNumGeometries());
+
+    //set up observations
+    this->observations.reserve(input.getNumObservations());
+    const double *values = input.observationValues.constData();
+    for(int i = 0; i < input.getNumObservations(); i++){
+        Observation observation;
+        observation.station = input.observationStations.at(i);
+        observation.point = input.observationGeometries.at(i);
+        observation.xyz[0] = values[i*3];
+        observation.xyz[1] = values[i*3+1];
+        observation.xyz[2] = values[i*3+2];
+        this->pointObservations[observation.point].append(i);
+        this->observations.append(observation);
+    }
+
+    if(this->observations.isEmpty()){
+        this->errorMessage = "No observations for bundle adjustment";
+        return false;
+    }
+
+    return true;
+
+}
+
+/*!
+ * \brief BundleEngine::approximate
+ * Computes approximations for all stations and points that have not been approximated yet.
+ * Stations are added one after another by a closed form similarity transformation on at least three known points.
+ * Stations with less than three common points (e.g. all of their observations were removed) are rejected
+ * \return
+ */
+bool BundleEngine::approximate(){
+
+    //each station needs at least three points that are also observed by another station
+    //(otherwise its normal equations are singular, even if it had parameters in the previous solution)
+    QVector<int> numCommonPoints(this->stations.size(), 0);
+    QVector<int> pointStations;
+    for(int p = 0; p < this->points.size(); p++){
+        pointStations.clear();
+        foreach(const int &i, this->pointObservations.at(p)){
+            int s = this->observations.at(i).station;
+            if(!pointStations.contains(s)){
+                pointStations.append(s);
+            }
+        }
+        if(pointStations.size() < 2){
+            continue;
+        }
+        foreach(const int &s, pointStations){
+            numCommonPoints[s]++;
+        }
+    }
+    for(int s = 0; s < this->stations.size(); s++){
+        if(s != this->baseStation && numCommonPoints.at(s) < 3){
+            this->errorMessage = QString("Station %1 has less than three common points").arg(this->stations.at(s).id);
+            return false;
+        }
+    }
+
+    //warm start from the previous solution (stations with changed observations are resected again)
+    if(this->isWarmStartEnabled && this->previousBaseStation >= 0
+            && this->previousBaseStation == this->stations.at(this->baseStation).id){
+        for(int s = 0; s < this->stations.size(); s++){
+            Station &station = this->stations[s];
+            if(station.isApproximated || this->dirtyStations.contains(station.id)
+                    || !this->previousStations.contains(station.id)){
+                continue;
+            }
+            const QVector<double> &params = this->previousStations[station.id];
+            for(int k = 0; k < 7; k++){
+                if(station.isFree[k]){
+                    station.params[k] = params.at(k);
+                }
+            }
+            station.isApproximated = true;
+        }
+        for(int p = 0; p < this->points.size(); p++){
+            Point &point = this->points[p];
+            if(!this->previousPoints.contains(point.id)){
+                continue;
+            }
+            const QVector<double> &xyz = this->previousPoints[point.id];
+            point.xyz[0] = xyz.at(0);
+            point.xyz[1] = xyz.at(1);
+            point.xyz[2] = xyz.at(2);
+            point.isApproximated = true;
+        }
+    }
+
+    //points of the approximated stations
+    for(int i = 0; i < this->observations.size(); i++){
+        const Observation &observation = this->observations.at(i);
+        const Station &station = this->stations.at(observation.station);
+        Point &point = this->points[observation.point];
+        if(station.isApproximated && !point.isApproximated){
+            transformPoint(station.params, observation.xyz, point.xyz);
+            point.isApproximated = true;
+        }
+    }
+
+    //stations
+    bool added = true;
+    while(added){
+
+        added = false;
+
+        for(int s = 0; s < this->stations.size(); s++){
+
+            Station &station = this->stations[s];
+            if(station.isApproximated){
+                continue;
+            }
+
+            //collect common points
+            QVector<double> src, dst;
+            for(int i = 0; i < this->observations.size(); i++){
+                const Observation &observation = this->observations.at(i);
+                const Point &point = this->points.at(observation.point);
+                if(observation.station == s && point.isApproximated){
+                    for(int k = 0; k < 3; k++){
+                        src.append(observation.xyz[k]);
+                        dst.append(point.xyz[k]);
+                    }
+                }
+            }
+
+            //compute approximation (fixed parameters keep their default values)
+            double params[7];
+            if(!similarityTransformation(src, dst, params)){
+                continue;
+            }
+            for(int k = 0; k < 7; k++){
+                if(station.isFree[k]){
+                    station.params[k] = params[k];
+                }
+            }
+            station.isApproximated = true;
+            added = true;
+
+            //approximate new points
+            for(int i = 0; i < this->observations.size(); i++){
+                const Observation &observation = this->observations.at(i);
+                Point &point = this->points[observation.point];
+                if(observation.station == s && !point.isApproximated){
+                    transformPoint(station.params, observation.xyz, point.xyz);
+                    point.isApproximated = true;
+                }
+            }
+
+        }
+
+    }
+
+    //check that all stations are connected (changed stations that cannot be resected keep their previous parameters)
+    for(int s = 0; s < this->stations.size(); s++){
+        Station &station = this->stations[s];
+        if(!station.isApproximated && this->isWarmStartEnabled && this->previousStations.contains(station.id)){
+            const QVector<double> &params = this->previousStations[station.id];
+            for(int k = 0; k < 7; k++){
+                if(station.isFree[k]){
+                    station.params[k] = params.at(k);
+                }
+            }
+            station.isApproximated = true;
+        }
+        if(!station.isApproximated){
+            this->errorMessage = QString("Station %1 has less than three common points").arg(station.id);
+            return false;
+        }
+    }
+
+    return true;
+
+}
+
+/*!
+ * \brief BundleEngine::iterate
+ * One Gauss-Newton iteration: sets up the reduced normal equations of the stations, solves them and updates stations and points
+ * \param maxCorrection
+ * \return
+ */
+bool BundleEngine::iterate(double &maxCorrection){
+
+    maxCorrection = 0.0;
+
+    int numStations = this->stations.size();
+    int numObservations = this->observations.size();
+
+    //rotation matrices of all stations
+    QVector<double> rotations(numStations * 36);
+    for(int s = 0; s < numStations; s++){
+        const Station &station = this->stations.at(s);
+        double *r = rotations.data() + s * 36;
+        rotationMatrices(station.params[3], station.params[4], station.params[5], r, r + 9, r + 18, r + 27);
+    }
+
+    //station jacobians (3 x 7) and misclosures of all observations
+    QVector<double> jacobians(numObservations * 21);
+    QVector<double> misclosures(numObservations * 3);
+    for(int i = 0; i < numObservations; i++){
+
+        const Observation &observation = this->observations.at(i);
+        const Station &station = this->stations.at(observation.station);
+        const Point &point = this->points.at(observation.point);
+        const double *r = rotations.constData() + observation.station * 36;
+        const double *x = observation.xyz;
+        double m = station.params[6];
+        double *j = jacobians.data() + i * 21;
+
+        for(int k = 0; k < 3; k++){
+            double rx = r[k*3] * x[0] + r[k*3+1] * x[1] + r[k*3+2] * x[2];
+            misclosures[i*3+k] = station.params[k] + m * rx - point.xyz[k];
+
+            j[k*7] = (k == 0) ? 1.0 : 0.0;
+            j[k*7+1] = (k == 1) ? 1.0 : 0.0;
+            j[k*7+2] = (k == 2) ? 1.0 : 0.0;
+            for(int a = 0; a < 3; a++){
+                const double *dr = r + 9 * (a + 1);
+                j[k*7+3+a] = m * (dr[k*3] * x[0] + dr[k*3+1] * x[1] + dr[k*3+2] * x[2]);
+            }
+            j[k*7+6] = rx;
+        }
+
+    }
+
+    //reduced normal equations: blocks of the lower triangle (empty = zero block)
+    QVector<QVector<double> > blocks(numStations * numStations);
+    QVector<double> rhs(this->stations.isEmpty() ? 0 : this->stations.last().offset + this->stations.last().size, 0.0);
+
+    //station diagonal blocks U_s and right hand side -J_s^T * f
+    for(int i = 0; i < numObservations; i++){
+        const Observation &observation = this->observations.at(i);
+        const Station &station = this->stations.at(observation.station);
+        if(station.size == 0){
+            continue;
+        }
+        QVector<double> &block = blocks[observation.station * numStations + observation.station];
+        if(block.isEmpty()){
+            block.fill(0.0, station.size * station.size);
+        }
+        const double *j = jacobians.constData() + i * 21;
+        int a = 0;
+        for(int pa = 0; pa < 7; pa++){
+            if(!station.isFree[pa]){
+                continue;
+            }
+            int b = 0;
+            for(int pb = 0; pb < 7; pb++){
+                if(!station.isFree[pb]){
+                    continue;
+                }
+                block[a * station.size + b] += j[pa] * j[pb] + j[7+pa] * j[7+pb] + j[14+pa] * j[14+pb];
+                b++;
+            }
+            rhs[station.offset + a] -= j[pa] * misclosures[i*3] + j[7+pa] * misclosures[i*3+1] + j[14+pa] * misclosures[i*3+2];
+            a++;
+        }
+    }
+
+    //eliminate points: S -= W_a * W_b^T / v, e -= W_a * b_p / v with W = -J_s^T, v = number of observations, b_p = sum f
+    //(the point jacobian is -I)
+    QVector<double> pointRhs(this->points.size() * 3, 0.0);
+    for(int p = 0; p < this->points.size(); p++){
+
+        const QVector<int> &obs = this->pointObservations.at(p);
+        double v = obs.size();
+        double *bp = pointRhs.data() + p * 3;
+        foreach(const int &i, obs){
+            for(int k = 0; k < 3; k++){
+                bp[k] += misclosures[i*3+k];
+            }
+        }
+
+        for(int ia = 0; ia < obs.size(); ia++){
+
+            const Observation &oa = this->observations.at(obs.at(ia));
+            const Station &sa = this->stations.at(oa.station);
+            if(sa.size == 0){
+                continue;
+            }
+            const double *ja = jacobians.constData() + obs.at(ia) * 21;
+
+            //right hand side
+            int a = 0;
+            for(int pa = 0; pa < 7; pa++){
+                if(!sa.isFree[pa]){
+                    continue;
+                }
+                rhs[sa.offset + a] += (ja[pa] * bp[0] + ja[7+pa] * bp[1] + ja[14+pa] * bp[2]) / v;
+                a++;
+            }
+
+            //station blocks (lower triangle)
+            for(int ib = 0; ib < obs.size(); ib++){
+
+                const Observation &ob = this->observations.at(obs.at(ib));
+                const Station &sb = this->stations.at(ob.station);
+                if(sb.size == 0 || ob.station > oa.station){
+                    continue;
+                }
+                const double *jb = jacobians.constData() + obs.at(ib) * 21;
+
+                QVector<double> &block = blocks[oa.station * numStations + ob.station];
+                if(block.isEmpty()){
+                    block.fill(0.0, sa.size * sb.size);
+                }
+                a = 0;
+                for(int pa = 0; pa < 7; pa++){
+                    if(!sa.isFree[pa]){
+                        continue;
+                    }
+                    int b = 0;
+                    for(int pb = 0; pb < 7; pb++){
+                        if(!sb.isFree[pb]){
+                            continue;
+                        }
+                        block[a * sb.size + b] -= (ja[pa] * jb[pb] + ja[7+pa] * jb[7+pb] + ja[14+pa] * jb[14+pb]) / v;
+                        b++;
+                    }
+                    a++;
+                }
+
+            }
+
+        }
+
+    }
+
+    //solve reduced system
+    if(!this->factorize(numStations, blocks)){
+        this->errorMessage = "Normal equation matrix of the stations is singular (datum defect or too few common points)";
+        return false;
+    }
+    QVector<double> dx = rhs;
+    this->solveFactorized(numStations, blocks, dx);
+
+    //update stations
+    for(int s = 0; s < numStations; s++){
+        Station &station = this->stations[s];
+        int a = 0;
+        for(int k = 0; k < 7; k++){
+            if(station.isFree[k]){
+                station.params[k] += dx[station.offset + a];
+                maxCorrection = qMax(maxCorrection, qAbs(dx[station.offset + a]));
+                a++;
+            }
+        }
+    }
+
+    //back substitution of the points: dX = (b_p + sum J_s * ds) / v
+    for(int p = 0; p < this->points.size(); p++){
+        const QVector<int> &obs = this->pointObservations.at(p);
+        double v = obs.size();
+        double correction[3] = {pointRhs[p*3], pointRhs[p*3+1], pointRhs[p*3+2]};
+        foreach(const int &i, obs){
+            const Station &station = this->stations.at(this->observations.at(i).station);
+            const double *j = jacobians.constData() + i * 21;
+            int a = 0;
+            for(int k = 0; k < 7; k++){
+                if(station.isFree[k]){
+                    double d = dx[station.offset + a];
+                    correction[0] += j[k] * d;
+                    correction[1] += j[7+k] * d;
+                    correction[2] += j[14+k] * d;
+                    a++;
+                }
+            }
+        }
+        for(int k = 0; k < 3; k++){
+            this->points[p].xyz[k] += correction[k] / v;
+            maxCorrection = qMax(maxCorrection, qAbs(correction[k] / v));
+        }
+    }
+
+    return true;
+
+}
+
+/*!
+ * \brief BundleEngine::computeResults
+ * \param geometries
+ * \param transformations
+ */
+void BundleEngine::computeResults(QList<BundleGeometry> &geometries, QList<BundleTransformation> &transformations){
+
+    geometries.clear();
+    transformations.clear();
+
+    //residuals
+    double vtv = 0.0;
+    foreach(const Observation &observation, this->observations){
+        const Point &point = this->points.at(observation.point);
+        double x[3];
+        transformPoint(this->stations.at(observation.station).params, observation.xyz, x);
+        for(int k = 0; k < 3; k++){
+            vtv += (x[k] - point.xyz[k]) * (x[k] - point.xyz[k]);
+        }
+    }
+    int numUnknowns = this->points.size() * 3;
+    foreach(const Station &station, this->stations){
+        numUnknowns += station.size;
+    }
+    this->redundancy = this->observations.size() * 3 - numUnknowns;
+    this->sigma0 = this->redundancy > 0 ? qSqrt(vtv / this->redundancy) : 0.0;
+
+    //geometries
+    foreach(const Point &point, this->points){
+        BundleGeometry geometry;
+        geometry.id = point.id;
+        geometry.parameters.insert(eUnknownX, point.xyz[0]);
+        geometry.parameters.insert(eUnknownY, point.xyz[1]);
+        geometry.parameters.insert(eUnknownZ, point.xyz[2]);
+        geometries.append(geometry);
+    }
+
+    //transformations
+    foreach(const Station &station, this->stations){
+        BundleTransformation transformation;
+        transformation.id = station.id;
+        transformation.parameters.insert(eUnknownTX, station.params[0]);
+        transformation.parameters.insert(eUnknownTY, station.params[1]);
+        transformation.parameters.insert(eUnknownTZ, station.params[2]);
+        transformation.parameters.insert(eUnknownRX, station.params[3]);
+        transformation.parameters.insert(eUnknownRY, station.params[4]);
+        transformation.parameters.insert(eUnknownRZ, station.params[5]);
+        transformation.parameters.insert(eUnknownSX, station.params[6]);
+        transformation.parameters.insert(eUnknownSY, station.params[6]);
+        transformation.parameters.insert(eUnknownSZ, station.params[6]);
+        transformations.append(transformation);
+    }
+
+}
+
+/*!
+ * \brief BundleEngine::storeSolution
+ * Keeps the current solution for the next warm start
+ */
+void BundleEngine::storeSolution(){
+
+    if(!this->isWarmStartEnabled){
+        return;
+    }
+
+    this->previousStations.clear();
+    this->previousPoints.clear();
+    this->dirtyStations.clear();
+
+    foreach(const Station &station, this->stations){
+        QVector<double> params(7);
+        for(int k = 0; k < 7; k++){
+            params[k] = station.params[k];
+        }
+        this->previousStations.insert(station.id, params);
+    }
+    foreach(const Point &point, this->points){
+        QVector<double> xyz(3);
+        xyz[0] = point.xyz[0];
+        xyz[1] = point.xyz[1];
+        xyz[2] = point.xyz[2];
+        this->previousPoints.insert(point.id, xyz);
+    }
+    this->previousBaseStation = this->stations.at(this->baseStation).id;
+
+}
+
+/*!
+ * \brief BundleEngine::factorize
+ * Block-sparse Cholesky factorization (lower triangle) of the reduced station system.
+ * Blocks that are zero and stay zero during the factorization are never allocated
+ * \param numStations
+ * \param blocks
+ * \return
+ */
+bool BundleEngine::factorize(const int &numStations, QVector<QVector<double> > &blocks) const{
+
+    for(int j = 0; j < numStations; j++){
+
+        int nj = this->stations.at(j).size;
+        if(nj == 0){
+            continue;
+        }
+
+        //diagonal block: A_jj - sum L_jk * L_jk^T
+        QVector<double> &ljj = blocks[j * numStations + j];
+        for(int k = 0; k < j; k++){
+            const QVector<double> &ljk = blocks.at(j * numStations + k);
+            if(ljk.isEmpty()){
+                continue;
+            }
+            int nk = this->stations.at(k).size;
+            for(int a = 0; a < nj; a++){
+                for(int b = 0; b <= a; b++){
+                    double sum = 0.0;
+                    for(int c = 0; c < nk; c++){
+                        sum += ljk[a * nk + c] * ljk[b * nk + c];
+                    }
+                    ljj[a * nj + b] -= sum;
+                }
+            }
+        }
+
+        //dense Cholesky of the diagonal block
+        for(int a = 0; a < nj; a++){
+            for(int b = 0; b <= a; b++){
+                double sum = ljj[a * nj + b];
+                for(int c = 0; c < b; c++){
+                    sum -= ljj[a * nj + c] * ljj[b * nj + c];
+                }
+                if(a == b){
+                    if(sum <= 0.0){
+                        return false;
+                    }
+                    ljj[a * nj + a] = qSqrt(sum);
+                }else{
+                    ljj[a * nj + b] = sum / ljj[b * nj + b];
+                }
+            }
+            for(int b = a + 1; b < nj; b++){
+                ljj[a * nj + b] = 0.0;
+            }
+        }
+
+        //off diagonal blocks: L_ij = (A_ij - sum L_ik * L_jk^T) * L_jj^-T
+        for(int i = j + 1; i < numStations; i++){
+
+            int ni = this->stations.at(i).size;
+            if(ni == 0){
+                continue;
+            }
+
+            QVector<double> &lij = blocks[i * numStations + j];
+            for(int k = 0; k < j; k++){
+                const QVector<double> &lik = blocks.at(i * numStations + k);
+                const QVector<double> &ljk = blocks.at(j * numStations + k);
+                if(lik.isEmpty() || ljk.isEmpty()){
+                    continue;
+                }
+                if(lij.isEmpty()){
+                    lij.fill(0.0, ni * nj); //fill-in
+                }
+                int nk = this->stations.at(k).size;
+                for(int a = 0; a < ni; a++){
+                    for(int b = 0; b < nj; b++){
+                        double sum = 0.0;
+                        for(int c = 0; c < nk; c++){
+                            sum += lik[a * nk + c] * ljk[b * nk + c];
+                        }
+                        lij[a * nj + b] -= sum;
+                    }
+                }
+            }
+            if(lij.isEmpty()){
+                continue;
+            }
+
+            for(int a = 0; a < ni; a++){
+                for(int b = 0; b < nj; b++){
+                    double sum = lij[a * nj + b];
+                    for(int c = 0; c < b; c++){
+                        sum -= lij[a * nj + c] * ljj[b * nj + c];
+                    }
+                    lij[a * nj + b] = sum / ljj[b * nj + b];
+                }
+            }
+
+        }
+
+    }
+
+    return true;
+
+}
+
+/*!
+ * \brief BundleEngine::solveFactorized
+ * Solves L * L^T * x = b with the block factor of factorize (b is overwritten with x)
+ * \param numStations
+ * \param blocks
+ * \param x
+ */
+void BundleEngine::solveFactorized(const int &numStations, const QVector<QVector<double> > &blocks, QVector<double> &x) const{
+
+    //forward substitution L * y = b
+    for(int i = 0; i < numStations; i++){
+        const Station &si = this->stations.at(i);
+        int ni = si.size;
+        if(ni == 0){
+            continue;
+        }
+        for(int k = 0; k < i; k++){
+            const QVector<double> &lik = blocks.at(i * numStations + k);
+            if(lik.isEmpty()){
+                continue;
+            }
+            const Station &sk = this->stations.at(k);
+            for(int a = 0; a < ni; a++){
+                for(int c = 0; c < sk.size; c++){
+                    x[si.offset + a] -= lik[a * sk.size + c] * x[sk.offset + c];
+                }
+            }
+        }
+        const QVector<double> &lii = blocks.at(i * numStations + i);
+        for(int a = 0; a < ni; a++){
+            for(int c = 0; c < a; c++){
+                x[si.offset + a] -= lii[a * ni + c] * x[si.offset + c];
+            }
+            x[si.offset + a] /= lii[a * ni + a];
+        }
+    }
+
+    //backward substitution L^T * x = y
+    for(int i = numStations - 1; i >= 0; i--){
+        const Station &si = this->stations.at(i);
+        int ni = si.size;
+        if(ni == 0){
+            continue;
+        }
+        for(int k = i + 1; k < numStations; k++){
+            const QVector<double> &lki = blocks.at(k * numStations + i);
+            if(lki.isEmpty()){
+                continue;
+            }
+            const Station &sk = this->stations.at(k);
+            for(int a = 0; a < ni; a++){
+                for(int c = 0; c < sk.size; c++){
+                    x[si.offset + a] -= lki[c * ni + a] * x[sk.offset + c];
+                }
+            }
+        }
+        const QVector<double> &lii = blocks.at(i * numStations + i);
+        for(int a = ni - 1; a >= 0; a--){
+            for(int c = a + 1; c < ni; c++){
+                x[si.offset + a] -= lii[c * ni + a] * x[si.offset + c];
+            }
+            x[si.offset + a] /= lii[a * ni + a];
+        }
+    }
+
+}
@@ -0,0 +1,278 @@
+#include "bundleinput.h"
+
+#include "bundleadjustment.h"
+
+using namespace oi;
+
+/*!
+ * \brief BundleInput::BundleInput
+ */
+BundleInput::BundleInput() : baseStation(-1), numUnknowns(0){
+
+}
+
+/*!
+ * \brief BundleInput::clear
+ */
+void BundleInput::clear(){
+
+    this->stationIds.clear();
+    this->stationFreeParameters.clear();
+    this->stationParameterOffsets.clear();
+    this->geometryIds.clear();
+    this->geometryParameterOffsets.clear();
+    this->observationStations.clear();
+    this->observationGeometries.clear();
+    this->observationValues.clear();
+
+    this->stationIndices.clear();
+    this->geometryIndices.clear();
+
+    this->baseStation = -1;
+    this->numUnknowns = 0;
+
+}
+
+/*!
+ * \brief BundleInput::reserve
+ * \param numStations
+ * \param numGeometries
+ * \param numObservations
+ */
+void BundleInput::reserve(const int &numStations, const int &numGeometries, const int &numObservations){
+
+    this->stationIds.reserve(numStations);
+    this->stationFreeParameters.reserve(numStations);
+    this->stationParameterOffsets.reserve(numStations);
+    this->geometryIds.reserve(numGeometries);
+    this->geometryParameterOffsets.reserve(numGeometries);
+    this->observationStations.reserve(numObservations);
+    this->observationGeometries.reserve(numObservations);
+    this->observationValues.reserve(numObservations * 3);
+
+    this->stationIndices.reserve(numStations);
+    this->geometryIndices.reserve(numGeometries);
+
+}
+
+/*!
+ * \brief BundleInput::addStation
+ * Adds a station or updates the free parameters of an existing one. Returns the station index
+ * \param id
+ * \param freeParameters
+ * \return
+ */
+int BundleInput::addStation(const int &id, const quint8 &freeParameters){
+
+    int index = this->stationIndices.value(id, -1);
+    if(index >= 0){
+        this->stationFreeParameters[index] = freeParameters;
+        return index;
+    }
+
+    index = this->stationIds.size();
+    this->stationIds.append(id);
+    this->stationFreeParameters.append(freeParameters);
+    this->stationParameterOffsets.append(0);
+    this->stationIndices.insert(id, index);
+
+    return index;
+
+}
+
+/*!
+ * \brief BundleInput::addGeometry
+ * Adds a geometry if it does not exist yet. Returns the geometry index
+ * \param id
+ * \return
+ */
+int BundleInput::addGeometry(const int &id){
+
+    int index = this->geometryIndices.value(id, -1);
+    if(index >= 0){
+        return index;
+    }
+
+    index = this->geometryIds.size();
+    this->geometryIds.append(id);
+    this->geometryParameterOffsets.append(0);
+    this->geometryIndices.insert(id, index);
+
+    return index;
+
+}
+
+/*!
+ * \brief BundleInput::addObservation
+ * \param stationIndex
+ * \param geometryIndex
+ * \param x
+ * \param y
+ * \param z
+ */
+void BundleInput::addObservation(const int &stationIndex, const int &geometryIndex, const double &x, const double &y, const double &z){
+
+    if(stationIndex < 0 || stationIndex >= this->stationIds.size()
+            || geometryIndex < 0 || geometryIndex >= this->geometryIds.size()){
+        return;
+    }
+
+    this->observationStations.append(stationIndex);
+    this->observationGeometries.append(geometryIndex);
+    this->observationValues.append(x);
+    this->observationValues.append(y);
+    this->observationValues.append(z);
+
+}
+
+/*!
+ * \brief BundleInput::setBaseStation
+ * The base station defines the datum, its parameters are not estimated
+ * \param stationIndex
+ */
+void BundleInput::setBaseStation(const int &stationIndex){
+    if(stationIndex >= 0 && stationIndex < this->stationIds.size()){
+        this->baseStation = stationIndex;
+    }
+}
+
+/*!
+ * \brief BundleInput::updateParameterOffsets
+ * Numbers the unknowns: free parameters of all stations (except the base station) followed by the geometry coordinates
+ */
+void BundleInput::updateParameterOffsets(){
+
+    int offset = 0;
+    for(int i = 0; i < this->stationIds.size(); i++){
+        this->stationParameterOffsets[i] = offset;
+        if(i == this->baseStation){
+            continue;
+        }
+        quint8 free = this->stationFreeParameters.at(i);
+        for(int k = 0; k < 7; k++){
+            offset += (free >> k) & 1;
+        }
+    }
+    for(int i = 0; i < this->geometryIds.size(); i++){
+        this->geometryParameterOffsets[i] = offset;
+        offset += 3;
+    }
+    this->numUnknowns = offset;
+
+}
+
+/*!
+ * \brief BundleInput::fromStations
+ * Converts the nested bundle stations. Only geometries with the parameters eUnknownX, eUnknownY and eUnknownZ are used
+ * \param stations
+ * \param baseStation
+ * \return
+ */
+BundleInput BundleInput::fromStations(const QList<BundleStation> &stations, const BundleStation &baseStation){
+
+    BundleInput input;
+
+    //count observations
+    int numObservations = baseStation.geometries.size();
+    foreach(const BundleStation &station, stations){
+        numObservations += station.geometries.size();
+    }
+    input.reserve(stations.size() + 1, numObservations, numObservations);
+
+    //the base station is always the first station
+    QList<BundleStation> allStations;
+    allStations.append(baseStation);
+    foreach(const BundleStation &station, stations){
+        if(station.id != baseStation.id){
+            allStations.append(station);
+        }
+    }
+
+    foreach(const BundleStation &station, allStations){
+        int stationIndex = input.addStation(station.id, BundleInput::getFreeParameters(station));
+        foreach(const BundleGeometry &geometry, station.geometries){
+            if(!geometry.parameters.contains(eUnknownX) || !geometry.parameters.contains(eUnknownY)
+                    || !geometry.parameters.contains(eUnknownZ)){
+                continue;
+            }
+            input.addObservation(stationIndex, input.addGeometry(geometry.id), geometry.parameters.value(eUnknownX),
+                                 geometry.parameters.value(eUnknownY), geometry.parameters.value(eUnknownZ));
+        }
+    }
+
+    input.setBaseStation(0);
+    input.updateParameterOffsets();
+
+    return input;
+
+}
+
+/*!
+ * \brief BundleInput::getFreeParameters
+ * \param station
+ * \return
+ */
+quint8 BundleInput::getFreeParameters(const BundleStation &station){
+    return (station.tx ? eTX : 0) | (station.ty ? eTY : 0) | (station.tz ? eTZ : 0)
+            | (station.rx ? eRX : 0) | (station.ry ? eRY : 0) | (station.rz ? eRZ : 0)
+            | (station.m ? eM : 0);
+}
+
+/*!
+ * \brief BundleInput::getNumStations
+ * \return
+ */
+int BundleInput::getNumStations() const{
+    return this->stationIds.size();
+}
+
+/*!
+ * \brief BundleInput::getNumGeometries
+ * \return
+ */
+int BundleInput::getNumGeometries() const{
+    return this->geometryIds.size();
+}
+
+/*!
+ * \brief BundleInput::getNumObservations
+ * \return
+ */
+int BundleInput::getNumObservations() const{
+    return this->observationStations.size();
+}
+
+/*!
+ * \brief BundleInput::getNumUnknowns
+ * Valid after updateParameterOffsets
+ * \return
+ */
+int BundleInput::getNumUnknowns() const{
+    return this->numUnknowns;
+}
+
+/*!
+ * \brief BundleInput::getBaseStation
+ * \return
+ */
+int BundleInput::getBaseStation() const{
+    return this->baseStation;
+}
+
+/*!
+ * \brief BundleInput::getStationIndex
+ * \param id
+ * \return
+ */
+int BundleInput::getStationIndex(const int &id) const{
+    return this->stationIndices.value(id, -1);
+}
+
+/*!
+ * \brief BundleInput::getGeometryIndex
+ * \param id
+ * \return
+ */
+int BundleInput::getGeometryIndex(const int &id) const{
+    return this->geometryIndices.value(id, -1);
+}
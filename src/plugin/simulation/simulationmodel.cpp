@@ -1,5 +1,7 @@
 #include "simulationmodel.h"
 
+#include <algorithm>
+
 using namespace oi;
 
 /*!
@@ -97,6 +99,16 @@ const QMap<QString, UncertaintyComponent> &SimulationModel::getHumanInfluence()
     return this->humanInfluence;
 }
 
+/*!
+ * \brief SimulationModel::setRandomSeed
+ * Seeds the random number generator of this model. Each model instance has its own generator,
+ * so that parallel simulation runs produce independent but reproducible random streams
+ * \param seed
+ */
+void SimulationModel::setRandomSeed(const quint32 &seed){
+    this->randomGenerator.seed(seed);
+}
+
 /*!
  * \brief SimulationModel::distort
  * Distort a reading with the given uncertainties
@@ -139,3 +151,748 @@ double SimulationModel::getCorrelationCoefficient(const QList<double> &x, const
 void SimulationModel::init(){
 
 }
+
+/*!
+ * \brief OnlineStatistic::OnlineStatistic
+ */
+OnlineStatistic::OnlineStatistic() : count(0), mean(0.0), m2(0.0), minValue(0.0), maxValue(0.0){
+
+}
+
+/*!
+ * \brief OnlineStatistic::add
+ * \param x
+ */
+void OnlineStatistic::add(const double &x){
+
+    this->count++;
+
+    //minimum and maximum
+    if(this->count == 1){
+        this->minValue = x;
+        this->maxValue = x;
+    }else{
+        this->minValue = qMin(this->minValue, x);
+        this->maxValue = qMax(this->maxValue, x);
+    }
+
+    //mean and sum of squared deviations
+    double delta = x - this->mean;
+    this->mean += delta / this->count;
+    this->m2 += delta * (x - this->mean);
+
+}
+
+/*!
+ * \brief OnlineStatistic::merge
+ * Combines the statistic of another data series (e.g. of another thread) with this one
+ * \param other
+ */
+void OnlineStatistic::merge(const OnlineStatistic &other){
+
+    if(other.count == 0){
+        return;
+    }
+    if(this->count == 0){
+        *this = other;
+        return;
+    }
+
+    qint64 n = this->count + other.count;
+    double delta = other.mean - this->mean;
+    this->mean += delta * other.count / n;
+    this->m2 += other.m2 + delta * delta * this->count * other.count / n;
+    this->minValue = qMin(this->minValue, other.minValue);
+    this->maxValue = qMax(this->maxValue, other.maxValue);
+    this->count = n;
+
+}
+
+/*!
+ * \brief OnlineStatistic::clear
+ */
+void OnlineStatistic::clear(){
+    *this = OnlineStatistic();
+}
+
+/*!
+ * \brief OnlineStatistic::getCount
+ * \return
+ */
+const qint64 &OnlineStatistic::getCount() const{
+    return this->count;
+}
+
+/*!
+ * \brief OnlineStatistic::getMean
+ * \return
+ */
+const double &OnlineStatistic::getMean() const{
+    return this->mean;
+}
+
+/*!
+ * \brief OnlineStatistic::getVariance
+ * \return
+ */
+double OnlineStatistic::getVariance() const{
+    if(this->count < 2){
+        return 0.0;
+    }
+    return this->m2 / (this->count - 1);
+}
+
+/*!
+ * \brief OnlineStatistic::getStandardDeviation
+ * \return
+ */
+double OnlineStatistic::getStandardDeviation() const{
+    return qSqrt(this->getVariance());
+}
+
+/*!
+ * \brief OnlineStatistic::getMinimum
+ * \return
+ */
+const double &OnlineStatistic::getMinimum() const{
+    return this->minValue;
+}
+
+/*!
+ * \brief OnlineStatistic::getMaximum
+ * \return
+ */
+const double &OnlineStatistic::getMaximum() const{
+    return this->maxValue;
+}
+
+/*!
+ * \brief OnlineCovariance::OnlineCovariance
+ */
+OnlineCovariance::OnlineCovariance() : count(0), meanX(0.0), meanY(0.0), m2X(0.0), m2Y(0.0), cXY(0.0){
+
+}
+
+/*!
+ * \brief OnlineCovariance::add
+ * \param x
+ * \param y
+ */
+void OnlineCovariance::add(const double &x, const double &y){
+
+    this->count++;
+
+    double dx = x - this->meanX;
+    double dy = y - this->meanY;
+    this->meanX += dx / this->count;
+    this->meanY += dy / this->count;
+    this->m2X += dx * (x - this->meanX);
+    this->m2Y += dy * (y - this->meanY);
+    this->cXY += dx * (y - this->meanY);
+
+}
+
+/*!
+ * \brief OnlineCovariance::merge
+ * \param other
+ */
+void OnlineCovariance::merge(const OnlineCovariance &other){
+
+    if(other.count == 0){
+        return;
+    }
+    if(this->count == 0){
+        *this = other;
+        return;
+    }
+
+    qint64 n = this->count + other.count;
+    double f = (double)this->count * other.count / n;
+    double dx = other.meanX - this->meanX;
+    double dy = other.meanY - this->meanY;
+    this->meanX += dx * other.count / n;
+    this->meanY += dy * other.count / n;
+    this->m2X += other.m2X + dx * dx * f;
+    this->m2Y += other.m2Y + dy * dy * f;
+    this->cXY += other.cXY + dx * dy * f;
+    this->count = n;
+
+}
+
+/*!
+ * \brief OnlineCovariance::clear
+ */
+void OnlineCovariance::clear(){
+    *this = OnlineCovariance();
+}
+
+/*!
+ * \brief OnlineCovariance::getCount
+ * \return
+ */
+const qint64 &OnlineCovariance::getCount() const{
+    return this->count;
+}
+
+/*!
+ * \brief OnlineCovariance::getCovariance
+ * \return
+ */
+double OnlineCovariance::getCovariance() const{
+    if(this->count < 2){
+        return 0.0;
+    }
+    return this->cXY / (this->count - 1);
+}
+
+/*!
+ * \brief OnlineCovariance::getCorrelation
+ * Returns the Pearson correlation coefficient (0 if one of the series has no variance)
+ * \return
+ */
+double OnlineCovariance::getCorrelation() const{
+    if(this->m2X <= 0.0 || this->m2Y <= 0.0){
+        return 0.0;
+    }
+    return this->cXY / qSqrt(this->m2X * this->m2Y);
+}
+
+/*!
+ * \brief P2QuantileEstimator::P2QuantileEstimator
+ * \param probability probability of the quantile (e.g. 0.95)
+ */
+P2QuantileEstimator::P2QuantileEstimator(const double &probability) : probability(qBound(0.0, probability, 1.0)){
+    this->clear();
+}
+
+/*!
+ * \brief P2QuantileEstimator::add
+ * \param x
+ */
+void P2QuantileEstimator::add(const double &x){
+
+    //collect the first five values
+    if(this->count < 5){
+        this->heights[this->count] = x;
+        this->count++;
+        if(this->count == 5){
+            std::sort(this->heights, this->heights + 5);
+        }
+        return;
+    }
+    this->count++;
+
+    //find the cell of x and adjust the extreme markers
+    int k;
+    if(x < this->heights[0]){
+        this->heights[0] = x;
+        k = 0;
+    }else if(x >= this->heights[4]){
+        this->heights[4] = x;
+        k = 3;
+    }else{
+        k = 0;
+        while(k < 3 && x >= this->heights[k + 1]){
+            k++;
+        }
+    }
+
+    //increment positions
+    for(int i = k + 1; i < 5; i++){
+        this->positions[i] += 1.0;
+    }
+    for(int i = 0; i < 5; i++){
+        this->desired[i] += this->increments[i];
+    }
+
+    //adjust the heights of the inner markers
+    for(int i = 1; i < 4; i++){
+        double d = this->desired[i] - this->positions[i];
+        if((d >= 1.0 && this->positions[i + 1] - this->positions[i] > 1.0)
+                || (d <= -1.0 && this->positions[i - 1] - this->positions[i] < -1.0)){
+            int sign = d > 0.0 ? 1 : -1;
+            double height = this->parabolic(i, sign);
+            if(this->heights[i - 1] < height && height < this->heights[i + 1]){
+                this->heights[i] = height;
+            }else{
+                this->heights[i] = this->linear(i, sign);
+            }
+            this->positions[i] += sign;
+        }
+    }
+
+}
+
+/*!
+ * \brief P2QuantileEstimator::merge
+ * P-square estimators cannot be merged exactly. The quantiles are combined by a count weighted mean,
+ * which is a good approximation if both series come from the same distribution (e.g. parallel simulation runs)
+ * \param other
+ */
+void P2QuantileEstimator::merge(const P2QuantileEstimator &other){
+
+    if(other.count == 0){
+        return;
+    }
+    if(this->count == 0){
+        *this = other;
+        return;
+    }
+
+    //both series are too short: re-add the stored values
+    if(other.count < 5){
+        for(int i = 0; i < other.count; i++){
+            this->add(other.heights[i]);
+        }
+        return;
+    }
+    if(this->count < 5){
+        P2QuantileEstimator merged = other;
+        for(int i = 0; i < this->count; i++){
+            merged.add(this->heights[i]);
+        }
+        *this = merged;
+        return;
+    }
+
+    //weighted mean of the marker heights
+    qint64 n = this->count + other.count;
+    double w = (double)other.count / n;
+    for(int i = 0; i < 5; i++){
+        this->heights[i] += w * (other.heights[i] - this->heights[i]);
+    }
+    this->heights[0] = qMin(this->heights[0], other.heights[0]);
+    this->heights[4] = qMax(this->heights[4], other.heights[4]);
+
+    //scale marker positions to the new count
+    double scale = (double)(n - 1) / (this->count - 1);
+    for(int i = 1; i < 4; i++){
+        this->positions[i] = 1.0 + (this->positions[i] - 1.0) * scale;
+        this->desired[i] = 1.0 + (this->desired[i] - 1.0) * scale;
+    }
+    this->positions[4] = n;
+    this->desired[4] = n;
+    this->count = n;
+
+}
+
+/*!
+ * \brief P2QuantileEstimator::clear
+ */
+void P2QuantileEstimator::clear(){
+
+    this->count = 0;
+
+    double p = this->probability;
+    for(int i = 0; i < 5; i++){
+        this->heights[i] = 0.0;
+        this->positions[i] = i + 1;
+    }
+    this->desired[0] = 1.0;
+    this->desired[1] = 1.0 + 2.0 * p;
+    this->desired[2] = 1.0 + 4.0 * p;
+    this->desired[3] = 3.0 + 2.0 * p;
+    this->desired[4] = 5.0;
+    this->increments[0] = 0.0;
+    this->increments[1] = p / 2.0;
+    this->increments[2] = p;
+    this->increments[3] = (1.0 + p) / 2.0;
+    this->increments[4] = 1.0;
+
+}
+
+/*!
+ * \brief P2QuantileEstimator::getProbability
+ * \return
+ */
+const double &P2QuantileEstimator::getProbability() const{
+    return this->probability;
+}
+
+/*!
+ * \brief P2QuantileEstimator::getCount
+ * \return
+ */
+const qint64 &P2QuantileEstimator::getCount() const{
+    return this->count;
+}
+
+/*!
+ * \brief P2QuantileEstimator::getQuantile
+ * \return
+ */
+double P2QuantileEstimator::getQuantile() const{
+
+    if(this->count == 0){
+        return 0.0;
+    }
+
+    //exact quantile of the first values
+    if(this->count < 5){
+        double sorted[5];
+        std::copy(this->heights, this->heights + this->count, sorted);
+        std::sort(sorted, sorted + this->count);
+        int index = qBound(0, (int)qRound(this->probability * (this->count - 1)), (int)this->count - 1);
+        return sorted[index];
+    }
+
+    return this->heights[2];
+
+}
+
+/*!
+ * \brief P2QuantileEstimator::parabolic
+ * Piecewise parabolic prediction of a marker height
+ * \param i
+ * \param d
+ * \return
+ */
+double P2QuantileEstimator::parabolic(const int &i, const double &d) const{
+    const double *q = this->heights;
+    const double *n = this->positions;
+    return q[i] + d / (n[i + 1] - n[i - 1])
+            * ((n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (n[i + 1] - n[i])
+               + (n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) / (n[i] - n[i - 1]));
+}
+
+/*!
+ * \brief P2QuantileEstimator::linear
+ * Linear prediction of a marker height
+ * \param i
+ * \param d
+ * \return
+ */
+double P2QuantileEstimator::linear(const int &i, const int &d) const{
+    return this->heights[i] + d * (this->heights[i + d] - this->heights[i]) / (this->positions[i + d] - this->positions[i]);
+}
+
+/*!
+ * \brief OnlineHistogram::OnlineHistogram
+ */
+OnlineHistogram::OnlineHistogram() : lowerLimit(0.0), upperLimit(0.0), underflow(0), overflow(0){
+
+}
+
+/*!
+ * \brief OnlineHistogram::OnlineHistogram
+ * \param lowerLimit
+ * \param upperLimit
+ * \param numBins
+ */
+OnlineHistogram::OnlineHistogram(const double &lowerLimit, const double &upperLimit, const int &numBins)
+    : lowerLimit(lowerLimit), upperLimit(upperLimit), underflow(0), overflow(0){
+    if(numBins > 0 && upperLimit > lowerLimit){
+        this->bins.fill(0, numBins);
+    }
+}
+
+/*!
+ * \brief OnlineHistogram::add
+ * \param x
+ */
+void OnlineHistogram::add(const double &x){
+
+    if(this->bins.isEmpty()){
+        return;
+    }
+
+    if(x < this->lowerLimit){
+        this->underflow++;
+    }else if(x >= this->upperLimit){
+        this->overflow++;
+    }else{
+        int index = (int)((x - this->lowerLimit) / (this->upperLimit - this->lowerLimit) * this->bins.size());
+        this->bins[qMin(index, this->bins.size() - 1)]++;
+    }
+
+}
+
+/*!
+ * \brief OnlineHistogram::merge
+ * Adds the counts of another histogram with the same limits and number of bins
+ * \param other
+ * \return
+ */
+bool OnlineHistogram::merge(const OnlineHistogram &other){
+
+    if(other.bins.size() != this->bins.size() || other.lowerLimit != this->lowerLimit
+            || other.upperLimit != this->upperLimit){
+        return false;
+    }
+
+    for(int i = 0; i < this->bins.size(); i++){
+        this->bins[i] += other.bins.at(i);
+    }
+    this->underflow += other.underflow;
+    this->overflow += other.overflow;
+
+    return true;
+
+}
+
+/*!
+ * \brief OnlineHistogram::clear
+ * Resets all counts (the limits are kept)
+ */
+void OnlineHistogram::clear(){
+    this->bins.fill(0);
+    this->underflow = 0;
+    this->overflow = 0;
+}
+
+/*!
+ * \brief OnlineHistogram::getIsValid
+ * \return
+ */
+bool OnlineHistogram::getIsValid() const{
+    return !this->bins.isEmpty();
+}
+
+/*!
+ * \brief OnlineHistogram::getLowerLimit
+ * \return
+ */
+const double &OnlineHistogram::getLowerLimit() const{
+    return this->lowerLimit;
+}
+
+/*!
+ * \brief OnlineHistogram::getUpperLimit
+ * \return
+ */
+const double &OnlineHistogram::getUpperLimit() const{
+    return this->upperLimit;
+}
+
+/*!
+ * \brief OnlineHistogram::getBins
+ * \return
+ */
+const QVector<qint64> &OnlineHistogram::getBins() const{
+    return this->bins;
+}
+
+/*!
+ * \brief OnlineHistogram::getUnderflow
+ * \return
+ */
+const qint64 &OnlineHistogram::getUnderflow() const{
+    return this->underflow;
+}
+
+/*!
+ * \brief OnlineHistogram::getOverflow
+ * \return
+ */
+const qint64 &OnlineHistogram::getOverflow() const{
+    return this->overflow;
+}
+
+/*!
+ * \brief UncertaintyData::UncertaintyData
+ */
+UncertaintyData::UncertaintyData() : storeValues(true), maxValue(0.0), minValue(0.0), expectation(0.0), uncertainty(0.0),
+    densityFunction(0), distributionFunction(0){
+
+}
+
+/*!
+ * \brief UncertaintyData::addValue
+ * Updates the online statistic, quantiles and histogram. The value itself is only kept if storeValues is true
+ * \param x
+ */
+void UncertaintyData::addValue(const double &x){
+
+    this->statistic.add(x);
+    for(int i = 0; i < this->quantiles.size(); i++){
+        this->quantiles[i].add(x);
+    }
+    this->histogram.add(x);
+
+    if(this->storeValues){
+        this->values.append(x);
+    }
+
+}
+
+/*!
+ * \brief UncertaintyData::merge
+ * Combines the data of another series (e.g. of another thread) with this one
+ * \param other
+ */
+void UncertaintyData::merge(const UncertaintyData &other){
+
+    this->statistic.merge(other.statistic);
+
+    //quantiles with the same probability
+    for(int i = 0; i < this->quantiles.size(); i++){
+        foreach(const P2QuantileEstimator &quantile, other.quantiles){
+            if(quantile.getProbability() == this->quantiles.at(i).getProbability()){
+                this->quantiles[i].merge(quantile);
+                break;
+            }
+        }
+    }
+
+    this->histogram.merge(other.histogram);
+
+    if(this->storeValues){
+        this->values.append(other.values);
+    }
+
+}
+
+/*!
+ * \brief UncertaintyData::updateResults
+ * Sets expectation, uncertainty, minimum and maximum from the online statistic
+ */
+void UncertaintyData::updateResults(){
+
+    if(this->statistic.getCount() == 0){
+        return;
+    }
+
+    this->expectation = this->statistic.getMean();
+    this->uncertainty = this->statistic.getStandardDeviation();
+    this->minValue = this->statistic.getMinimum();
+    this->maxValue = this->statistic.getMaximum();
+
+    this->info.insert("count", QString::number(this->statistic.getCount()));
+    foreach(const P2QuantileEstimator &quantile, this->quantiles){
+        this->info.insert(QString("quantile %1").arg(quantile.getProbability()), QString::number(quantile.getQuantile(), 'g', 12));
+    }
+
+}
+
+/*!
+ * \brief SimulationData::getUncertaintyData
+ * Returns the uncertainty data that belongs to the given parameter (or 0 if there is none)
+ * \param parameter
+ * \return
+ */
+UncertaintyData *SimulationData::getUncertaintyData(const GeometryParameters &parameter){
+    switch(parameter){
+    case eUnknownX:
+        return &this->uncertaintyX;
+    case eUnknownY:
+        return &this->uncertaintyY;
+    case eUnknownZ:
+        return &this->uncertaintyZ;
+    case eUnknownPrimaryI:
+        return &this->uncertaintyPrimaryI;
+    case eUnknownPrimaryJ:
+        return &this->uncertaintyPrimaryJ;
+    case eUnknownPrimaryK:
+        return &this->uncertaintyPrimaryK;
+    case eUnknownSecondaryI:
+        return &this->uncertaintySecondaryI;
+    case eUnknownSecondaryJ:
+        return &this->uncertaintySecondaryJ;
+    case eUnknownSecondaryK:
+        return &this->uncertaintySecondaryK;
+    case eUnknownRadiusA:
+        return &this->uncertaintyRadiusA;
+    case eUnknownRadiusB:
+        return &this->uncertaintyRadiusB;
+    case eUnknownAperture:
+        return &this->uncertaintyAperture;
+    case eUnknownAngle:
+        return &this->uncertaintyAngle;
+    case eUnknownDistance:
+        return &this->uncertaintyDistance;
+    case eUnknownMeasurementSeries:
+        return &this->uncertaintyMeasurementSeries;
+    case eUnknownTemperature:
+        return &this->uncertaintyTemperature;
+    case eUnknownLength:
+        return &this->uncertaintyLength;
+    default:
+        return 0;
+    }
+}
+
+/*!
+ * \brief SimulationData::getUncertaintyData
+ * \param parameter
+ * \return
+ */
+const UncertaintyData *SimulationData::getUncertaintyData(const GeometryParameters &parameter) const{
+    return const_cast<SimulationData *>(this)->getUncertaintyData(parameter);
+}
+
+/*!
+ * \brief SimulationData::addSample
+ * Adds the parameters of one simulation iteration to the uncertainty data and the pairwise covariances
+ * \param parameters
+ */
+void SimulationData::addSample(const QMap<GeometryParameters, double> &parameters){
+
+    QMap<GeometryParameters, double>::const_iterator it;
+    for(it = parameters.constBegin(); it != parameters.constEnd(); ++it){
+
+        UncertaintyData *data = this->getUncertaintyData(it.key());
+        if(data != 0){
+            data->addValue(it.value());
+        }
+
+        //covariances with all following parameters
+        QMap<GeometryParameters, double>::const_iterator other = it;
+        for(++other; other != parameters.constEnd(); ++other){
+            this->covariances[qMakePair(it.key(), other.key())].add(it.value(), other.value());
+        }
+
+    }
+
+}
+
+/*!
+ * \brief SimulationData::merge
+ * \param other
+ */
+void SimulationData::merge(const SimulationData &other){
+
+    foreach(const GeometryParameters &parameter, getAvailableGeometryParameters()){
+        UncertaintyData *data = this->getUncertaintyData(parameter);
+        const UncertaintyData *otherData = other.getUncertaintyData(parameter);
+        if(data != 0 && otherData != 0){
+            data->merge(*otherData);
+        }
+    }
+
+    QMap<QPair<GeometryParameters, GeometryParameters>, OnlineCovariance>::const_iterator it;
+    for(it = other.covariances.constBegin(); it != other.covariances.constEnd(); ++it){
+        this->covariances[it.key()].merge(it.value());
+    }
+
+}
+
+/*!
+ * \brief SimulationData::updateResults
+ * Updates the results of all uncertainty data and the correlations from the online accumulators
+ */
+void SimulationData::updateResults(){
+
+    foreach(const GeometryParameters &parameter, getAvailableGeometryParameters()){
+        UncertaintyData *data = this->getUncertaintyData(parameter);
+        if(data != 0){
+            data->updateResults();
+        }
+    }
+
+    QMap<QPair<GeometryParameters, GeometryParameters>, OnlineCovariance>::const_iterator it;
+    for(it = this->covariances.constBegin(); it != this->covariances.constEnd(); ++it){
+        this->correlations.insert(SimulationData::getCorrelationKey(it.key().first, it.key().second), it.value().getCorrelation());
+    }
+
+}
+
+/*!
+ * \brief SimulationData::getCorrelationKey
+ * Returns the key of the correlation between two parameters (e.g. "x-y")
+ * \param x
+ * \param y
+ * \return
+ */
+QString SimulationData::getCorrelationKey(const GeometryParameters &x, const GeometryParameters &y){
+    return QString("%1-%2").arg(getGeometryParameterName(x)).arg(getGeometryParameterName(y));
+}
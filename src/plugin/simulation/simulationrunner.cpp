@@ -0,0 +1,330 @@
+#include "simulationrunner.h"
+
+#include <QtConcurrent>
+#include <QThread>
+
+using namespace oi;
+
+/*!
+ * \brief The SimulationRunner::WorkerResult class
+ * Partial statistics of one worker thread
+ */
+class SimulationRunner::WorkerResult{
+public:
+    WorkerResult() : validIterations(0){}
+
+    SimulationData data;
+    int validIterations;
+};
+
+/*!
+ * \brief SimulationRunner::SimulationRunner
+ * \param parent
+ */
+SimulationRunner::SimulationRunner(QObject *parent) : QObject(parent), iterations(1000), seed(5489u),
+    numberOfThreads(0), isCanceled(0), finishedIterations(0), validIterations(0){
+
+}
+
+/*!
+ * \brief SimulationRunner::~SimulationRunner
+ */
+SimulationRunner::~SimulationRunner(){
+
+    //delete reading snapshot
+    foreach(const QPointer<Reading> &reading, this->readings){
+        if(!reading.isNull()){
+            delete reading.data();
+        }
+    }
+
+}
+
+/*!
+ * \brief SimulationRunner::setModelFactory
+ * \param factory
+ */
+void SimulationRunner::setModelFactory(const SimulationModelFactory &factory){
+    this->modelFactory = factory;
+}
+
+/*!
+ * \brief SimulationRunner::setEvaluatorFactory
+ * \param factory
+ */
+void SimulationRunner::setEvaluatorFactory(const SimulationEvaluatorFactory &factory){
+    this->evaluatorFactory = factory;
+}
+
+/*!
+ * \brief SimulationRunner::setSimulationConfiguration
+ * The configuration is passed to the simulation model of each worker
+ * \param sConfig
+ */
+void SimulationRunner::setSimulationConfiguration(const SimulationConfiguration &sConfig){
+    this->sConfig = sConfig;
+}
+
+/*!
+ * \brief SimulationRunner::setReadings
+ * Copies the given readings. The workers only access these copies, so the original readings may change during the run
+ * \param readings
+ */
+void SimulationRunner::setReadings(const QList<QPointer<Reading> > &readings){
+
+    //delete old snapshot
+    foreach(const QPointer<Reading> &reading, this->readings){
+        if(!reading.isNull()){
+            delete reading.data();
+        }
+    }
+    this->readings.clear();
+
+    //copy readings
+    foreach(const QPointer<Reading> &reading, readings){
+        if(!reading.isNull()){
+            this->readings.append(new Reading(*reading.data()));
+        }
+    }
+
+}
+
+/*!
+ * \brief SimulationRunner::setObjectRelation
+ * \param objectRelation homogeneous matrix (4x4) which describes the relation between station and object
+ */
+void SimulationRunner::setObjectRelation(const OiMat &objectRelation){
+    this->objectRelation = objectRelation;
+}
+
+/*!
+ * \brief SimulationRunner::getIterations
+ * \return
+ */
+const int &SimulationRunner::getIterations() const{
+    return this->iterations;
+}
+
+/*!
+ * \brief SimulationRunner::setIterations
+ * \param iterations
+ */
+void SimulationRunner::setIterations(const int &iterations){
+    if(iterations > 0){
+        this->iterations = iterations;
+    }
+}
+
+/*!
+ * \brief SimulationRunner::getSeed
+ * \return
+ */
+const quint32 &SimulationRunner::getSeed() const{
+    return this->seed;
+}
+
+/*!
+ * \brief SimulationRunner::setSeed
+ * The same seed and number of threads reproduce the same results
+ * \param seed
+ */
+void SimulationRunner::setSeed(const quint32 &seed){
+    this->seed = seed;
+}
+
+/*!
+ * \brief SimulationRunner::getNumberOfThreads
+ * \return
+ */
+const int &SimulationRunner::getNumberOfThreads() const{
+    return this->numberOfThreads;
+}
+
+/*!
+ * \brief SimulationRunner::setNumberOfThreads
+ * \param numberOfThreads number of worker threads (0 = QThread::idealThreadCount)
+ */
+void SimulationRunner::setNumberOfThreads(const int &numberOfThreads){
+    this->numberOfThreads = qMax(0, numberOfThreads);
+}
+
+/*!
+ * \brief SimulationRunner::run
+ * Runs all iterations and writes the online statistics of each parameter and the correlations into result.
+ * Quantile estimators and histograms that are set up in result are filled as well.
+ * The method blocks until all workers have finished
+ * \param result
+ * \return
+ */
+bool SimulationRunner::run(SimulationData &result){
+
+    this->isCanceled.store(0);
+    this->finishedIterations.store(0);
+    this->validIterations = 0;
+
+    //check factories
+    if(!this->modelFactory || !this->evaluatorFactory){
+        emit this->sendMessage("Simulation runner needs a model and an evaluator factory", eErrorMessage, eConsoleMessage);
+        return false;
+    }
+
+    //set up the worker template: the configuration of result (quantiles, histograms) is used,
+    //but no values are stored and no accumulated data is taken over
+    SimulationData workerTemplate;
+    foreach(const GeometryParameters &parameter, getAvailableGeometryParameters()){
+        UncertaintyData *templateData = workerTemplate.getUncertaintyData(parameter);
+        const UncertaintyData *resultData = const_cast<const SimulationData &>(result).getUncertaintyData(parameter);
+        if(templateData == 0 || resultData == 0){
+            continue;
+        }
+        templateData->storeValues = false;
+        foreach(const P2QuantileEstimator &quantile, resultData->quantiles){
+            templateData->quantiles.append(P2QuantileEstimator(quantile.getProbability()));
+        }
+        templateData->histogram = resultData->histogram;
+        templateData->histogram.clear();
+    }
+    this->workerTemplate = workerTemplate;
+
+    //split iterations
+    int numWorkers = this->numberOfThreads > 0 ? this->numberOfThreads : qMax(1, QThread::idealThreadCount());
+    numWorkers = qMin(numWorkers, this->iterations);
+    QList<QFuture<WorkerResult> > futures;
+    for(int i = 0; i < numWorkers; i++){
+        int workerIterations = this->iterations / numWorkers + (i < this->iterations % numWorkers ? 1 : 0);
+        futures.append(QtConcurrent::run(this, &SimulationRunner::runWorker, i, workerIterations));
+    }
+
+    //merge partial results in a fixed order (reproducible)
+    WorkerResult total;
+    total.data = workerTemplate;
+    for(int i = 0; i < futures.size(); i++){
+        WorkerResult partial = futures[i].result();
+        total.validIterations += partial.validIterations;
+        total.data.merge(partial.data);
+    }
+    this->validIterations = total.validIterations;
+
+    if(this->isCanceled.load() != 0){
+        emit this->sendMessage("Simulation canceled by user", eWarningMessage, eConsoleMessage);
+        return false;
+    }
+
+    if(total.validIterations == 0){
+        emit this->sendMessage("No valid simulation iteration", eErrorMessage, eConsoleMessage);
+        return false;
+    }
+
+    //write statistics
+    total.data.updateResults();
+    foreach(const GeometryParameters &parameter, getAvailableGeometryParameters()){
+        UncertaintyData *data = result.getUncertaintyData(parameter);
+        const UncertaintyData *simulated = const_cast<const SimulationData &>(total.data).getUncertaintyData(parameter);
+        if(data == 0 || simulated == 0 || simulated->statistic.getCount() == 0){
+            continue;
+        }
+        data->values.clear();
+        data->statistic = simulated->statistic;
+        data->quantiles = simulated->quantiles;
+        data->histogram = simulated->histogram;
+        data->updateResults();
+    }
+    result.covariances = total.data.covariances;
+    result.correlations = total.data.correlations;
+
+    return true;
+
+}
+
+/*!
+ * \brief SimulationRunner::cancel
+ * Can be called from any thread
+ */
+void SimulationRunner::cancel(){
+    this->isCanceled.store(1);
+}
+
+/*!
+ * \brief SimulationRunner::getValidIterations
+ * Returns the number of iterations of the last run that could be evaluated
+ * \return
+ */
+const int &SimulationRunner::getValidIterations() const{
+    return this->validIterations;
+}
+
+/*!
+ * \brief SimulationRunner::runWorker
+ * Executed in a worker thread: distorts own copies of the readings and evaluates the geometry for each iteration
+ * \param workerIndex
+ * \param iterations
+ * \return
+ */
+SimulationRunner::WorkerResult SimulationRunner::runWorker(const int &workerIndex, const int &iterations){
+
+    WorkerResult result;
+    result.data = this->workerTemplate;
+
+    //create model and evaluator of this worker
+    QPointer<SimulationModel> model = this->modelFactory();
+    SimulationEvaluator evaluator = this->evaluatorFactory();
+    if(model.isNull() || !evaluator){
+        if(!model.isNull()){
+            delete model.data();
+        }
+        return result;
+    }
+    model->setSimulationConfiguration(this->sConfig);
+
+    //independent random stream per worker
+    std::seed_seq seedSequence{this->seed, (quint32)workerIndex};
+    std::mt19937 seedGenerator(seedSequence);
+    model->setRandomSeed(seedGenerator());
+
+    //working copies of the readings
+    QList<QPointer<Reading> > workingReadings;
+    foreach(const QPointer<Reading> &reading, this->readings){
+        workingReadings.append(new Reading(*reading.data()));
+    }
+
+    int progressStep = qMax(1, this->iterations / 100);
+    QMap<GeometryParameters, double> parameters;
+    for(int i = 0; i < iterations; i++){
+
+        //check cancellation
+        if(this->isCanceled.load() != 0){
+            break;
+        }
+
+        //reset and distort readings
+        bool distorted = true;
+        for(int j = 0; j < workingReadings.size(); j++){
+            *workingReadings[j].data() = *this->readings.at(j).data();
+            distorted = model->distort(workingReadings.at(j), this->objectRelation, j == 0) && distorted;
+        }
+
+        //recalculate and collect
+        parameters.clear();
+        if(distorted && evaluator(workingReadings, parameters)){
+            result.data.addSample(parameters);
+            result.validIterations++;
+        }
+
+        //report progress
+        int finished = this->finishedIterations.fetchAndAddRelaxed(1) + 1;
+        if(finished % progressStep == 0){
+            emit this->updateProgress(100 * finished / this->iterations,
+                                      QString("%1 of %2 iterations").arg(finished).arg(this->iterations));
+        }
+
+    }
+
+    //clean up
+    foreach(const QPointer<Reading> &reading, workingReadings){
+        delete reading.data();
+    }
+    delete model.data();
+
+    return result;
+
+}
@@ -0,0 +1,362 @@
+#include "profiler.h"
+
+#include <chrono>
+#include <algorithm>
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QList>
+#include <QHash>
+#include <QStringList>
+#include <QJsonArray>
+
+using namespace oi;
+
+std::atomic<bool> Profiler::enabled(false);
+
+namespace{
+
+/*!
+ * \brief The Event class
+ * A recorded scope (duration) or counter (value)
+ */
+class Event{
+public:
+    const char *name;
+    qint64 start; //ns since the profiler epoch
+    qint64 value; //duration in ns or counter value
+    bool isCount;
+};
+
+//increased by Profiler::reset, buffers of an older generation are rewound by their owning thread
+std::atomic<int> resetGeneration(0);
+
+/*!
+ * \brief The ThreadBuffer class
+ * Append-only list of the events of one thread. Only the owning thread appends (without locking),
+ * other threads read the events up to the published count
+ */
+class ThreadBuffer{
+public:
+    ThreadBuffer(const int &id, const QString &name) : id(id), name(name), count(0), first(0), dropped(0),
+        generation(resetGeneration.load(std::memory_order_acquire)){
+        for(int i = 0; i < maxChunks; i++){
+            this->chunks[i] = 0;
+        }
+    }
+
+    ~ThreadBuffer(){
+        for(int i = 0; i < maxChunks; i++){
+            delete[] this->chunks[i];
+        }
+    }
+
+    void add(const Event &event){
+
+        //discard the events and free the chunks after a reset
+        int currentGeneration = resetGeneration.load(std::memory_order_acquire);
+        if(currentGeneration != this->generation){
+            this->rewind(currentGeneration);
+        }
+
+        int index = this->count.load(std::memory_order_relaxed);
+        int chunk = index >> chunkBits;
+        if(chunk >= maxChunks){
+            this->dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if(this->chunks[chunk] == 0){
+            this->chunks[chunk] = new Event[chunkSize];
+        }
+        this->chunks[chunk][index & (chunkSize - 1)] = event;
+        this->count.store(index + 1, std::memory_order_release);
+
+    }
+
+    void rewind(const int &generation);
+
+    const Event &getEvent(const int &index) const{
+        return this->chunks[index >> chunkBits][index & (chunkSize - 1)];
+    }
+
+    static const int chunkBits = 12; //4096 events per chunk
+    static const int chunkSize = 1 << chunkBits;
+    static const int maxChunks = 1024; //at most 4M events per thread, further events are dropped
+
+    const int id;
+    const QString name;
+
+    Event *chunks[maxChunks];
+    std::atomic<int> count; //published events
+    int first; //first event since the last reset (guarded by the registry mutex)
+    std::atomic<qint64> dropped;
+
+    int generation; //reset generation of the events (only used by the owning thread)
+
+};
+
+/*!
+ * \brief The Registry class
+ * Buffers of all threads that recorded events. The buffers are kept when a thread finishes,
+ * so that its events remain in the profile
+ */
+class Registry{
+public:
+    QMutex mutex;
+    QList<ThreadBuffer *> buffers;
+};
+
+Registry &getRegistry(){
+    //intentionally never deleted: threads may record events during static destruction
+    static Registry *registry = new Registry();
+    return *registry;
+}
+
+/*!
+ * \brief ThreadBuffer::rewind
+ * Called by the owning thread only. Readers are excluded by the registry mutex while the chunks are freed
+ * \param generation
+ */
+void ThreadBuffer::rewind(const int &generation){
+    QMutexLocker locker(&getRegistry().mutex);
+    for(int i = 0; i < maxChunks; i++){
+        delete[] this->chunks[i];
+        this->chunks[i] = 0;
+    }
+    this->count.store(0, std::memory_order_release);
+    this->first = 0;
+    this->generation = generation;
+}
+
+thread_local ThreadBuffer *threadBuffer = 0;
+
+ThreadBuffer *getThreadBuffer(){
+    if(threadBuffer == 0){
+        Registry &registry = getRegistry();
+        QMutexLocker locker(&registry.mutex);
+        QString name = QThread::currentThread() != 0 ? QThread::currentThread()->objectName() : QString();
+        if(name.isEmpty()){
+            name = QString("thread %1").arg(registry.buffers.size() + 1);
+        }
+        threadBuffer = new ThreadBuffer(registry.buffers.size() + 1, name);
+        registry.buffers.append(threadBuffer);
+    }
+    return threadBuffer;
+}
+
+const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+/*!
+ * \brief The ScopeSummary class
+ */
+class ScopeSummary{
+public:
+    ScopeSummary() : count(0), total(0), min(0), max(0){}
+
+    qint64 count;
+    qint64 total;
+    qint64 min;
+    qint64 max;
+};
+
+}
+
+/*!
+ * \brief Profiler::setIsEnabled
+ * Enables or disables recording (scopes that are open when the profiler is disabled are still recorded)
+ * \param isEnabled
+ */
+void Profiler::setIsEnabled(const bool &isEnabled){
+    Profiler::enabled.store(isEnabled, std::memory_order_relaxed);
+}
+
+/*!
+ * \brief Profiler::reset
+ * Discards all events recorded so far. Each thread frees its events and starts a new buffer
+ * with its next event (events of other threads are hidden until then)
+ */
+void Profiler::reset(){
+    Registry &registry = getRegistry();
+    QMutexLocker locker(&registry.mutex);
+    resetGeneration.fetch_add(1, std::memory_order_release);
+    foreach(ThreadBuffer *buffer, registry.buffers){
+        buffer->first = buffer->count.load(std::memory_order_acquire);
+        buffer->dropped.store(0, std::memory_order_relaxed);
+    }
+}
+
+/*!
+ * \brief Profiler::getSummary
+ * Returns the aggregated profile:
+ * scopes (name, count, totalNs, meanNs, minNs, maxNs, sorted by totalNs), counters (name, count, sum),
+ * threads (id, name, events) and the number of dropped events
+ * \return
+ */
+QJsonObject Profiler::getSummary(){
+
+    QHash<QString, ScopeSummary> scopes;
+    QHash<QString, ScopeSummary> counters;
+    QJsonArray threads;
+    qint64 dropped = 0;
+
+    Registry &registry = getRegistry();
+    QMutexLocker locker(&registry.mutex);
+    foreach(ThreadBuffer *buffer, registry.buffers){
+
+        int count = buffer->count.load(std::memory_order_acquire);
+        for(int i = buffer->first; i < count; i++){
+            const Event &event = buffer->getEvent(i);
+            ScopeSummary &summary = event.isCount ? counters[QLatin1String(event.name)] : scopes[QLatin1String(event.name)];
+            if(summary.count == 0 || event.value < summary.min){
+                summary.min = event.value;
+            }
+            if(summary.count == 0 || event.value > summary.max){
+                summary.max = event.value;
+            }
+            summary.count++;
+            summary.total += event.value;
+        }
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+
+        QJsonObject thread;
+        thread.insert("id", buffer->id);
+        thread.insert("name", buffer->name);
+        thread.insert("events", count - buffer->first);
+        threads.append(thread);
+
+    }
+    locker.unlock();
+
+    //sort scopes by total time
+    QList<QPair<qint64, QString> > sortedScopes;
+    for(QHash<QString, ScopeSummary>::const_iterator it = scopes.constBegin(); it != scopes.constEnd(); ++it){
+        sortedScopes.append(QPair<qint64, QString>(-it.value().total, it.key()));
+    }
+    std::sort(sortedScopes.begin(), sortedScopes.end());
+
+    QJsonArray scopeArray;
+    for(int i = 0; i < sortedScopes.size(); i++){
+        const ScopeSummary &summary = scopes[sortedScopes.at(i).second];
+        QJsonObject scope;
+        scope.insert("name", sortedScopes.at(i).second);
+        scope.insert("count", (double)summary.count);
+        scope.insert("totalNs", (double)summary.total);
+        scope.insert("meanNs", (double)summary.total / (double)summary.count);
+        scope.insert("minNs", (double)summary.min);
+        scope.insert("maxNs", (double)summary.max);
+        scopeArray.append(scope);
+    }
+
+    QJsonArray counterArray;
+    QStringList counterNames = counters.keys();
+    std::sort(counterNames.begin(), counterNames.end());
+    foreach(const QString &name, counterNames){
+        QJsonObject counter;
+        counter.insert("name", name);
+        counter.insert("count", (double)counters[name].count);
+        counter.insert("sum", (double)counters[name].total);
+        counterArray.append(counter);
+    }
+
+    QJsonObject summary;
+    summary.insert("enabled", Profiler::getIsEnabled());
+    summary.insert("dropped", (double)dropped);
+    summary.insert("threads", threads);
+    summary.insert("scopes", scopeArray);
+    summary.insert("counters", counterArray);
+    return summary;
+
+}
+
+/*!
+ * \brief Profiler::getChromeTrace
+ * Returns all events in the Chrome trace event format (load the json in chrome://tracing or Perfetto).
+ * Scopes are complete events, counters are counter events with the value that was added
+ * \return
+ */
+QJsonObject Profiler::getChromeTrace(){
+
+    QJsonArray events;
+
+    Registry &registry = getRegistry();
+    QMutexLocker locker(&registry.mutex);
+    foreach(ThreadBuffer *buffer, registry.buffers){
+
+        QJsonObject threadName;
+        threadName.insert("ph", QString("M"));
+        threadName.insert("name", QString("thread_name"));
+        threadName.insert("pid", 1);
+        threadName.insert("tid", buffer->id);
+        QJsonObject args;
+        args.insert("name", buffer->name);
+        threadName.insert("args", args);
+        events.append(threadName);
+
+        int count = buffer->count.load(std::memory_order_acquire);
+        for(int i = buffer->first; i < count; i++){
+            const Event &event = buffer->getEvent(i);
+            QJsonObject traceEvent;
+            traceEvent.insert("name", QLatin1String(event.name));
+            traceEvent.insert("pid", 1);
+            traceEvent.insert("tid", buffer->id);
+            traceEvent.insert("ts", (double)event.start / 1000.0); //us
+            if(event.isCount){
+                traceEvent.insert("ph", QString("C"));
+                QJsonObject value;
+                value.insert("value", (double)event.value);
+                traceEvent.insert("args", value);
+            }else{
+                traceEvent.insert("ph", QString("X"));
+                traceEvent.insert("cat", QString("oi"));
+                traceEvent.insert("dur", (double)event.value / 1000.0); //us
+            }
+            events.append(traceEvent);
+        }
+
+    }
+
+    QJsonObject trace;
+    trace.insert("traceEvents", events);
+    trace.insert("displayTimeUnit", QString("ns"));
+    return trace;
+
+}
+
+/*!
+ * \brief Profiler::getTime
+ * Returns the time since the start of the application [ns] (monotonic)
+ * \return
+ */
+qint64 Profiler::getTime(){
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+/*!
+ * \brief Profiler::addScope
+ * \param name
+ * \param start
+ * \param duration
+ */
+void Profiler::addScope(const char *name, const qint64 &start, const qint64 &duration){
+    Event event;
+    event.name = name;
+    event.start = start;
+    event.value = duration;
+    event.isCount = false;
+    getThreadBuffer()->add(event);
+}
+
+/*!
+ * \brief Profiler::addCount
+ * \param name
+ * \param value
+ */
+void Profiler::addCount(const char *name, const qint64 &value){
+    Event event;
+    event.name = name;
+    event.start = Profiler::getTime();
+    event.value = value;
+    event.isCount = true;
+    getThreadBuffer()->add(event);
+}
@@ -2,6 +2,7 @@
 
 #include "observation.h"
 #include "sensor.h"
+#include "profiler.h"
 
 using namespace oi;
 using namespace oi::math;
@@ -946,6 +947,8 @@ QString Reading::getDisplaySigmaTemperature(const UnitType &type, const int &dig
  */
 QDomElement Reading::toOpenIndyXML(QDomDocument &xmlDoc) const{
 
+    OI_PROFILE_SCOPE("Reading::toOpenIndyXML");
+
     if(xmlDoc.isNull()){
         return QDomElement();
     }
@@ -1121,6 +1124,8 @@ QDomElement Reading::toOpenIndyXML(QDomDocument &xmlDoc) const{
  */
 bool Reading::fromOpenIndyXML(QDomElement &xmlElem){
 
+    OI_PROFILE_SCOPE("Reading::fromOpenIndyXML");
+
     if(xmlElem.isNull()){
         return false;
     }
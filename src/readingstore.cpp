@@ -0,0 +1,327 @@
+#include "readingstore.h"
+
+#include "reading.h"
+
+using namespace oi;
+
+/*!
+ * \brief ReadingStore::ReadingStore
+ */
+ReadingStore::ReadingStore() : numEntries(0), numRemoved(0){
+    this->typeIndices.resize(ReadingStore::numReadingTypes);
+    this->typeCounts.fill(0, ReadingStore::numReadingTypes);
+}
+
+/*!
+ * \brief ReadingStore::getCount
+ * Returns the number of stored readings (readings that were deleted without being removed are not counted)
+ * \return
+ */
+int ReadingStore::getCount() const{
+    this->dropDeletedReadings();
+    return this->numEntries - this->numRemoved;
+}
+
+/*!
+ * \brief ReadingStore::getCount
+ * Returns the number of stored readings of the given type
+ * \param type
+ * \return
+ */
+int ReadingStore::getCount(const ReadingTypes &type) const{
+    if(type < 0 || type >= ReadingStore::numReadingTypes){
+        return 0;
+    }
+    this->dropDeletedReadings(type);
+    return this->typeCounts.at(type);
+}
+
+/*!
+ * \brief ReadingStore::contains
+ * \param reading
+ * \return
+ */
+bool ReadingStore::contains(const QPointer<Reading> &reading) const{
+    if(reading.isNull()){
+        return false;
+    }
+    QHash<const Reading *, int>::const_iterator it = this->readingIndices.constFind(reading.data());
+    if(it == this->readingIndices.constEnd()){
+        return false;
+    }
+
+    //a deleted reading had the same address
+    if(this->getEntry(it.value()).reading.isNull()){
+        this->removeEntry(it.value());
+        return false;
+    }
+
+    return this->getEntry(it.value()).reading == reading;
+}
+
+/*!
+ * \brief ReadingStore::getReadings
+ * Returns all stored readings in the order they were added
+ * \return
+ */
+QList<QPointer<Reading> > ReadingStore::getReadings() const{
+
+    QList<QPointer<Reading> > readings;
+    readings.reserve(this->numEntries - this->numRemoved);
+
+    for(int i = 0; i < this->numEntries; i++){
+        const Entry &entry = this->getEntry(i);
+        if(entry.isRemoved){
+            continue;
+        }
+        if(entry.reading.isNull()){
+            this->removeEntry(i);
+            continue;
+        }
+        readings.append(entry.reading);
+    }
+
+    return readings;
+
+}
+
+/*!
+ * \brief ReadingStore::getReadings
+ * Returns all stored readings of the given type in the order they were added
+ * \param type
+ * \return
+ */
+QList<QPointer<Reading> > ReadingStore::getReadings(const ReadingTypes &type) const{
+
+    QList<QPointer<Reading> > readings;
+    if(type < 0 || type >= ReadingStore::numReadingTypes){
+        return readings;
+    }
+    readings.reserve(this->typeCounts.at(type));
+
+    foreach(const int &index, this->typeIndices.at(type)){
+        const Entry &entry = this->getEntry(index);
+        if(entry.isRemoved){
+            continue;
+        }
+        if(entry.reading.isNull()){
+            this->removeEntry(index);
+            continue;
+        }
+        readings.append(entry.reading);
+    }
+
+    return readings;
+
+}
+
+/*!
+ * \brief ReadingStore::add
+ * Appends a reading. Returns false if the reading is invalid or already stored
+ * \param reading
+ * \return
+ */
+bool ReadingStore::add(const QPointer<Reading> &reading){
+
+    if(reading.isNull()){
+        return false;
+    }
+
+    //check if the reading is already stored
+    QHash<const Reading *, int>::iterator it = this->readingIndices.find(reading.data());
+    if(it != this->readingIndices.end()){
+        if(!this->getEntry(it.value()).reading.isNull()){
+            return false;
+        }
+
+        //a deleted reading had the same address
+        this->removeEntry(it.value());
+    }
+
+    //get the type of the reading
+    ReadingTypes type = reading->getTypeOfReading();
+    if(type < 0 || type >= ReadingStore::numReadingTypes){
+        type = eUndefinedReading;
+    }
+
+    //add a new chunk if all chunks are full
+    if(this->numEntries == this->chunks.size() * ReadingStore::chunkSize){
+        this->chunks.append(QVector<Entry>(ReadingStore::chunkSize));
+    }
+
+    //append the reading
+    int index = this->numEntries;
+    Entry &entry = this->getEntry(index);
+    entry.reading = reading;
+    entry.key = reading.data();
+    entry.type = type;
+    entry.isRemoved = false;
+    this->numEntries++;
+
+    this->typeIndices[type].append(index);
+    this->typeCounts[type]++;
+    this->readingIndices.insert(entry.key, index);
+
+    this->compactIfNeeded();
+
+    return true;
+
+}
+
+/*!
+ * \brief ReadingStore::remove
+ * Removes a reading in constant time. The reading itself is not deleted
+ * \param reading
+ * \return
+ */
+bool ReadingStore::remove(const QPointer<Reading> &reading){
+
+    if(reading.isNull()){
+        return false;
+    }
+
+    QHash<const Reading *, int>::iterator it = this->readingIndices.find(reading.data());
+    if(it == this->readingIndices.end()){
+        return false;
+    }
+
+    //a deleted reading had the same address
+    bool isStored = !this->getEntry(it.value()).reading.isNull();
+
+    this->removeEntry(it.value());
+    this->compactIfNeeded();
+
+    return isStored;
+
+}
+
+/*!
+ * \brief ReadingStore::clear
+ * Removes all readings (the readings themselves are not deleted)
+ */
+void ReadingStore::clear(){
+    this->chunks.clear();
+    this->numEntries = 0;
+    this->numRemoved = 0;
+    this->typeIndices.clear();
+    this->typeIndices.resize(ReadingStore::numReadingTypes);
+    this->typeCounts.fill(0, ReadingStore::numReadingTypes);
+    this->readingIndices.clear();
+}
+
+/*!
+ * \brief ReadingStore::getEntry
+ * \param index
+ * \return
+ */
+ReadingStore::Entry &ReadingStore::getEntry(const int &index){
+    return this->chunks[index >> ReadingStore::chunkBits][index & (ReadingStore::chunkSize - 1)];
+}
+
+/*!
+ * \brief ReadingStore::getEntry
+ * \param index
+ * \return
+ */
+const ReadingStore::Entry &ReadingStore::getEntry(const int &index) const{
+    return this->chunks.at(index >> ReadingStore::chunkBits).at(index & (ReadingStore::chunkSize - 1));
+}
+
+/*!
+ * \brief ReadingStore::removeEntry
+ * Marks the entry as removed (the position stays in the type index until the next compaction)
+ * \param index
+ */
+void ReadingStore::removeEntry(const int &index) const{
+
+    Entry &entry = this->chunks[index >> ReadingStore::chunkBits][index & (ReadingStore::chunkSize - 1)];
+    if(entry.isRemoved){
+        return;
+    }
+
+    this->readingIndices.remove(entry.key);
+    this->typeCounts[entry.type]--;
+    this->numRemoved++;
+
+    entry.reading = QPointer<Reading>();
+    entry.key = 0;
+    entry.isRemoved = true;
+
+}
+
+/*!
+ * \brief ReadingStore::dropDeletedReadings
+ * Removes the entries of the given type whose readings were deleted without being removed
+ * \param type
+ */
+void ReadingStore::dropDeletedReadings(const ReadingTypes &type) const{
+    foreach(const int &index, this->typeIndices.at(type)){
+        const Entry &entry = this->getEntry(index);
+        if(!entry.isRemoved && entry.reading.isNull()){
+            this->removeEntry(index);
+        }
+    }
+}
+
+/*!
+ * \brief ReadingStore::dropDeletedReadings
+ * Removes all entries whose readings were deleted without being removed
+ */
+void ReadingStore::dropDeletedReadings() const{
+    for(int i = 0; i < this->numEntries; i++){
+        const Entry &entry = this->getEntry(i);
+        if(!entry.isRemoved && entry.reading.isNull()){
+            this->removeEntry(i);
+        }
+    }
+}
+
+/*!
+ * \brief ReadingStore::compactIfNeeded
+ * Compacts the store once the removed entries outnumber the stored readings
+ */
+void ReadingStore::compactIfNeeded(){
+    if(this->numRemoved > ReadingStore::chunkSize && 2 * this->numRemoved > this->numEntries){
+        this->compact();
+    }
+}
+
+/*!
+ * \brief ReadingStore::compact
+ * Moves all stored readings to the front and rebuilds the indices
+ */
+void ReadingStore::compact(){
+
+    QVector<QVector<Entry> > chunks;
+    int numEntries = 0;
+
+    this->typeIndices.clear();
+    this->typeIndices.resize(ReadingStore::numReadingTypes);
+    this->typeCounts.fill(0, ReadingStore::numReadingTypes);
+    this->readingIndices.clear();
+
+    for(int i = 0; i < this->numEntries; i++){
+
+        //skip removed entries and deleted readings
+        const Entry &entry = this->getEntry(i);
+        if(entry.isRemoved || entry.reading.isNull()){
+            continue;
+        }
+
+        if(numEntries == chunks.size() * ReadingStore::chunkSize){
+            chunks.append(QVector<Entry>(ReadingStore::chunkSize));
+        }
+        chunks[numEntries >> ReadingStore::chunkBits][numEntries & (ReadingStore::chunkSize - 1)] = entry;
+
+        this->typeIndices[entry.type].append(numEntries);
+        this->typeCounts[entry.type]++;
+        this->readingIndices.insert(entry.key, numEntries);
+        numEntries++;
+
+    }
+
+    this->chunks = chunks;
+    this->numEntries = numEntries;
+    this->numRemoved = 0;
+
+}
@@ -624,6 +624,60 @@ void SensorControl::stopStatusMonitoringStream(){
 
 }
 
+/*!
+ * \brief SensorControl::startWatchWindow
+ * Starts processing the reading stream for the watch window. The reading stream itself is started by startReadingStream
+ */
+void SensorControl::startWatchWindow(){
+    if(!this->worker->getWatchWindow().isNull()){
+        this->worker->getWatchWindow()->start();
+    }
+}
+
+/*!
+ * \brief SensorControl::stopWatchWindow
+ */
+void SensorControl::stopWatchWindow(){
+    if(!this->worker->getWatchWindow().isNull()){
+        this->worker->getWatchWindow()->stop();
+    }
+}
+
+/*!
+ * \brief SensorControl::setWatchWindowTransformation
+ * Sets the homogeneous 4x4 matrix from the station system into the active coordinate system
+ * \param trafo
+ */
+void SensorControl::setWatchWindowTransformation(const OiMat &trafo){
+    if(this->worker->getWatchWindow().isNull()){
+        return;
+    }
+    if(!this->worker->getWatchWindow()->setTransformation(trafo)){
+        emit this->sensorMessage("Watch window transformation has to be a 4x4 matrix", eErrorMessage, eConsoleMessage);
+    }
+}
+
+/*!
+ * \brief SensorControl::setWatchWindowGeometry
+ * Sets the geometry the watch window deviations are computed to (called in the thread of the feature)
+ * \param feature
+ */
+void SensorControl::setWatchWindowGeometry(const QPointer<FeatureWrapper> &feature){
+    if(!this->worker->getWatchWindow().isNull()){
+        this->worker->getWatchWindow()->setGeometry(feature);
+    }
+}
+
+/*!
+ * \brief SensorControl::setWatchWindowDisplayRate
+ * \param displayRate
+ */
+void SensorControl::setWatchWindowDisplayRate(const int &displayRate){
+    if(!this->worker->getWatchWindow().isNull()){
+        this->worker->getWatchWindow()->setDisplayRate(displayRate);
+    }
+}
+
 void SensorControl::finishMeasurement(){
 
     //call method of sensor worker
@@ -647,6 +701,7 @@ void SensorControl::connectSensorWorker(){
     //connect streaming results
     QObject::connect(this->worker, &SensorWorker::realTimeReading, this, &SensorControl::realTimeReading, Qt::QueuedConnection);
     QObject::connect(this->worker, &SensorWorker::realTimeStatus, this, &SensorControl::realTimeStatus, Qt::QueuedConnection);
+    QObject::connect(this->worker, &SensorWorker::watchWindowReading, this, &SensorControl::watchWindowReading, Qt::QueuedConnection);
     QObject::connect(this->worker, &SensorWorker::connectionLost, this, &SensorControl::connectionLost, Qt::QueuedConnection);
     QObject::connect(this->worker, &SensorWorker::connectionReceived, this, &SensorControl::connectionReceived, Qt::QueuedConnection);
     QObject::connect(this->worker, &SensorWorker::isReadyForMeasurement, this, &SensorControl::isReadyForMeasurement, Qt::QueuedConnection);
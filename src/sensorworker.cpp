@@ -1,5 +1,7 @@
 #include "sensorworker.h"
 
+#include "profiler.h"
+
 using namespace oi;
 
 /*!
@@ -11,6 +13,10 @@ SensorWorker::SensorWorker(QObject *parent) : QObject(parent), isSensorConnected
     isReadingStreamStarted(false), isConnectionStreamStarted(false), isStatusStreamStarted(false),
     streamFormat(eUndefinedReading){
 
+    //the watch window is a child of the worker, so that it is moved to the worker thread together with the worker
+    this->watchWindow = new WatchWindowEngine(this);
+    QObject::connect(this->watchWindow.data(), &WatchWindowEngine::watchWindowReading, this, &SensorWorker::watchWindowReading, Qt::DirectConnection);
+
 }
 
 /*!
@@ -20,6 +26,14 @@ SensorWorker::~SensorWorker(){
 
 }
 
+/*!
+ * \brief SensorWorker::getWatchWindow
+ * \return
+ */
+const QPointer<WatchWindowEngine> &SensorWorker::getWatchWindow() const{
+    return this->watchWindow;
+}
+
 /*!
  * \brief SensorWorker::getSensor
  * \return
@@ -374,6 +388,8 @@ void SensorWorker::disconnectSensor(){
  */
 void SensorWorker::measure(int geomId, MeasurementConfig mConfig){
 
+    OI_PROFILE_SCOPE("SensorWorker::measure");
+
     //check sensor
     if(this->sensor.isNull()){
         emit this->commandFinished(false, SensorWorkerMessage::NO_SENSOR_INSTANCE);
@@ -873,6 +889,8 @@ void SensorWorker::stopStatusMonitoringStream(){
  */
 void SensorWorker::streamReading(){
 
+    OI_PROFILE_SCOPE("SensorWorker::streamReading");
+
     //check streaming status
     if(!this->isReadingStreamStarted){
         return;
@@ -888,6 +906,7 @@ void SensorWorker::streamReading(){
         //get real time reading
         QVariantMap reading = this->sensor->readingStream(this->streamFormat);
         emit this->realTimeReading(reading);
+        this->watchWindow->addReading(reading);
 
         //put reading stream into event queue again
         QMetaObject::invokeMethod(this, "streamReading", Qt::QueuedConnection);
@@ -908,6 +927,8 @@ void SensorWorker::streamReading(){
  */
 void SensorWorker::monitorConnectionStatus(){
 
+    OI_PROFILE_SCOPE("SensorWorker::monitorConnectionStatus");
+
     //check streaming status
     if(!this->isConnectionStreamStarted){
         return;
@@ -939,6 +960,8 @@ void SensorWorker::monitorConnectionStatus(){
  */
 void SensorWorker::streamStatus(){
 
+    OI_PROFILE_SCOPE("SensorWorker::streamStatus");
+
     //check streaming status
     if(!this->isStatusStreamStarted){
         return;
@@ -989,7 +1012,10 @@ void SensorWorker::asyncSensorMeasurementReceived(const int &geomId, const QList
 
 void SensorWorker::asyncSensorStreamDataReceived(const QVariantMap &reading)
 {
+    OI_PROFILE_SCOPE("SensorWorker::asyncSensorStreamDataReceived");
+
     emit this->realTimeReading(reading);
+    this->watchWindow->addReading(reading);
 
     //put reading stream into event queue again
     QMetaObject::invokeMethod(this, "streamReading", Qt::QueuedConnection);
@@ -6,6 +6,7 @@
 #include "sensor.h"
 #include "oijob.h"
 #include "featurewrapper.h"
+#include "profiler.h"
 
 using namespace oi;
 
@@ -328,6 +329,14 @@ const QList<Sensor> Station::getUsedSensors() const{
 
 }
 
+/*!
+ * \brief Station::getReadings
+ * \return
+ */
+const ReadingStore &Station::getReadings() const{
+    return this->readings;
+}
+
 /*!
  * \brief Station::getTargetGeometries
  * \return
@@ -335,47 +344,14 @@ const QList<Sensor> Station::getUsedSensors() const{
 QList<QPointer<Geometry> > Station::getTargetGeometries() const{
 
     QList<QPointer<Geometry> > geometries;
+    geometries.reserve(this->targetGeometries.size());
 
-    //get a list of all readings
-    QList<QPointer<Reading> > readings;
-    foreach(const QPointer<Reading> &reading, this->cartesianReadings){
-        readings.append(reading);
-    }
-    foreach(const QPointer<Reading> &reading, this->directionReadings){
-        readings.append(reading);
-    }
-    foreach(const QPointer<Reading> &reading, this->distanceReadings){
-        readings.append(reading);
-    }
-    foreach(const QPointer<Reading> &reading, this->polarReadings){
-        readings.append(reading);
-    }
-    foreach(const QPointer<Reading> &reading, this->levelReadings){
-        readings.append(reading);
-    }
-    foreach(const QPointer<Reading> &reading, this->temperatureRadings){
-        readings.append(reading);
-    }
-    foreach(const QPointer<Reading> &reading, this->undefinedReadings){
-        readings.append(reading);
-    }
-
-    //get target geometries
-    foreach(const QPointer<Reading> &reading, readings){
-
-        //check reading
-        if(reading.isNull() || reading->getObservation().isNull()){
-            continue;
-        }
-
-        //add target geometries of the observation
-        const QList<QPointer<Geometry> > &targetGeometries = reading->getObservation()->getTargetGeometries();
-        foreach(const QPointer<Geometry> &geom, targetGeometries){
-            if(!geom.isNull() && !geometries.contains(geom)){
-                geometries.append(geom);
-            }
+    //the index contains each target geometry once
+    QMap<int, TargetGeometry>::const_iterator it;
+    for(it = this->targetGeometries.constBegin(); it != this->targetGeometries.constEnd(); ++it){
+        if(!it.value().geometry.isNull()){
+            geometries.append(it.value().geometry);
         }
-
     }
 
     return geometries;
@@ -591,6 +567,8 @@ void Station::recalc(){
  */
 QDomElement Station::toOpenIndyXML(QDomDocument &xmlDoc){
 
+    OI_PROFILE_SCOPE("Station::toOpenIndyXML");
+
     QDomElement station = Feature::toOpenIndyXML(xmlDoc);
 
     if(station.isNull()){
@@ -648,6 +626,8 @@ QDomElement Station::toOpenIndyXML(QDomDocument &xmlDoc){
  */
 bool Station::fromOpenIndyXML(QDomElement &xmlElem){
 
+    OI_PROFILE_SCOPE("Station::fromOpenIndyXML");
+
     bool result = Feature::fromOpenIndyXML(xmlElem);
 
     if(result){
@@ -759,40 +739,8 @@ void Station::setUpFeatureId(){
     }
 
     //generate unique ids for station's readings
-    foreach(const QPointer<Reading> &reading, this->cartesianReadings){
-        if(!reading.isNull()){
-            reading->id = this->job->generateUniqueId();
-        }
-    }
-    foreach(const QPointer<Reading> &reading, this->polarReadings){
-        if(!reading.isNull()){
-            reading->id = this->job->generateUniqueId();
-        }
-    }
-    foreach(const QPointer<Reading> &reading, this->directionReadings){
-        if(!reading.isNull()){
-            reading->id = this->job->generateUniqueId();
-        }
-    }
-    foreach(const QPointer<Reading> &reading, this->distanceReadings){
-        if(!reading.isNull()){
-            reading->id = this->job->generateUniqueId();
-        }
-    }
-    foreach(const QPointer<Reading> &reading, this->temperatureRadings){
-        if(!reading.isNull()){
-            reading->id = this->job->generateUniqueId();
-        }
-    }
-    foreach(const QPointer<Reading> &reading, this->levelReadings){
-        if(!reading.isNull()){
-            reading->id = this->job->generateUniqueId();
-        }
-    }
-    foreach(const QPointer<Reading> &reading, this->undefinedReadings){
-        if(!reading.isNull()){
-            reading->id = this->job->generateUniqueId();
-        }
+    foreach(const QPointer<Reading> &reading, this->readings.getReadings()){
+        reading->id = this->job->generateUniqueId();
     }
 
     //feature specific
@@ -846,6 +794,11 @@ void Station::connectSensorControl(){
     QObject::connect(this, &Station::stopConnectionMonitoringStream, this->sensorControl.data(), &SensorControl::stopConnectionMonitoringStream, Qt::AutoConnection);
     QObject::connect(this, &Station::startStatusMonitoringStream, this->sensorControl.data(), &SensorControl::startStatusMonitoringStream, Qt::AutoConnection);
     QObject::connect(this, &Station::stopStatusMonitoringStream, this->sensorControl.data(), &SensorControl::stopStatusMonitoringStream, Qt::AutoConnection);
+    QObject::connect(this, &Station::startWatchWindow, this->sensorControl.data(), &SensorControl::startWatchWindow, Qt::AutoConnection);
+    QObject::connect(this, &Station::stopWatchWindow, this->sensorControl.data(), &SensorControl::stopWatchWindow, Qt::AutoConnection);
+    QObject::connect(this, &Station::setWatchWindowTransformation, this->sensorControl.data(), &SensorControl::setWatchWindowTransformation, Qt::AutoConnection);
+    QObject::connect(this, &Station::setWatchWindowGeometry, this->sensorControl.data(), &SensorControl::setWatchWindowGeometry, Qt::AutoConnection);
+    QObject::connect(this, &Station::setWatchWindowDisplayRate, this->sensorControl.data(), &SensorControl::setWatchWindowDisplayRate, Qt::AutoConnection);
 
     //connect sensor action results
     QObject::connect(this->sensorControl.data(), &SensorControl::commandFinished, this, &Station::commandFinished, Qt::AutoConnection);
@@ -856,6 +809,7 @@ void Station::connectSensorControl(){
     //connect sensor streaming results
     QObject::connect(this->sensorControl.data(), &SensorControl::realTimeReading, this, &Station::realTimeReading, Qt::AutoConnection);
     QObject::connect(this->sensorControl.data(), &SensorControl::realTimeStatus, this, &Station::realTimeStatus, Qt::AutoConnection);
+    QObject::connect(this->sensorControl.data(), &SensorControl::watchWindowReading, this, &Station::watchWindowReading, Qt::AutoConnection);
     QObject::connect(this->sensorControl.data(), &SensorControl::connectionLost, this, &Station::connectionLost, Qt::AutoConnection);
     QObject::connect(this->sensorControl.data(), &SensorControl::connectionReceived, this, &Station::connectionReceived, Qt::AutoConnection);
     QObject::connect(this->sensorControl.data(), &SensorControl::isReadyForMeasurement, this, &Station::isReadyForMeasurement, Qt::AutoConnection);
@@ -900,6 +854,11 @@ void Station::disconnectSensorControl(){
     QObject::disconnect(this, &Station::stopConnectionMonitoringStream, this->sensorControl.data(), &SensorControl::stopConnectionMonitoringStream);
     QObject::disconnect(this, &Station::startStatusMonitoringStream, this->sensorControl.data(), &SensorControl::startStatusMonitoringStream);
     QObject::disconnect(this, &Station::stopStatusMonitoringStream, this->sensorControl.data(), &SensorControl::stopStatusMonitoringStream);
+    QObject::disconnect(this, &Station::startWatchWindow, this->sensorControl.data(), &SensorControl::startWatchWindow);
+    QObject::disconnect(this, &Station::stopWatchWindow, this->sensorControl.data(), &SensorControl::stopWatchWindow);
+    QObject::disconnect(this, &Station::setWatchWindowTransformation, this->sensorControl.data(), &SensorControl::setWatchWindowTransformation);
+    QObject::disconnect(this, &Station::setWatchWindowGeometry, this->sensorControl.data(), &SensorControl::setWatchWindowGeometry);
+    QObject::disconnect(this, &Station::setWatchWindowDisplayRate, this->sensorControl.data(), &SensorControl::setWatchWindowDisplayRate);
 
     //disconnect sensor action results
     QObject::disconnect(this->sensorControl.data(), &SensorControl::commandFinished, this, &Station::commandFinished);
@@ -910,6 +869,7 @@ void Station::disconnectSensorControl(){
     //disconnect sensor streaming results
     QObject::disconnect(this->sensorControl.data(), &SensorControl::realTimeReading, this, &Station::realTimeReading);
     QObject::disconnect(this->sensorControl.data(), &SensorControl::realTimeStatus, this, &Station::realTimeStatus);
+    QObject::disconnect(this->sensorControl.data(), &SensorControl::watchWindowReading, this, &Station::watchWindowReading);
     QObject::disconnect(this->sensorControl.data(), &SensorControl::connectionLost, this, &Station::connectionLost);
     QObject::disconnect(this->sensorControl.data(), &SensorControl::connectionReceived, this, &Station::connectionReceived);
     QObject::disconnect(this->sensorControl.data(), &SensorControl::isReadyForMeasurement, this, &Station::isReadyForMeasurement);
@@ -942,26 +902,8 @@ void Station::addReadings(const int &geomId, const QList<QPointer<Reading> > &re
         reading->setSensorConfiguration(this->getSensorConfiguration());
         reading->setMeasurementConfig(measurementConfig);
 
-        switch(reading->getTypeOfReading()){
-        case eCartesianReading:
-            this->cartesianReadings.append(reading);
-            break;
-        case eDirectionReading:
-            this->directionReadings.append(reading);
-            break;
-        case eDistanceReading:
-            this->distanceReadings.append(reading);
-            break;
-        case ePolarReading:
-            this->polarReadings.append(reading);
-            break;
-        case eLevelReading:
-            this->levelReadings.append(reading);
-            break;
-        case eTemperatureReading:
-            this->temperatureRadings.append(reading);
-            break;
-        }
+        //add reading to the store (tagged with its type)
+        this->readings.add(reading);
 
     }
 
@@ -973,13 +915,50 @@ void Station::addReadings(const int &geomId, const QList<QPointer<Reading> > &re
  */
 void Station::removeReading(const QPointer<Reading> &reading){
 
-    this->cartesianReadings.removeOne(reading);
-    this->directionReadings.removeOne(reading);
-    this->distanceReadings.removeOne(reading);
-    this->polarReadings.removeOne(reading);
-    this->levelReadings.removeOne(reading);
-    this->temperatureRadings.removeOne(reading);
-    this->undefinedReadings.removeOne(reading);
+    this->readings.remove(reading);
+
+}
+
+/*!
+ * \brief Station::addTargetGeometry
+ * Called by Observation whenever one of its target geometries is added
+ * \param geometry
+ */
+void Station::addTargetGeometry(const QPointer<Geometry> &geometry){
+
+    if(geometry.isNull()){
+        return;
+    }
+
+    QMap<int, TargetGeometry>::iterator it = this->targetGeometries.find(geometry->getId());
+    if(it != this->targetGeometries.end()){
+        it.value().numObservations++;
+        return;
+    }
+
+    TargetGeometry target;
+    target.geometry = geometry;
+    target.numObservations = 1;
+    this->targetGeometries.insert(geometry->getId(), target);
+
+}
+
+/*!
+ * \brief Station::removeTargetGeometry
+ * Called by Observation whenever one of its target geometries is removed
+ * \param geometryId
+ */
+void Station::removeTargetGeometry(const int &geometryId){
+
+    QMap<int, TargetGeometry>::iterator it = this->targetGeometries.find(geometryId);
+    if(it == this->targetGeometries.end()){
+        return;
+    }
+
+    it.value().numObservations--;
+    if(it.value().numObservations <= 0){
+        this->targetGeometries.erase(it);
+    }
 
 }
 
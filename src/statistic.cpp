@@ -1,13 +1,51 @@
 #include "statistic.h"
 
+#include <QMutex>
+#include <QMutexLocker>
+
 using namespace oi;
 using namespace oi::math;
 
+namespace oi{
+
+/*!
+ * \brief The StatisticData class
+ * Matrices and residual vector of a statistic (shared between copies of the statistic)
+ */
+class StatisticData : public QSharedData{
+public:
+    StatisticData() : isPDiagonal(false), isPExpanded(false){}
+
+    StatisticData(const StatisticData &copy) : QSharedData(copy), pDiagonal(copy.pDiagonal), isPDiagonal(copy.isPDiagonal),
+        isPExpanded(false), qxx(copy.qxx), v(copy.v){
+
+        //an expanded diagonal is not copied but expanded again on request
+        if(!copy.isPDiagonal){
+            this->p = copy.p;
+        }
+
+    }
+
+    OiVec pDiagonal; //weights if p is a diagonal matrix
+    bool isPDiagonal;
+
+    mutable QMutex mutex; //guards the expansion of a diagonal p
+    mutable bool isPExpanded;
+    mutable OiMat p; //full weight matrix (or the expanded diagonal)
+
+    OiMat qxx;
+    OiVec v;
+};
+
+}
+
 /*!
  * \brief Statistic::Statistic
  */
 Statistic::Statistic(){
 
+    this->d = new StatisticData();
+
     this->isValid = false;
 
     this->s0_apriori = 0.0;
@@ -31,9 +69,15 @@ Statistic::Statistic(const Statistic &copy){
     //this->displayResiduals = copy.displayResiduals;
     this->isValid = copy.isValid;
 
-    this->p.replace(copy.p);
-    this->qxx.replace(copy.qxx);
-    this->v.replace(copy.v);
+    //share the matrices
+    this->d = copy.d;
+
+}
+
+/*!
+ * \brief Statistic::~Statistic
+ */
+Statistic::~Statistic(){
 
 }
 
@@ -52,9 +96,8 @@ Statistic& Statistic::operator =(const Statistic &other){
     //this->displayResiduals = other.displayResiduals;
     this->isValid = other.isValid;
 
-    this->p.replace(other.p);
-    this->qxx.replace(other.qxx);
-    this->v.replace(other.v);
+    //share the matrices
+    this->d = other.d;
 
     return *this;
 
@@ -89,11 +132,8 @@ void Statistic::reset(){
     this->stdev = 0.0;
     this->formError = 0.0;
 
-    OiMat resetMat;
-    this->p.replace(resetMat);
-    this->qxx.replace(resetMat);
-    OiVec resetVec;
-    this->v.replace(resetVec);
+    //release the matrices (other copies keep them)
+    this->d = new StatisticData();
 
     this->displayResidualsMap.clear();
 
@@ -149,21 +189,119 @@ void Statistic::setStdev(const double &stdev){
 
 /*!
  * \brief Statistic::getP
+ * Returns the full weight matrix. A diagonal weight matrix is expanded on the first request,
+ * use getPDiagonal if only the weights are needed
  * \return
  */
 const OiMat &Statistic::getP() const{
-    return this->p;
+    if(this->d->isPDiagonal){
+        QMutexLocker locker(&this->d->mutex);
+        int n = this->d->pDiagonal.getSize();
+        if(!this->d->isPExpanded && n > 0){
+            OiMat p(n, n);
+            for(int i = 0; i < n; i++){
+                p.setAt(i, i, this->d->pDiagonal.getAt(i));
+            }
+            this->d->p = p;
+            this->d->isPExpanded = true;
+        }
+    }
+    return this->d->p;
 }
 
 /*!
  * \brief Statistic::setP
+ * A diagonal matrix is stored as its diagonal
  * \param p
  */
 void Statistic::setP(const OiMat &p){
-    if( (this->p.getRowCount() == p.getRowCount() &&this->p.getColCount() == p.getColCount())
-            || (this->p.getRowCount() == 0 && this->p.getColCount() == 0) ){
-        this->p = p;
+
+    //check dimension (read without detaching the shared matrices)
+    const StatisticData *data = this->d.constData();
+    int rowCount = data->isPDiagonal ? data->pDiagonal.getSize() : data->p.getRowCount();
+    int colCount = data->isPDiagonal ? data->pDiagonal.getSize() : data->p.getColCount();
+    if( !((rowCount == p.getRowCount() && colCount == p.getColCount()) || (rowCount == 0 && colCount == 0)) ){
+        return;
+    }
+
+    //check wether p is a diagonal matrix
+    bool isDiagonal = p.getRowCount() > 0 && p.getRowCount() == p.getColCount();
+    for(int i = 0; isDiagonal && i < p.getRowCount(); i++){
+        for(int j = 0; j < p.getColCount(); j++){
+            if(i != j && p.getAt(i, j) != 0.0){
+                isDiagonal = false;
+                break;
+            }
+        }
+    }
+
+    if(isDiagonal){
+        OiVec diagonal(p.getRowCount());
+        for(int i = 0; i < p.getRowCount(); i++){
+            diagonal.setAt(i, p.getAt(i, i));
+        }
+        this->setPDiagonal(diagonal);
+        return;
+    }
+
+    this->d->p = p;
+    this->d->pDiagonal = OiVec();
+    this->d->isPDiagonal = false;
+    this->d->isPExpanded = false;
+
+}
+
+/*!
+ * \brief Statistic::getIsPDiagonal
+ * \return
+ */
+bool Statistic::getIsPDiagonal() const{
+    return this->d->isPDiagonal;
+}
+
+/*!
+ * \brief Statistic::getPDiagonal
+ * Returns the diagonal of the weight matrix (without expanding a diagonal weight matrix)
+ * \return
+ */
+OiVec Statistic::getPDiagonal() const{
+
+    if(this->d->isPDiagonal){
+        return this->d->pDiagonal;
+    }
+
+    int n = qMin(this->d->p.getRowCount(), this->d->p.getColCount());
+    if(n == 0){
+        return OiVec();
     }
+    OiVec diagonal(n);
+    for(int i = 0; i < n; i++){
+        diagonal.setAt(i, this->d->p.getAt(i, i));
+    }
+    return diagonal;
+
+}
+
+/*!
+ * \brief Statistic::setPDiagonal
+ * Sets a diagonal weight matrix by its diagonal
+ * \param p
+ */
+void Statistic::setPDiagonal(const OiVec &p){
+
+    //check dimension (read without detaching the shared matrices)
+    const StatisticData *data = this->d.constData();
+    int rowCount = data->isPDiagonal ? data->pDiagonal.getSize() : data->p.getRowCount();
+    int colCount = data->isPDiagonal ? data->pDiagonal.getSize() : data->p.getColCount();
+    if( !((rowCount == p.getSize() && colCount == p.getSize()) || (rowCount == 0 && colCount == 0)) ){
+        return;
+    }
+
+    this->d->pDiagonal = p;
+    this->d->p = OiMat();
+    this->d->isPDiagonal = true;
+    this->d->isPExpanded = false;
+
 }
 
 /*!
@@ -171,7 +309,7 @@ void Statistic::setP(const OiMat &p){
  * \return
  */
 const OiMat &Statistic::getQxx() const{
-    return this->qxx;
+    return this->d->qxx;
 }
 
 /*!
@@ -179,10 +317,30 @@ const OiMat &Statistic::getQxx() const{
  * \param qxx
  */
 void Statistic::setQxx(const OiMat &qxx){
-    if( (this->qxx.getRowCount() == qxx.getRowCount() &&this->qxx.getColCount() == qxx.getColCount())
-            || (this->qxx.getRowCount() == 0 && this->qxx.getColCount() == 0) ){
-        this->qxx = qxx;
+    const StatisticData *data = this->d.constData();
+    if( (data->qxx.getRowCount() == qxx.getRowCount() && data->qxx.getColCount() == qxx.getColCount())
+            || (data->qxx.getRowCount() == 0 && data->qxx.getColCount() == 0) ){
+        this->d->qxx = qxx;
+    }
+}
+
+/*!
+ * \brief Statistic::getQxxDiagonal
+ * Returns the variances of the unknown parameters
+ * \return
+ */
+OiVec Statistic::getQxxDiagonal() const{
+
+    int n = qMin(this->d->qxx.getRowCount(), this->d->qxx.getColCount());
+    if(n == 0){
+        return OiVec();
+    }
+    OiVec diagonal(n);
+    for(int i = 0; i < n; i++){
+        diagonal.setAt(i, this->d->qxx.getAt(i, i));
     }
+    return diagonal;
+
 }
 
 /*!
@@ -190,7 +348,7 @@ void Statistic::setQxx(const OiMat &qxx){
  * \return
  */
 const OiVec &Statistic::getV() const{
-    return this->v;
+    return this->d->v;
 }
 
 /*!
@@ -198,8 +356,9 @@ const OiVec &Statistic::getV() const{
  * \param v
  */
 void Statistic::setV(const OiVec &v){
-    if(this->v.getSize() == v.getSize() || this->v.getSize() == 0){
-        this->v = v;
+    const StatisticData *data = this->d.constData();
+    if(data->v.getSize() == v.getSize() || data->v.getSize() == 0){
+        this->d->v = v;
     }
 }
 
@@ -239,3 +398,16 @@ void Statistic::setFormError(const double &formError) {
 const double &Statistic::getFormError() const {
     return this->formError;
 }
+
+/*!
+ * \brief Statistic::getMemoryUsage
+ * Returns the approximate size of the matrices, vectors and display residuals [bytes].
+ * Matrices that are shared with other copies are included, a diagonal weight matrix that was expanded by getP is not
+ * \return
+ */
+qint64 Statistic::getMemoryUsage() const{
+    const StatisticData *data = this->d.constData();
+    qint64 numValues = data->isPDiagonal ? (qint64)data->pDiagonal.getSize() : (qint64)data->p.getRowCount() * data->p.getColCount();
+    numValues += (qint64)data->qxx.getRowCount() * data->qxx.getColCount() + data->v.getSize();
+    return numValues * sizeof(double) + (qint64)this->displayResidualsMap.size() * sizeof(Residual);
+}
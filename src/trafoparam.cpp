@@ -2,6 +2,7 @@
 
 #include "oijob.h"
 #include "featurewrapper.h"
+#include "profiler.h"
 
 using namespace oi;
 using namespace oi::math;
@@ -478,6 +479,8 @@ void TrafoParam::recalc(){
  */
 QDomElement TrafoParam::toOpenIndyXML(QDomDocument &xmlDoc){
 
+    OI_PROFILE_SCOPE("TrafoParam::toOpenIndyXML");
+
     QDomElement trafoParam = Feature::toOpenIndyXML(xmlDoc);
 
     if(trafoParam.isNull()){
@@ -522,6 +525,8 @@ QDomElement TrafoParam::toOpenIndyXML(QDomDocument &xmlDoc){
  */
 bool TrafoParam::fromOpenIndyXML(QDomElement &xmlElem){
 
+    OI_PROFILE_SCOPE("TrafoParam::fromOpenIndyXML");
+
     bool result = Feature::fromOpenIndyXML(xmlElem);
 
     if(result){
@@ -0,0 +1,268 @@
+#include "watchwindowengine.h"
+
+#include <QtCore/qmath.h>
+
+#include "featurewrapper.h"
+
+using namespace oi;
+
+/*!
+ * \brief WatchWindowEngine::WatchWindowEngine
+ * \param parent
+ */
+WatchWindowEngine::WatchWindowEngine(QObject *parent) : QObject(parent), isStarted(false), geometry(0), geometryId(-1),
+    displayRate(25), numSamples(0){
+
+    //identity
+    for(int i = 0; i < 12; i++){
+        this->trafo[i] = (i % 5 == 0) ? 1.0 : 0.0;
+    }
+
+}
+
+/*!
+ * \brief WatchWindowEngine::~WatchWindowEngine
+ */
+WatchWindowEngine::~WatchWindowEngine(){
+    if(this->geometry != 0){
+        delete this->geometry;
+    }
+}
+
+/*!
+ * \brief WatchWindowEngine::getIsStarted
+ * \return
+ */
+bool WatchWindowEngine::getIsStarted(){
+    QMutexLocker locker(&this->mutex);
+    return this->isStarted;
+}
+
+/*!
+ * \brief WatchWindowEngine::start
+ * Starts processing the stream samples passed to addReading
+ */
+void WatchWindowEngine::start(){
+    QMutexLocker locker(&this->mutex);
+    this->isStarted = true;
+    this->numSamples = 0;
+    this->publishTimer.invalidate();
+}
+
+/*!
+ * \brief WatchWindowEngine::stop
+ */
+void WatchWindowEngine::stop(){
+    QMutexLocker locker(&this->mutex);
+    this->isStarted = false;
+}
+
+/*!
+ * \brief WatchWindowEngine::setTransformation
+ * Sets the homogeneous 4x4 matrix that transforms the readings of the sensor into the active coordinate system.
+ * The matrix is cached, so that a sample costs one matrix vector product
+ * \param trafo
+ * \return
+ */
+bool WatchWindowEngine::setTransformation(const OiMat &trafo){
+
+    //check matrix
+    if(trafo.getRowCount() != 4 || trafo.getColCount() != 4){
+        return false;
+    }
+
+    QMutexLocker locker(&this->mutex);
+    for(int i = 0; i < 3; i++){
+        for(int j = 0; j < 4; j++){
+            this->trafo[i * 4 + j] = trafo.getAt(i, j);
+        }
+    }
+
+    return true;
+
+}
+
+/*!
+ * \brief WatchWindowEngine::setGeometry
+ * Sets the geometry the deviations are computed to. Pass a null pointer to only transform the readings.
+ * Call this method in the thread of the feature whenever the active feature changes or has been recalculated
+ * \param feature
+ */
+void WatchWindowEngine::setGeometry(const QPointer<FeatureWrapper> &feature){
+
+    //copy the geometry before the engine is locked
+    Geometry *geometry = WatchWindowEngine::copyGeometry(feature);
+
+    this->mutex.lock();
+    Geometry *previous = this->geometry;
+    this->geometry = geometry;
+    this->geometryId = geometry != 0 ? geometry->getId() : -1;
+    this->mutex.unlock();
+
+    if(previous != 0){
+        delete previous;
+    }
+
+}
+
+/*!
+ * \brief WatchWindowEngine::getDisplayRate
+ * \return
+ */
+int WatchWindowEngine::getDisplayRate(){
+    QMutexLocker locker(&this->mutex);
+    return this->displayRate;
+}
+
+/*!
+ * \brief WatchWindowEngine::setDisplayRate
+ * Sets the maximum number of readings per second that are published (independent of the stream rate of the sensor)
+ * \param displayRate
+ */
+void WatchWindowEngine::setDisplayRate(const int &displayRate){
+    if(displayRate <= 0){
+        return;
+    }
+    QMutexLocker locker(&this->mutex);
+    this->displayRate = displayRate;
+}
+
+/*!
+ * \brief WatchWindowEngine::addReading
+ * Processes one stream sample. Samples that arrive before the next display interval are only counted,
+ * the published reading contains the input values plus:
+ * x, y, z in the active coordinate system, d (deviation from the active geometry), dx, dy, dz (point - foot point),
+ * geometry (id of the active geometry) and samples (number of stream samples since the last published reading)
+ * \param reading
+ */
+void WatchWindowEngine::addReading(const QVariantMap &reading){
+
+    QMutexLocker locker(&this->mutex);
+
+    if(!this->isStarted){
+        return;
+    }
+    this->numSamples++;
+
+    //decimate to display rate
+    if(this->publishTimer.isValid() && this->publishTimer.elapsed() < 1000 / this->displayRate){
+        return;
+    }
+
+    //get position in sensor system
+    double position[3];
+    if(!this->getPosition(reading, position)){
+        return;
+    }
+    this->publishTimer.start();
+
+    //transform into the active system
+    double xyz[3];
+    for(int i = 0; i < 3; i++){
+        const double *row = this->trafo + i * 4;
+        xyz[i] = row[0] * position[0] + row[1] * position[1] + row[2] * position[2] + row[3];
+    }
+
+    QVariantMap result = reading;
+    result.insert("x", xyz[0]);
+    result.insert("y", xyz[1]);
+    result.insert("z", xyz[2]);
+
+    //deviation from the active geometry
+    if(this->geometry != 0){
+        double deviation = 0.0;
+        double footPoint[3];
+        if(this->geometry->computeDeviations(xyz, 1, &deviation, footPoint)){
+            result.insert("d", deviation);
+            result.insert("dx", xyz[0] - footPoint[0]);
+            result.insert("dy", xyz[1] - footPoint[1]);
+            result.insert("dz", xyz[2] - footPoint[2]);
+        }
+        result.insert("geometry", this->geometryId);
+    }
+
+    result.insert("samples", this->numSamples);
+    this->numSamples = 0;
+
+    locker.unlock();
+
+    emit this->watchWindowReading(result);
+
+}
+
+/*!
+ * \brief WatchWindowEngine::getPosition
+ * Reads the position of a cartesian (x, y, z) or polar (azimuth, zenith, distance) stream sample
+ * \param reading
+ * \param xyz
+ * \return
+ */
+bool WatchWindowEngine::getPosition(const QVariantMap &reading, double *xyz) const{
+
+    bool isValid[3] = {false, false, false};
+
+    //cartesian
+    QVariantMap::const_iterator x = reading.constFind("x");
+    if(x != reading.constEnd()){
+        xyz[0] = x.value().toDouble(&isValid[0]);
+        xyz[1] = reading.value("y").toDouble(&isValid[1]);
+        xyz[2] = reading.value("z").toDouble(&isValid[2]);
+        return isValid[0] && isValid[1] && isValid[2];
+    }
+
+    //polar
+    QVariantMap::const_iterator distance = reading.constFind("distance");
+    if(distance != reading.constEnd()){
+        double d = distance.value().toDouble(&isValid[0]);
+        double azimuth = reading.value("azimuth").toDouble(&isValid[1]);
+        double zenith = reading.value("zenith").toDouble(&isValid[2]);
+        xyz[0] = d * qSin(zenith) * qCos(azimuth);
+        xyz[1] = d * qSin(zenith) * qSin(azimuth);
+        xyz[2] = d * qCos(zenith);
+        return isValid[0] && isValid[1] && isValid[2];
+    }
+
+    return false;
+
+}
+
+/*!
+ * \brief WatchWindowEngine::copyGeometry
+ * Returns a copy of the given geometry that is owned by the caller
+ * or 0 if the feature is no solved geometry that supports deviations
+ * \param feature
+ * \return
+ */
+Geometry *WatchWindowEngine::copyGeometry(const QPointer<FeatureWrapper> &feature){
+
+    //check feature
+    if(feature.isNull() || feature->getGeometry().isNull() || !feature->getGeometry()->getIsSolved()){
+        return 0;
+    }
+
+    switch(feature->getFeatureTypeEnum()){
+    case eCircleFeature:
+        return new Circle(*feature->getCircle().data());
+    case eConeFeature:
+        return new Cone(*feature->getCone().data());
+    case eCylinderFeature:
+        return new Cylinder(*feature->getCylinder().data());
+    case eEllipsoidFeature:
+        return new Ellipsoid(*feature->getEllipsoid().data());
+    case eLineFeature:
+        return new Line(*feature->getLine().data());
+    case eNurbsFeature:
+        return new Nurbs(*feature->getNurbs().data());
+    case ePlaneFeature:
+        return new Plane(*feature->getPlane().data());
+    case ePointFeature:
+        return new Point(*feature->getPoint().data());
+    case eSphereFeature:
+        return new Sphere(*feature->getSphere().data());
+    case eTorusFeature:
+        return new Torus(*feature->getTorus().data());
+    default:
+        return 0;
+    }
+
+}
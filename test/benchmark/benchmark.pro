@@ -0,0 +1,42 @@
+#-------------------------------------------------
+#
+# Microbenchmarks of fit functions, transformations and job operations
+#
+#-------------------------------------------------
+CONFIG += c++11
+QT       += testlib
+
+QT       += core xml
+
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+SOURCES += tst_benchmark.cpp
+
+DEFINES += SRCDIR=$$shell_quote($$PWD)
+
+include(../../include.pri)
+
+include(../../build/dependencies.pri)
+
+include(../../build/version.pri)
+
+CONFIG(debug, debug|release) {
+    BUILD_DIR=debug
+} else {
+    BUILD_DIR=release
+}
+
+# the results are written as json to the file OI_BENCHMARK_REPORT (default: benchmark.json in the working directory)
+QMAKE_EXTRA_TARGETS += run-benchmark
+win32 {
+run-benchmark.commands = \
+   set OI_BENCHMARK_REPORT=$$system_path(../reports/$${TARGET}.json) && \
+   $$shell_quote($$OUT_PWD/$$BUILD_DIR/$$TARGET) -o $$system_path(../reports/$${TARGET}.xml),xml
+} else {
+run-benchmark.commands = \
+   OI_BENCHMARK_REPORT=$$system_path(../reports/$${TARGET}.json) \
+   $$shell_quote($$OUT_PWD/$$BUILD_DIR/$$TARGET) -o $$system_path(../reports/$${TARGET}.xml),xml
+}
@@ -0,0 +1,683 @@
+#include <QString>
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDomDocument>
+#include <random>
+
+#include "chooselalib.h"
+#include "fitfunction.h"
+#include "reading.h"
+#include "trafoparam.h"
+#include "featurecontainer.h"
+#include "featurewrapper.h"
+#include "oijob.h"
+#include "station.h"
+#include "jobgenerator.h"
+
+using namespace oi;
+
+/*!
+ * \brief The BenchmarkFitFunction class
+ * Makes the protected best fit utilities callable from the benchmark
+ */
+class BenchmarkFitFunction : public FitFunction, public BestFitPlaneUtil, public BestFitCircleUtil, public BestFitCylinderUtil
+{
+public:
+    bool fitPlane(OiVec &centroid, OiVec &normal, double &eVal, const QList<IdPoint> &points){
+        return this->bestFitPlane(centroid, normal, eVal, points);
+    }
+    bool fitCircle(Circle &circle, const QList<IdPoint> &points){
+        return this->bestFitCircleInPlane(this, circle, points, points);
+    }
+    bool fitCylinder(Cylinder &cylinder, const QList<IdPoint> &points){
+        return this->bestFitCylinder(this, cylinder, points, points);
+    }
+};
+
+/*!
+ * \brief The Measurement class
+ * Repeats a benchmarked operation until a minimum time has elapsed (at least once).
+ * Only the code between start and stop is measured, so that set up and clean up are excluded
+ *
+ * Measurement m;
+ * while(m.next()){
+ *     //set up
+ *     m.start();
+ *     //operation
+ *     m.stop();
+ *     //clean up
+ * }
+ */
+class Measurement
+{
+public:
+    Measurement() : elapsed(0), iterations(0){}
+
+    bool next() const{
+        return this->iterations == 0 || (this->elapsed < minimumTime && this->iterations < maximumIterations);
+    }
+
+    void start(){
+        this->timer.start();
+    }
+
+    void stop(){
+        this->elapsed += this->timer.nsecsElapsed();
+        this->iterations++;
+    }
+
+    qint64 elapsed; //ns
+    int iterations;
+
+    static const qint64 minimumTime = 200000000; //ns
+    static const int maximumIterations = 100000;
+
+private:
+    QElapsedTimer timer;
+};
+
+class BenchmarkTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    BenchmarkTest();
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void benchmarkBestFitPlane_data();
+    void benchmarkBestFitPlane();
+    void benchmarkBestFitCircle_data();
+    void benchmarkBestFitCircle();
+    void benchmarkBestFitCylinder_data();
+    void benchmarkBestFitCylinder();
+
+    void benchmarkReadingToCartesian_data();
+    void benchmarkReadingToCartesian();
+    void benchmarkTrafoParamSetParameters_data();
+    void benchmarkTrafoParamSetParameters();
+
+    void benchmarkAddMeasurementResults_data();
+    void benchmarkAddMeasurementResults();
+    void benchmarkFeatureContainer_data();
+    void benchmarkFeatureContainer();
+
+    void benchmarkXml_data();
+    void benchmarkXml();
+
+    void benchmarkGeneratedJob_data();
+    void benchmarkGeneratedJob();
+
+private:
+    void addCounts(const int &maxCount);
+    void addResult(const QString &name, const int &count, const Measurement &measurement);
+
+    QList<IdPoint> createPlanePoints(const int &count);
+    QList<IdPoint> createCirclePoints(const int &count);
+    QList<IdPoint> createCylinderPoints(const int &count);
+
+    std::mt19937 random;
+    QJsonArray results;
+};
+
+BenchmarkTest::BenchmarkTest() : random(42)
+{
+}
+
+void BenchmarkTest::initTestCase() {
+    ChooseLALib::setLinearAlgebra(ChooseLALib::Armadillo);
+}
+
+/*!
+ * \brief BenchmarkTest::cleanupTestCase
+ * Writes all results as json to the file OI_BENCHMARK_REPORT (default: benchmark.json in the working directory)
+ */
+void BenchmarkTest::cleanupTestCase() {
+
+    QString fileName = qgetenv("OI_BENCHMARK_REPORT");
+    if(fileName.isEmpty()){
+        fileName = "benchmark.json";
+    }
+
+    QJsonObject report;
+    report.insert("date", QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+    report.insert("qt", QString(qVersion()));
+    report.insert("results", this->results);
+
+    QFile file(fileName);
+    QVERIFY2(file.open(QIODevice::WriteOnly | QIODevice::Truncate), qPrintable(QString("cannot write %1").arg(fileName)));
+    file.write(QJsonDocument(report).toJson());
+    file.close();
+
+    qDebug() << "benchmark results written to" << QFileInfo(file).absoluteFilePath();
+
+}
+
+/*!
+ * \brief BenchmarkTest::addCounts
+ * Adds the rows 10, 100, ... up to maxCount (limited by the environment variable OI_BENCHMARK_MAX_COUNT)
+ * \param maxCount
+ */
+void BenchmarkTest::addCounts(const int &maxCount) {
+
+    QTest::addColumn<int>("count");
+
+    int limit = maxCount;
+    bool isValid = false;
+    int envLimit = qgetenv("OI_BENCHMARK_MAX_COUNT").toInt(&isValid);
+    if(isValid && envLimit > 0 && envLimit < limit){
+        limit = envLimit;
+    }
+
+    for(int count = 10; count <= limit; count *= 10){
+        QTest::newRow(qPrintable(QString::number(count))) << count;
+    }
+
+}
+
+/*!
+ * \brief BenchmarkTest::addResult
+ * \param name
+ * \param count
+ * \param measurement
+ */
+void BenchmarkTest::addResult(const QString &name, const int &count, const Measurement &measurement) {
+
+    double nsPerIteration = (double)measurement.elapsed / (double)measurement.iterations;
+
+    QJsonObject result;
+    result.insert("name", name);
+    result.insert("count", count);
+    result.insert("iterations", measurement.iterations);
+    result.insert("totalNs", (double)measurement.elapsed);
+    result.insert("nsPerIteration", nsPerIteration);
+    result.insert("nsPerElement", nsPerIteration / (double)count);
+    this->results.append(result);
+
+    qDebug() << name << count << QString("%1 ms").arg(nsPerIteration / 1000000.0, 0, 'f', 3);
+
+}
+
+/*!
+ * \brief BenchmarkTest::createPlanePoints
+ * Points of the plane z = 0.1 * x - 0.2 * y + 3 with noise
+ * \param count
+ * \return
+ */
+QList<IdPoint> BenchmarkTest::createPlanePoints(const int &count) {
+    std::uniform_real_distribution<double> position(-100.0, 100.0);
+    std::normal_distribution<double> noise(0.0, 0.01);
+
+    QList<IdPoint> points;
+    points.reserve(count);
+    for(int i = 0; i < count; i++){
+        IdPoint point;
+        point.id = i + 1;
+        point.xyz = OiVec(4);
+        double x = position(this->random);
+        double y = position(this->random);
+        point.xyz.setAt(0, x);
+        point.xyz.setAt(1, y);
+        point.xyz.setAt(2, 0.1 * x - 0.2 * y + 3.0 + noise(this->random));
+        point.xyz.setAt(3, 1.0);
+        points.append(point);
+    }
+    return points;
+}
+
+/*!
+ * \brief BenchmarkTest::createCirclePoints
+ * Points of a circle in the xy plane (center 1, 2, 3 and radius 50) with noise
+ * \param count
+ * \return
+ */
+QList<IdPoint> BenchmarkTest::createCirclePoints(const int &count) {
+    std::normal_distribution<double> noise(0.0, 0.01);
+
+    QList<IdPoint> points;
+    points.reserve(count);
+    for(int i = 0; i < count; i++){
+        double angle = 2.0 * PI * (double)i / (double)count;
+        IdPoint point;
+        point.id = i + 1;
+        point.xyz = OiVec(4);
+        point.xyz.setAt(0, 1.0 + 50.0 * qCos(angle) + noise(this->random));
+        point.xyz.setAt(1, 2.0 + 50.0 * qSin(angle) + noise(this->random));
+        point.xyz.setAt(2, 3.0 + noise(this->random));
+        point.xyz.setAt(3, 1.0);
+        points.append(point);
+    }
+    return points;
+}
+
+/*!
+ * \brief BenchmarkTest::createCylinderPoints
+ * Points of a cylinder along the z axis (radius 50) with noise.
+ * Two consecutive points lie on the same line of the cylinder, so that the first two points approximate the axis
+ * \param count
+ * \return
+ */
+QList<IdPoint> BenchmarkTest::createCylinderPoints(const int &count) {
+    std::normal_distribution<double> noise(0.0, 0.01);
+
+    QList<IdPoint> points;
+    points.reserve(count);
+    for(int i = 0; i < count; i++){
+        double angle = 2.0 * PI * (double)(i / 2) / (double)((count + 1) / 2);
+        IdPoint point;
+        point.id = i + 1;
+        point.xyz = OiVec(4);
+        point.xyz.setAt(0, 50.0 * qCos(angle) + noise(this->random));
+        point.xyz.setAt(1, 50.0 * qSin(angle) + noise(this->random));
+        point.xyz.setAt(2, (i % 2 == 0 ? -100.0 : 100.0) + noise(this->random));
+        point.xyz.setAt(3, 1.0);
+        points.append(point);
+    }
+    return points;
+}
+
+void BenchmarkTest::benchmarkBestFitPlane_data() {
+    this->addCounts(1000000);
+}
+
+void BenchmarkTest::benchmarkBestFitPlane() {
+    QFETCH(int, count);
+
+    QList<IdPoint> points = this->createPlanePoints(count);
+
+    Measurement measurement;
+    bool isSolved = true;
+    while(measurement.next()){
+        BenchmarkFitFunction function;
+        OiVec centroid(4);
+        OiVec normal(3);
+        double eVal = 0.0;
+
+        measurement.start();
+        isSolved = function.fitPlane(centroid, normal, eVal, points) && isSolved;
+        measurement.stop();
+    }
+
+    QVERIFY(isSolved);
+    this->addResult("BestFitPlaneUtil::bestFitPlane", count, measurement);
+}
+
+void BenchmarkTest::benchmarkBestFitCircle_data() {
+    this->addCounts(1000000);
+}
+
+void BenchmarkTest::benchmarkBestFitCircle() {
+    QFETCH(int, count);
+
+    QList<IdPoint> points = this->createCirclePoints(count);
+
+    Measurement measurement;
+    bool isSolved = true;
+    while(measurement.next()){
+        BenchmarkFitFunction function;
+        Circle circle(false);
+
+        measurement.start();
+        isSolved = function.fitCircle(circle, points) && isSolved;
+        measurement.stop();
+    }
+
+    QVERIFY(isSolved);
+    this->addResult("BestFitCircleUtil::bestFitCircleInPlane", count, measurement);
+}
+
+void BenchmarkTest::benchmarkBestFitCylinder_data() {
+    //the cylinder adjustment sets up a dense normal equation system of the size of the number of points
+    this->addCounts(1000);
+}
+
+void BenchmarkTest::benchmarkBestFitCylinder() {
+    QFETCH(int, count);
+
+    QList<IdPoint> points = this->createCylinderPoints(count);
+
+    Measurement measurement;
+    bool isSolved = true;
+    while(measurement.next()){
+        BenchmarkFitFunction function;
+        Cylinder cylinder(false);
+
+        measurement.start();
+        isSolved = function.fitCylinder(cylinder, points) && isSolved;
+        measurement.stop();
+    }
+
+    QVERIFY(isSolved);
+    this->addResult("BestFitCylinderUtil::bestFitCylinder", count, measurement);
+}
+
+void BenchmarkTest::benchmarkReadingToCartesian_data() {
+    this->addCounts(1000000);
+}
+
+void BenchmarkTest::benchmarkReadingToCartesian() {
+    QFETCH(int, count);
+
+    std::uniform_real_distribution<double> angle(0.0, PI);
+    std::uniform_real_distribution<double> distance(1.0, 100.0);
+    QVector<double> polar(3 * count);
+    for(int i = 0; i < count; i++){
+        polar[3 * i] = 2.0 * angle(this->random);
+        polar[3 * i + 1] = angle(this->random);
+        polar[3 * i + 2] = distance(this->random);
+    }
+
+    Measurement measurement;
+    double sum = 0.0;
+    while(measurement.next()){
+        measurement.start();
+        for(int i = 0; i < count; i++){
+            OiVec xyz = Reading::toCartesian(polar[3 * i], polar[3 * i + 1], polar[3 * i + 2]);
+            sum += xyz.getAt(2);
+        }
+        measurement.stop();
+    }
+
+    QVERIFY(!qIsNaN(sum));
+    this->addResult("Reading::toCartesian", count, measurement);
+}
+
+void BenchmarkTest::benchmarkTrafoParamSetParameters_data() {
+    this->addCounts(1000000);
+}
+
+void BenchmarkTest::benchmarkTrafoParamSetParameters() {
+    QFETCH(int, count);
+
+    TrafoParam trafoParam;
+    OiVec rotation(3);
+    OiVec translation(3);
+    OiVec scale(3);
+    for(int i = 0; i < 3; i++){
+        translation.setAt(i, 10.0 * (i + 1));
+        scale.setAt(i, 1.0001);
+    }
+
+    Measurement measurement;
+    bool isSet = true;
+    while(measurement.next()){
+        measurement.start();
+        for(int i = 0; i < count; i++){
+            rotation.setAt(2, 0.001 * (i % 1000));
+            isSet = trafoParam.setTransformationParameters(rotation, translation, scale) && isSet;
+        }
+        measurement.stop();
+    }
+
+    QVERIFY(isSet);
+    this->addResult("TrafoParam::setTransformationParameters", count, measurement);
+}
+
+void BenchmarkTest::benchmarkAddMeasurementResults_data() {
+    //each reading creates an observation object
+    this->addCounts(100000);
+}
+
+void BenchmarkTest::benchmarkAddMeasurementResults() {
+    QFETCH(int, count);
+
+    Measurement measurement;
+    int numObservations = 0;
+    while(measurement.next()){
+
+        //set up a job with an active station and one actual point
+        OiJob job;
+
+        FeatureAttributes stationAttr;
+        stationAttr.typeOfFeature = eStationFeature;
+        stationAttr.name = "STATION01";
+        stationAttr.count = 1;
+        QList<QPointer<FeatureWrapper> > stations = job.addFeatures(stationAttr);
+        QCOMPARE(stations.size(), 1);
+        stations.first()->getStation()->setActiveStationState(true);
+
+        FeatureAttributes pointAttr;
+        pointAttr.typeOfFeature = ePointFeature;
+        pointAttr.name = "P1";
+        pointAttr.count = 1;
+        pointAttr.isActual = true;
+        QList<QPointer<FeatureWrapper> > points = job.addFeatures(pointAttr);
+        QCOMPARE(points.size(), 1);
+
+        QList<QPointer<Reading> > readings;
+        for(int i = 0; i < count; i++){
+            ReadingCartesian cartesian;
+            cartesian.isValid = true;
+            cartesian.xyz.setAt(0, 1.0 + 0.001 * i);
+            cartesian.xyz.setAt(1, 2.0);
+            cartesian.xyz.setAt(2, 3.0);
+            readings.append(new Reading(cartesian));
+        }
+
+        measurement.start();
+        job.addMeasurementResults(points.first()->getGeometry()->getId(), readings);
+        measurement.stop();
+
+        numObservations = points.first()->getGeometry()->getObservations().size();
+
+    }
+
+    QCOMPARE(numObservations, count);
+    this->addResult("OiJob::addMeasurementResults", count, measurement);
+}
+
+void BenchmarkTest::benchmarkFeatureContainer_data() {
+    this->addCounts(100000);
+}
+
+void BenchmarkTest::benchmarkFeatureContainer() {
+    QFETCH(int, count);
+
+    Measurement add, lookupId, lookupName, lookupPrefix, remove;
+    int numFound = 0;
+    while(add.next()){
+
+        FeatureContainer container;
+        QList<QPointer<FeatureWrapper> > features;
+        for(int i = 0; i < count; i++){
+            Point *point = new Point(i + 1, false, Position(i, 0.0, 0.0));
+            point->setFeatureName(QString("P%1").arg(i + 1));
+            features.append(point->getFeatureWrapper());
+        }
+
+        //add
+        add.start();
+        foreach(const QPointer<FeatureWrapper> &feature, features){
+            container.addFeature(feature);
+        }
+        add.stop();
+
+        //lookup by id
+        numFound = 0;
+        lookupId.start();
+        for(int i = 0; i < count; i++){
+            if(!container.getFeatureById(i + 1).isNull()){
+                numFound++;
+            }
+        }
+        lookupId.stop();
+        QCOMPARE(numFound, count);
+
+        //lookup by name
+        numFound = 0;
+        lookupName.start();
+        for(int i = 0; i < count; i++){
+            numFound += container.getFeaturesByName(QString("P%1").arg(i + 1)).size();
+        }
+        lookupName.stop();
+        QCOMPARE(numFound, count);
+
+        //lookup by name prefix (first page of 100 features)
+        lookupPrefix.start();
+        for(int i = 0; i < count; i++){
+            container.getFeaturesByNamePrefix("p1", 0, 100);
+        }
+        lookupPrefix.stop();
+
+        //remove
+        remove.start();
+        for(int i = 0; i < count; i++){
+            container.removeFeature(i + 1);
+        }
+        remove.stop();
+        QCOMPARE(container.getFeatureCount(), 0);
+
+        foreach(const QPointer<FeatureWrapper> &feature, features){
+            delete feature->getFeature().data();
+            delete feature.data();
+        }
+
+    }
+
+    this->addResult("FeatureContainer::addFeature", count, add);
+    this->addResult("FeatureContainer::getFeatureById", count, lookupId);
+    this->addResult("FeatureContainer::getFeaturesByName", count, lookupName);
+    this->addResult("FeatureContainer::getFeaturesByNamePrefix", count, lookupPrefix);
+    this->addResult("FeatureContainer::removeFeature", count, remove);
+}
+
+void BenchmarkTest::benchmarkXml_data() {
+    this->addCounts(100000);
+}
+
+void BenchmarkTest::benchmarkXml() {
+    QFETCH(int, count);
+
+    //nominal points (with coordinates) and one cartesian reading per point
+    QList<Point *> points;
+    QList<Reading *> readings;
+    for(int i = 0; i < count; i++){
+        Point *point = new Point(i + 1, true, Position(i, 0.0, 0.0));
+        point->setFeatureName(QString("P%1").arg(i + 1));
+        points.append(point);
+
+        ReadingCartesian cartesian;
+        cartesian.isValid = true;
+        cartesian.xyz.setAt(0, i);
+        readings.append(new Reading(cartesian));
+    }
+
+    //save
+    Measurement save;
+    QByteArray data;
+    while(save.next()){
+        save.start();
+        QDomDocument document("oiProjectData");
+        QDomElement root = document.createElement("oiProjectData");
+        document.appendChild(root);
+        QDomElement geometries = document.createElement("geometries");
+        foreach(const Point *point, points){
+            geometries.appendChild(point->toOpenIndyXML(document));
+        }
+        root.appendChild(geometries);
+        QDomElement readingElements = document.createElement("readings");
+        foreach(Reading *reading, readings){
+            readingElements.appendChild(reading->toOpenIndyXML(document));
+        }
+        root.appendChild(readingElements);
+        data = document.toByteArray();
+        save.stop();
+    }
+
+    //load
+    Measurement load;
+    int numLoaded = 0;
+    while(load.next()){
+        QList<Point *> loadedPoints;
+        QList<Reading *> loadedReadings;
+
+        load.start();
+        QDomDocument document;
+        document.setContent(data);
+        QDomElement root = document.documentElement();
+        QDomElement geometry = root.firstChildElement("geometries").firstChildElement();
+        while(!geometry.isNull()){
+            Point *point = new Point(false);
+            if(point->fromOpenIndyXML(geometry)){
+                loadedPoints.append(point);
+            }else{
+                delete point;
+            }
+            geometry = geometry.nextSiblingElement();
+        }
+        QDomElement readingElement = root.firstChildElement("readings").firstChildElement();
+        while(!readingElement.isNull()){
+            Reading *reading = new Reading(ReadingUndefined());
+            if(reading->fromOpenIndyXML(readingElement)){
+                loadedReadings.append(reading);
+            }else{
+                delete reading;
+            }
+            readingElement = readingElement.nextSiblingElement();
+        }
+        load.stop();
+
+        numLoaded = loadedPoints.size() + loadedReadings.size();
+        qDeleteAll(loadedPoints);
+        qDeleteAll(loadedReadings);
+    }
+
+    qDeleteAll(points);
+    qDeleteAll(readings);
+
+    QCOMPARE(numLoaded, 2 * count);
+    this->addResult("Xml::save", count, save);
+    this->addResult("Xml::load", count, load);
+}
+
+void BenchmarkTest::benchmarkGeneratedJob_data() {
+    //number of observations (100 readings per actual geometry)
+    this->addCounts(1000000);
+}
+
+void BenchmarkTest::benchmarkGeneratedJob() {
+    QFETCH(int, count);
+
+    JobGeneratorSettings settings;
+    settings.numStations = 4;
+    settings.numCoordinateSystems = 2;
+    settings.numTrafoParams = 4;
+    settings.geometryTypes.clear();
+    settings.geometryTypes << ePointFeature << ePlaneFeature << eCircleFeature << eCylinderFeature;
+    settings.numReadings = count < 100 ? count : 100;
+    settings.numActuals = qMax(1, count / settings.numReadings / settings.geometryTypes.size());
+    settings.numNominals = settings.numActuals;
+    JobGenerator generator(settings);
+
+    Measurement generate, remove;
+    while(generate.next()){
+        QPointer<OiJob> job = new OiJob();
+
+        generate.start();
+        QVERIFY(generator.generate(job));
+        generate.stop();
+
+        QSet<int> geometryIds;
+        foreach(const QPointer<FeatureWrapper> &feature, job->getGeometriesList()){
+            geometryIds.insert(feature->getGeometry()->getId());
+        }
+
+        remove.start();
+        job->removeFeatures(geometryIds);
+        remove.stop();
+
+        delete job.data();
+    }
+
+    this->addResult("JobGenerator::generate", count, generate);
+    this->addResult("OiJob::removeFeatures", count, remove);
+}
+
+QTEST_APPLESS_MAIN(BenchmarkTest)
+
+#include "tst_benchmark.moc"
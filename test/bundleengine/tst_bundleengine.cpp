@@ -0,0 +1,647 @@
+#include <QString>
+#include <QtTest>
+#include <QtMath>
+
+#include "bundleengine.h"
+#include "bundleinput.h"
+#include "bundleadjustment.h"
+
+#define COMPARE_DOUBLE(actual, expected, threshold) QVERIFY2(std::abs(actual-expected)< threshold, QString("actual: %1, expected: %2").arg(actual).arg(expected).toLatin1().data());
+
+using namespace oi;
+
+/*!
+ * \brief The DenseReference class
+ * Straightforward Gauss-Newton adjustment of the station network with all unknowns (station parameters and point coordinates)
+ * in one dense normal equation system and numerical derivatives. Used as reference for the sparse Schur solution of BundleEngine
+ */
+class DenseReference
+{
+public:
+    DenseReference(const BundleInput &input) : input(input){
+        this->input.updateParameterOffsets();
+    }
+
+    bool iterate(QVector<double> &unknowns, double &maxCorrection) const;
+    bool solve(QVector<double> &unknowns, double &sigma0, int &redundancy) const;
+
+private:
+    void getStationParameters(const QVector<double> &unknowns, const int &station, double params[7]) const;
+    void computeMisclosures(const QVector<double> &unknowns, QVector<double> &misclosures) const;
+    static bool solveDense(QVector<double> &n, QVector<double> &b, const int &size);
+
+    BundleInput input;
+};
+
+class BundleEngineTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    BundleEngineTest();
+
+private Q_SLOTS:
+    void testNormalEquations();
+    void testTwoStations();
+    void testThreeStations();
+    void testStationWithoutObservations();
+
+private:
+    void addStation(BundleInput &input, const int &id, const quint8 &freeParameters, const double params[7],
+                    const QList<int> &points, const double *coordinates, const double &noise) const;
+    QVector<double> getUnknowns(const BundleInput &input, const double *coordinates, const QList<double *> &stationParams) const;
+    void compareIteration(const BundleInput &input, const double *coordinates, const QList<double *> &stationParams);
+    void compareWithDenseReference(const BundleInput &input, const double *coordinates, const QList<double *> &stationParams);
+};
+
+namespace{
+
+/*!
+ * \brief transformPoint
+ * X = t + m * R * x with R = Rz * Ry * Rx (convention of TrafoParam)
+ * \param params
+ * \param x
+ * \param result
+ */
+void transformPoint(const double params[7], const double x[3], double result[3]){
+
+    double sx = qSin(params[3]), cx = qCos(params[3]);
+    double sy = qSin(params[4]), cy = qCos(params[4]);
+    double sz = qSin(params[5]), cz = qCos(params[5]);
+    const double rx[9] = {1.0, 0.0, 0.0, 0.0, cx, sx, 0.0, -sx, cx};
+    const double ry[9] = {cy, 0.0, -sy, 0.0, 1.0, 0.0, sy, 0.0, cy};
+    const double rz[9] = {cz, sz, 0.0, -sz, cz, 0.0, 0.0, 0.0, 1.0};
+
+    double zy[9], r[9];
+    for(int i = 0; i < 3; i++){
+        for(int j = 0; j < 3; j++){
+            zy[i*3+j] = rz[i*3] * ry[j] + rz[i*3+1] * ry[3+j] + rz[i*3+2] * ry[6+j];
+        }
+    }
+    for(int i = 0; i < 3; i++){
+        for(int j = 0; j < 3; j++){
+            r[i*3+j] = zy[i*3] * rx[j] + zy[i*3+1] * rx[3+j] + zy[i*3+2] * rx[6+j];
+        }
+    }
+
+    for(int k = 0; k < 3; k++){
+        result[k] = params[k] + params[6] * (r[k*3] * x[0] + r[k*3+1] * x[1] + r[k*3+2] * x[2]);
+    }
+
+}
+
+/*!
+ * \brief inverseTransformPoint
+ * x = R^T * (X - t) / m
+ * \param params
+ * \param xyz
+ * \param result
+ */
+void inverseTransformPoint(const double params[7], const double xyz[3], double result[3]){
+
+    //columns of R are the images of the unit vectors
+    double origin[3], axes[9];
+    const double zero[3] = {0.0, 0.0, 0.0};
+    transformPoint(params, zero, origin);
+    for(int a = 0; a < 3; a++){
+        double unit[3] = {0.0, 0.0, 0.0};
+        unit[a] = 1.0;
+        transformPoint(params, unit, axes + 3 * a);
+    }
+
+    for(int a = 0; a < 3; a++){
+        double dot = 0.0;
+        for(int k = 0; k < 3; k++){
+            double column = (axes[3*a+k] - origin[k]) / params[6];
+            dot += column * (xyz[k] - params[k]);
+        }
+        result[a] = dot / params[6];
+    }
+
+}
+
+}
+
+/*!
+ * \brief DenseReference::getStationParameters
+ * \param unknowns
+ * \param station
+ * \param params
+ */
+void DenseReference::getStationParameters(const QVector<double> &unknowns, const int &station, double params[7]) const{
+    int offset = this->input.stationParameterOffsets.at(station);
+    quint8 free = this->input.stationFreeParameters.at(station);
+    for(int k = 0; k < 7; k++){
+        params[k] = (k == 6) ? 1.0 : 0.0;
+        if(station != this->input.getBaseStation() && ((free >> k) & 1)){
+            params[k] = unknowns.at(offset++);
+        }
+    }
+}
+
+/*!
+ * \brief DenseReference::computeMisclosures
+ * f = t + m * R * x - X for each observation
+ * \param unknowns
+ * \param misclosures
+ */
+void DenseReference::computeMisclosures(const QVector<double> &unknowns, QVector<double> &misclosures) const{
+    misclosures.resize(3 * this->input.getNumObservations());
+    for(int i = 0; i < this->input.getNumObservations(); i++){
+        double params[7], xyz[3];
+        this->getStationParameters(unknowns, this->input.observationStations.at(i), params);
+        transformPoint(params, this->input.observationValues.constData() + 3 * i, xyz);
+        int offset = this->input.geometryParameterOffsets.at(this->input.observationGeometries.at(i));
+        for(int k = 0; k < 3; k++){
+            misclosures[3*i+k] = xyz[k] - unknowns.at(offset + k);
+        }
+    }
+}
+
+/*!
+ * \brief DenseReference::solveDense
+ * Solves n * x = b by Gaussian elimination with partial pivoting (b is replaced by x)
+ * \param n
+ * \param b
+ * \param size
+ * \return
+ */
+bool DenseReference::solveDense(QVector<double> &n, QVector<double> &b, const int &size){
+
+    for(int c = 0; c < size; c++){
+
+        int pivot = c;
+        for(int r = c + 1; r < size; r++){
+            if(qAbs(n.at(r * size + c)) > qAbs(n.at(pivot * size + c))){
+                pivot = r;
+            }
+        }
+        if(qAbs(n.at(pivot * size + c)) < 1e-14){
+            return false;
+        }
+        for(int k = 0; k < size; k++){
+            qSwap(n[c * size + k], n[pivot * size + k]);
+        }
+        qSwap(b[c], b[pivot]);
+
+        for(int r = c + 1; r < size; r++){
+            double factor = n.at(r * size + c) / n.at(c * size + c);
+            for(int k = c; k < size; k++){
+                n[r * size + k] -= factor * n.at(c * size + k);
+            }
+            b[r] -= factor * b.at(c);
+        }
+
+    }
+
+    for(int r = size - 1; r >= 0; r--){
+        double sum = b.at(r);
+        for(int k = r + 1; k < size; k++){
+            sum -= n.at(r * size + k) * b.at(k);
+        }
+        b[r] = sum / n.at(r * size + r);
+    }
+
+    return true;
+
+}
+
+/*!
+ * \brief DenseReference::iterate
+ * One Gauss-Newton step with the full normal equations N * dx = -J^T * f
+ * \param unknowns
+ * \param maxCorrection
+ * \return
+ */
+bool DenseReference::iterate(QVector<double> &unknowns, double &maxCorrection) const{
+
+    int numUnknowns = this->input.getNumUnknowns();
+    int numMisclosures = 3 * this->input.getNumObservations();
+    if(unknowns.size() != numUnknowns){
+        return false;
+    }
+
+    //dense jacobian by central differences
+    const double h = 1e-6;
+    QVector<double> misclosures, forward, backward;
+    QVector<double> jacobian(numMisclosures * numUnknowns);
+    for(int u = 0; u < numUnknowns; u++){
+        QVector<double> shifted = unknowns;
+        shifted[u] += h;
+        this->computeMisclosures(shifted, forward);
+        shifted[u] -= 2.0 * h;
+        this->computeMisclosures(shifted, backward);
+        for(int i = 0; i < numMisclosures; i++){
+            jacobian[i * numUnknowns + u] = (forward.at(i) - backward.at(i)) / (2.0 * h);
+        }
+    }
+    this->computeMisclosures(unknowns, misclosures);
+
+    //normal equations
+    QVector<double> n(numUnknowns * numUnknowns, 0.0);
+    QVector<double> b(numUnknowns, 0.0);
+    for(int i = 0; i < numMisclosures; i++){
+        const double *row = jacobian.constData() + i * numUnknowns;
+        for(int a = 0; a < numUnknowns; a++){
+            b[a] -= row[a] * misclosures.at(i);
+            for(int c = 0; c < numUnknowns; c++){
+                n[a * numUnknowns + c] += row[a] * row[c];
+            }
+        }
+    }
+    if(!DenseReference::solveDense(n, b, numUnknowns)){
+        return false;
+    }
+
+    maxCorrection = 0.0;
+    for(int u = 0; u < numUnknowns; u++){
+        unknowns[u] += b.at(u);
+        maxCorrection = qMax(maxCorrection, qAbs(b.at(u)));
+    }
+
+    return true;
+
+}
+
+/*!
+ * \brief DenseReference::solve
+ * Iterates from the given approximations until the corrections vanish
+ * \param unknowns
+ * \param sigma0
+ * \param redundancy
+ * \return
+ */
+bool DenseReference::solve(QVector<double> &unknowns, double &sigma0, int &redundancy) const{
+
+    double maxCorrection = 1.0;
+    for(int iteration = 0; iteration < 20 && maxCorrection >= 1e-12; iteration++){
+        if(!this->iterate(unknowns, maxCorrection)){
+            return false;
+        }
+    }
+
+    QVector<double> misclosures;
+    this->computeMisclosures(unknowns, misclosures);
+    double vtv = 0.0;
+    foreach(const double &f, misclosures){
+        vtv += f * f;
+    }
+    redundancy = misclosures.size() - unknowns.size();
+    sigma0 = redundancy > 0 ? qSqrt(vtv / redundancy) : 0.0;
+
+    return true;
+
+}
+
+BundleEngineTest::BundleEngineTest()
+{
+}
+
+/*!
+ * \brief BundleEngineTest::addStation
+ * Adds a station that observes the given points (coordinates in the bundle system) with a small deterministic noise
+ * \param input
+ * \param id
+ * \param freeParameters
+ * \param params
+ * \param points
+ * \param coordinates
+ * \param noise
+ */
+void BundleEngineTest::addStation(BundleInput &input, const int &id, const quint8 &freeParameters, const double params[7],
+                                  const QList<int> &points, const double *coordinates, const double &noise) const{
+
+    int station = input.addStation(id, freeParameters);
+    foreach(const int &point, points){
+        double x[3];
+        inverseTransformPoint(params, coordinates + 3 * point, x);
+        for(int k = 0; k < 3; k++){
+            x[k] += noise * qSin(1.0 + 7.0 * id + 3.0 * point + k);
+        }
+        input.addObservation(station, input.addGeometry(point), x[0], x[1], x[2]);
+    }
+
+}
+
+/*!
+ * \brief BundleEngineTest::getUnknowns
+ * Returns the unknowns in the order of the parameter offsets of the input
+ * \param input
+ * \param coordinates
+ * \param stationParams
+ * \return
+ */
+QVector<double> BundleEngineTest::getUnknowns(const BundleInput &input, const double *coordinates, const QList<double *> &stationParams) const{
+
+    BundleInput offsets = input;
+    offsets.updateParameterOffsets();
+
+    QVector<double> unknowns(offsets.getNumUnknowns());
+    for(int s = 0; s < offsets.getNumStations(); s++){
+        if(s == offsets.getBaseStation()){
+            continue;
+        }
+        int offset = offsets.stationParameterOffsets.at(s);
+        for(int k = 0; k < 7; k++){
+            if((offsets.stationFreeParameters.at(s) >> k) & 1){
+                unknowns[offset++] = stationParams.at(s)[k];
+            }
+        }
+    }
+    for(int g = 0; g < offsets.getNumGeometries(); g++){
+        for(int k = 0; k < 3; k++){
+            unknowns[offsets.geometryParameterOffsets.at(g) + k] = coordinates[3 * offsets.geometryIds.at(g) + k];
+        }
+    }
+
+    return unknowns;
+
+}
+
+/*!
+ * \brief BundleEngineTest::compareIteration
+ * Runs one iteration of BundleEngine and one step of the dense reference from the given approximations and compares the results
+ * \param input
+ * \param coordinates
+ * \param stationParams
+ */
+void BundleEngineTest::compareIteration(const BundleInput &input, const double *coordinates, const QList<double *> &stationParams){
+
+    BundleInput offsets = input;
+    offsets.updateParameterOffsets();
+
+    //dense step
+    QVector<double> unknowns = this->getUnknowns(input, coordinates, stationParams);
+    DenseReference reference(input);
+    double maxCorrection = 0.0;
+    QVERIFY(reference.iterate(unknowns, maxCorrection));
+    QVERIFY(maxCorrection > 1e-3);
+
+    //sparse step (stations and points are in the order of the input)
+    BundleEngine engine;
+    QVERIFY(engine.setUpProblem(input));
+    for(int s = 0; s < engine.stations.size(); s++){
+        for(int k = 0; k < 7; k++){
+            engine.stations[s].params[k] = stationParams.at(s)[k];
+        }
+    }
+    for(int p = 0; p < engine.points.size(); p++){
+        for(int k = 0; k < 3; k++){
+            engine.points[p].xyz[k] = coordinates[3 * input.geometryIds.at(p) + k];
+        }
+    }
+    QVERIFY(engine.iterate(maxCorrection));
+
+    //compare
+    for(int s = 0; s < engine.stations.size(); s++){
+        if(s == offsets.getBaseStation()){
+            continue;
+        }
+        int offset = offsets.stationParameterOffsets.at(s);
+        for(int k = 0; k < 7; k++){
+            if(engine.stations.at(s).isFree[k]){
+                COMPARE_DOUBLE(engine.stations.at(s).params[k], unknowns.at(offset), 1e-7);
+                offset++;
+            }
+        }
+    }
+    for(int p = 0; p < engine.points.size(); p++){
+        for(int k = 0; k < 3; k++){
+            COMPARE_DOUBLE(engine.points.at(p).xyz[k], unknowns.at(offsets.geometryParameterOffsets.at(p) + k), 1e-7);
+        }
+    }
+
+}
+
+/*!
+ * \brief BundleEngineTest::compareWithDenseReference
+ * Solves the network with BundleEngine and with the dense reference (started at the true values) and compares the results
+ * \param input
+ * \param coordinates
+ * \param stationParams
+ */
+void BundleEngineTest::compareWithDenseReference(const BundleInput &input, const double *coordinates, const QList<double *> &stationParams){
+
+    //sparse solution
+    BundleEngine engine;
+    QList<BundleGeometry> geometries;
+    QList<BundleTransformation> transformations;
+    QVERIFY2(engine.solve(input, geometries, transformations), engine.getErrorMessage().toLatin1().data());
+    QCOMPARE(geometries.size(), input.getNumGeometries());
+    QCOMPARE(transformations.size(), input.getNumStations());
+
+    //dense solution
+    BundleInput offsets = input;
+    offsets.updateParameterOffsets();
+    QVector<double> unknowns = this->getUnknowns(input, coordinates, stationParams);
+    DenseReference reference(input);
+    double sigma0 = 0.0;
+    int redundancy = 0;
+    QVERIFY(reference.solve(unknowns, sigma0, redundancy));
+
+    //compare
+    QCOMPARE(engine.getRedundancy(), redundancy);
+    COMPARE_DOUBLE(engine.getSigma0(), sigma0, 1e-9);
+    QVERIFY(sigma0 > 0.0);
+    foreach(const BundleGeometry &geometry, geometries){
+        int offset = offsets.geometryParameterOffsets.at(offsets.getGeometryIndex(geometry.id));
+        COMPARE_DOUBLE(geometry.parameters.value(eUnknownX), unknowns.at(offset), 1e-8);
+        COMPARE_DOUBLE(geometry.parameters.value(eUnknownY), unknowns.at(offset + 1), 1e-8);
+        COMPARE_DOUBLE(geometry.parameters.value(eUnknownZ), unknowns.at(offset + 2), 1e-8);
+    }
+    foreach(const BundleTransformation &transformation, transformations){
+        int s = offsets.getStationIndex(transformation.id);
+        if(s == offsets.getBaseStation()){
+            continue;
+        }
+        int offset = offsets.stationParameterOffsets.at(s);
+        const TrafoParamParameters keys[7] = {eUnknownTX, eUnknownTY, eUnknownTZ, eUnknownRX, eUnknownRY, eUnknownRZ, eUnknownSX};
+        for(int k = 0; k < 7; k++){
+            if((offsets.stationFreeParameters.at(s) >> k) & 1){
+                COMPARE_DOUBLE(transformation.parameters.value(keys[k]), unknowns.at(offset), 1e-8);
+                offset++;
+            }
+        }
+    }
+
+}
+
+void BundleEngineTest::testNormalEquations(){
+
+    //one iteration of the engine (reduced normal equations, Schur complement and back substitution)
+    //has to give the same corrections as one step of the dense normal equations from the same approximations
+    const double coordinates[21] = {0.0, 0.0, 0.0,
+                                    4.0, 0.5, 0.2,
+                                    1.0, 3.5, -0.4,
+                                    -2.0, 1.0, 1.5,
+                                    2.5, -3.0, 0.8,
+                                    -1.0, -1.5, -2.0,
+                                    3.0, 3.0, 1.0};
+    double base[7] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0};
+    double station2[7] = {1.2, -0.7, 0.3, 0.05, -0.08, 0.9, 1.0002};
+    double station3[7] = {-2.0, 0.4, -0.1, -0.03, 0.02, -1.4, 1.0};
+
+    QList<int> basePoints;
+    basePoints << 0 << 1 << 2 << 3 << 4 << 5;
+    QList<int> points2;
+    points2 << 0 << 1 << 2 << 3 << 4;
+    QList<int> points3;
+    points3 << 1 << 2 << 4 << 5 << 6;
+
+    //approximations off the solution
+    double approximatedCoordinates[21];
+    for(int i = 0; i < 21; i++){
+        approximatedCoordinates[i] = coordinates[i] + 0.02 * qCos(2.0 * i);
+    }
+    double approximatedStation2[7] = {1.25, -0.72, 0.28, 0.055, -0.075, 0.89, 1.0};
+    double approximatedStation3[7] = {-1.96, 0.43, -0.12, -0.025, 0.024, -1.41, 1.0};
+
+    //two stations
+    BundleInput input;
+    this->addStation(input, 1, BundleInput::eAllParameters, base, basePoints, coordinates, 1e-4);
+    this->addStation(input, 2, BundleInput::eAllParameters, station2, points2, coordinates, 1e-4);
+    input.setBaseStation(0);
+
+    QList<double *> stationParams;
+    stationParams << base << approximatedStation2;
+    this->compareIteration(input, approximatedCoordinates, stationParams);
+
+    //a third station with common points (off-diagonal block in the reduced system)
+    this->addStation(input, 3, BundleInput::eAllParameters & ~BundleInput::eM, station3, points3, coordinates, 1e-4);
+
+    stationParams << approximatedStation3;
+    this->compareIteration(input, approximatedCoordinates, stationParams);
+
+}
+
+void BundleEngineTest::testTwoStations(){
+
+    //six points, the last one is only observed by the base station
+    const double coordinates[18] = {0.0, 0.0, 0.0,
+                                    4.0, 0.5, 0.2,
+                                    1.0, 3.5, -0.4,
+                                    -2.0, 1.0, 1.5,
+                                    2.5, -3.0, 0.8,
+                                    -1.0, -1.5, -2.0};
+    double base[7] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0};
+    double station[7] = {1.2, -0.7, 0.3, 0.05, -0.08, 0.9, 1.0002};
+
+    QList<int> basePoints;
+    basePoints << 0 << 1 << 2 << 3 << 4 << 5;
+    QList<int> stationPoints;
+    stationPoints << 0 << 1 << 2 << 3 << 4;
+
+    BundleInput input;
+    this->addStation(input, 1, BundleInput::eAllParameters, base, basePoints, coordinates, 1e-4);
+    this->addStation(input, 2, BundleInput::eAllParameters, station, stationPoints, coordinates, 1e-4);
+    input.setBaseStation(0);
+
+    QList<double *> stationParams;
+    stationParams << base << station;
+    this->compareWithDenseReference(input, coordinates, stationParams);
+
+}
+
+void BundleEngineTest::testThreeStations(){
+
+    //the stations 2 and 3 have common points, so that the reduced system has an off-diagonal block
+    const double coordinates[21] = {0.0, 0.0, 0.0,
+                                    4.0, 0.5, 0.2,
+                                    1.0, 3.5, -0.4,
+                                    -2.0, 1.0, 1.5,
+                                    2.5, -3.0, 0.8,
+                                    -1.0, -1.5, -2.0,
+                                    3.0, 3.0, 1.0};
+    double base[7] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0};
+    double station2[7] = {1.2, -0.7, 0.3, 0.05, -0.08, 0.9, 1.0};
+    double station3[7] = {-2.0, 0.4, -0.1, -0.03, 0.02, -1.4, 1.0};
+
+    QList<int> basePoints;
+    basePoints << 0 << 1 << 2 << 3;
+    QList<int> points2;
+    points2 << 0 << 1 << 2 << 4 << 5;
+    QList<int> points3;
+    points3 << 1 << 2 << 3 << 4 << 5 << 6;
+
+    //the third station is observed without scale
+    BundleInput input;
+    this->addStation(input, 1, BundleInput::eAllParameters, base, basePoints, coordinates, 1e-4);
+    this->addStation(input, 2, BundleInput::eAllParameters, station2, points2, coordinates, 1e-4);
+    this->addStation(input, 3, BundleInput::eAllParameters & ~BundleInput::eM, station3, points3, coordinates, 1e-4);
+    input.setBaseStation(0);
+
+    QList<double *> stationParams;
+    stationParams << base << station2 << station3;
+    this->compareWithDenseReference(input, coordinates, stationParams);
+
+}
+
+void BundleEngineTest::testStationWithoutObservations(){
+
+    const double coordinates[21] = {0.0, 0.0, 0.0,
+                                    4.0, 0.5, 0.2,
+                                    1.0, 3.5, -0.4,
+                                    -2.0, 1.0, 1.5,
+                                    2.5, -3.0, 0.8,
+                                    -1.0, -1.5, -2.0,
+                                    3.0, 3.0, 1.0};
+    double base[7] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0};
+    double station2[7] = {1.2, -0.7, 0.3, 0.05, -0.08, 0.9, 1.0};
+    double station3[7] = {-2.0, 0.4, -0.1, -0.03, 0.02, -1.4, 1.0};
+
+    QList<int> basePoints;
+    basePoints << 0 << 1 << 2 << 3;
+    QList<int> points2;
+    points2 << 0 << 1 << 2 << 4 << 5;
+    QList<int> points3;
+    points3 << 1 << 2 << 3 << 4 << 5 << 6;
+
+    BundleInput input;
+    this->addStation(input, 1, BundleInput::eAllParameters, base, basePoints, coordinates, 1e-4);
+    this->addStation(input, 2, BundleInput::eAllParameters, station2, points2, coordinates, 1e-4);
+    this->addStation(input, 3, BundleInput::eAllParameters, station3, points3, coordinates, 1e-4);
+    input.setBaseStation(0);
+
+    //first solution (kept for the warm start)
+    BundleEngine engine;
+    QList<BundleGeometry> geometries;
+    QList<BundleTransformation> transformations;
+    QVERIFY2(engine.solve(input, geometries, transformations), engine.getErrorMessage().toLatin1().data());
+    QVERIFY(engine.getHasPreviousSolution());
+
+    //all observations of the third station are removed, but the station is still part of the input
+    BundleInput reduced;
+    this->addStation(reduced, 1, BundleInput::eAllParameters, base, basePoints, coordinates, 1e-4);
+    this->addStation(reduced, 2, BundleInput::eAllParameters, station2, points2, coordinates, 1e-4);
+    this->addStation(reduced, 3, BundleInput::eAllParameters, station3, QList<int>(), coordinates, 1e-4);
+    reduced.setBaseStation(0);
+
+    QVERIFY(!engine.solve(reduced, geometries, transformations));
+    QVERIFY(engine.getErrorMessage().contains("less than three common points"));
+
+    //the same with only two common points
+    QList<int> weakPoints;
+    weakPoints << 1 << 2 << 6;
+    BundleInput weak;
+    this->addStation(weak, 1, BundleInput::eAllParameters, base, basePoints, coordinates, 1e-4);
+    this->addStation(weak, 2, BundleInput::eAllParameters, station2, points2, coordinates, 1e-4);
+    this->addStation(weak, 3, BundleInput::eAllParameters, station3, weakPoints, coordinates, 1e-4);
+    weak.setBaseStation(0);
+
+    QVERIFY(!engine.solve(weak, geometries, transformations));
+    QVERIFY(engine.getErrorMessage().contains("less than three common points"));
+
+    //without the station the network is solved again
+    BundleInput remaining;
+    this->addStation(remaining, 1, BundleInput::eAllParameters, base, basePoints, coordinates, 1e-4);
+    this->addStation(remaining, 2, BundleInput::eAllParameters, station2, points2, coordinates, 1e-4);
+    remaining.setBaseStation(0);
+
+    QVERIFY2(engine.solve(remaining, geometries, transformations), engine.getErrorMessage().toLatin1().data());
+    QCOMPARE(transformations.size(), 2);
+
+}
+
+QTEST_APPLESS_MAIN(BundleEngineTest)
+
+#include "tst_bundleengine.moc"
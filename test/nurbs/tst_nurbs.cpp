@@ -0,0 +1,167 @@
+#include <QString>
+#include <QtTest>
+#include <QtMath>
+
+#include "chooselalib.h"
+#include "nurbs.h"
+
+#define COMPARE_DOUBLE(actual, expected, threshold) QVERIFY2(std::abs(actual-expected)< threshold, QString("actual: %1, expected: %2").arg(actual).arg(expected).toLatin1().data());
+
+using namespace oi;
+
+class NurbsTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    NurbsTest();
+
+private Q_SLOTS:
+    void initTestCase();
+    void testBilinearPatch();
+    void testCylindricalPatch();
+    void testNotSolved();
+
+private:
+    void setBilinearPatch(Nurbs &nurbs) const;
+    void setCylindricalPatch(Nurbs &nurbs, const double &radius, const double &height) const;
+};
+
+void NurbsTest::initTestCase() {
+    ChooseLALib::setLinearAlgebra(ChooseLALib::Armadillo);
+}
+
+NurbsTest::NurbsTest()
+{
+}
+
+/*!
+ * \brief NurbsTest::setBilinearPatch
+ * Flat 4 x 4 square in the xy plane (u in x, v in y, so that Su x Sv points in z)
+ * \param nurbs
+ */
+void NurbsTest::setBilinearPatch(Nurbs &nurbs) const{
+
+    QVector<double> knots;
+    knots << 0.0 << 0.0 << 1.0 << 1.0;
+    QVector<double> controlPoints;
+    controlPoints << 0.0 << 0.0 << 0.0
+                  << 0.0 << 4.0 << 0.0
+                  << 4.0 << 0.0 << 0.0
+                  << 4.0 << 4.0 << 0.0;
+
+    QVERIFY(nurbs.setNurbs(1, 1, 2, 2, knots, knots, controlPoints));
+    nurbs.setIsSolved(true);
+
+}
+
+/*!
+ * \brief NurbsTest::setCylindricalPatch
+ * Quarter of a cylinder around the z axis (rational quadratic arc in u, line in v, so that Su x Sv points outwards)
+ * \param nurbs
+ * \param radius
+ * \param height
+ */
+void NurbsTest::setCylindricalPatch(Nurbs &nurbs, const double &radius, const double &height) const{
+
+    QVector<double> knotsU;
+    knotsU << 0.0 << 0.0 << 0.0 << 1.0 << 1.0 << 1.0;
+    QVector<double> knotsV;
+    knotsV << 0.0 << 0.0 << 1.0 << 1.0;
+
+    double arc[3][2] = {{radius, 0.0}, {radius, radius}, {0.0, radius}};
+    double arcWeights[3] = {1.0, qSqrt(0.5), 1.0};
+    QVector<double> controlPoints;
+    QVector<double> weights;
+    for(int i = 0; i < 3; i++){
+        for(int j = 0; j < 2; j++){
+            controlPoints << arc[i][0] << arc[i][1] << j * height;
+            weights << arcWeights[i];
+        }
+    }
+
+    QVERIFY(nurbs.setNurbs(2, 1, 3, 2, knotsU, knotsV, controlPoints, weights));
+    nurbs.setIsSolved(true);
+
+}
+
+void NurbsTest::testBilinearPatch(){
+
+    Nurbs nurbs(false);
+    this->setBilinearPatch(nurbs);
+
+    //points above, below and on the patch
+    double points[9] = {1.0, 3.0, 0.5,
+                        2.5, 0.5, -1.5,
+                        3.0, 1.0, 0.0};
+    double deviations[3];
+    double footPoints[9];
+    QVERIFY(nurbs.computeDeviations(points, 3, deviations, footPoints));
+
+    for(int i = 0; i < 3; i++){
+        COMPARE_DOUBLE(deviations[i], points[3*i+2], 1e-8);
+        COMPARE_DOUBLE(footPoints[3*i], points[3*i], 1e-8);
+        COMPARE_DOUBLE(footPoints[3*i+1], points[3*i+1], 1e-8);
+        COMPARE_DOUBLE(footPoints[3*i+2], 0.0, 1e-8);
+    }
+
+}
+
+void NurbsTest::testCylindricalPatch(){
+
+    const double radius = 2.0;
+    Nurbs nurbs(false);
+    this->setCylindricalPatch(nurbs, radius, 3.0);
+
+    //points outside, inside and on the cylinder (distance from the axis, angle, height)
+    double cylindrical[4][3] = {{3.0, 0.3, 1.0},
+                                {1.0, 1.2, 2.5},
+                                {radius, 0.7, 0.5},
+                                {2.5, 0.0, 0.0}};
+    double points[12];
+    for(int i = 0; i < 4; i++){
+        points[3*i] = cylindrical[i][0] * qCos(cylindrical[i][1]);
+        points[3*i+1] = cylindrical[i][0] * qSin(cylindrical[i][1]);
+        points[3*i+2] = cylindrical[i][2];
+    }
+    double deviations[4];
+    double footPoints[12];
+    QVERIFY(nurbs.computeDeviations(points, 4, deviations, footPoints));
+
+    //the foot point is the point on the circle in direction of the point
+    for(int i = 0; i < 4; i++){
+        COMPARE_DOUBLE(deviations[i], cylindrical[i][0] - radius, 1e-8);
+        COMPARE_DOUBLE(footPoints[3*i], radius * qCos(cylindrical[i][1]), 1e-8);
+        COMPARE_DOUBLE(footPoints[3*i+1], radius * qSin(cylindrical[i][1]), 1e-8);
+        COMPARE_DOUBLE(footPoints[3*i+2], cylindrical[i][2], 1e-8);
+    }
+
+    //deviations without foot points
+    double onlyDeviations[4];
+    QVERIFY(nurbs.computeDeviations(points, 4, onlyDeviations));
+    for(int i = 0; i < 4; i++){
+        COMPARE_DOUBLE(onlyDeviations[i], deviations[i], 1e-12);
+    }
+
+}
+
+void NurbsTest::testNotSolved(){
+
+    Nurbs nurbs(false);
+    this->setBilinearPatch(nurbs);
+    nurbs.setIsSolved(false);
+
+    double points[3] = {1.0, 1.0, 1.0};
+    double deviations[1];
+    QVERIFY(!nurbs.computeDeviations(points, 1, deviations));
+
+    //no control net
+    Nurbs empty(false);
+    empty.setIsSolved(true);
+    QVERIFY(!empty.computeDeviations(points, 1, deviations));
+
+}
+
+QTEST_APPLESS_MAIN(NurbsTest)
+
+#include "tst_nurbs.moc"
@@ -0,0 +1,224 @@
+#include <QString>
+#include <QtTest>
+
+#include "chooselalib.h"
+#include "reading.h"
+#include "readingstore.h"
+
+using namespace oi;
+
+class ReadingStoreTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    ReadingStoreTest();
+
+private Q_SLOTS:
+    void initTestCase();
+    void testAddRemove();
+    void testDeletedReadings();
+    void testCompaction();
+    void testAddressReuse();
+
+private:
+    QPointer<Reading> createReading(const ReadingTypes &type) const;
+};
+
+void ReadingStoreTest::initTestCase() {
+    ChooseLALib::setLinearAlgebra(ChooseLALib::Armadillo);
+}
+
+ReadingStoreTest::ReadingStoreTest()
+{
+}
+
+QPointer<Reading> ReadingStoreTest::createReading(const ReadingTypes &type) const{
+    switch(type){
+    case eDistanceReading:
+        return new Reading(ReadingDistance());
+    case eCartesianReading:
+        return new Reading(ReadingCartesian());
+    case ePolarReading:
+        return new Reading(ReadingPolar());
+    default:
+        return new Reading(ReadingTemperature());
+    }
+}
+
+void ReadingStoreTest::testAddRemove(){
+
+    ReadingStore store;
+    QPointer<Reading> distance = this->createReading(eDistanceReading);
+    QPointer<Reading> polar = this->createReading(ePolarReading);
+    QPointer<Reading> polar2 = this->createReading(ePolarReading);
+
+    QVERIFY(store.add(distance));
+    QVERIFY(store.add(polar));
+    QVERIFY(store.add(polar2));
+    QVERIFY(!store.add(polar));
+    QVERIFY(!store.add(QPointer<Reading>()));
+
+    QCOMPARE(store.getCount(), 3);
+    QCOMPARE(store.getCount(eDistanceReading), 1);
+    QCOMPARE(store.getCount(ePolarReading), 2);
+    QCOMPARE(store.getCount(eCartesianReading), 0);
+
+    QVERIFY(store.remove(polar));
+    QVERIFY(!store.remove(polar));
+    QVERIFY(!store.contains(polar));
+    QVERIFY(store.contains(polar2));
+    QCOMPARE(store.getCount(), 2);
+    QCOMPARE(store.getCount(ePolarReading), 1);
+    QCOMPARE(store.getReadings(ePolarReading).size(), 1);
+    QVERIFY(store.getReadings(ePolarReading).first() == polar2);
+
+    store.clear();
+    QCOMPARE(store.getCount(), 0);
+    QVERIFY(!store.contains(distance));
+
+    delete distance.data();
+    delete polar.data();
+    delete polar2.data();
+
+}
+
+void ReadingStoreTest::testDeletedReadings(){
+
+    ReadingStore store;
+    QList<QPointer<Reading> > readings;
+    for(int i = 0; i < 10; i++){
+        readings.append(this->createReading(i % 2 == 0 ? eDistanceReading : eCartesianReading));
+        QVERIFY(store.add(readings.last()));
+    }
+
+    //delete readings without removing them from the store
+    delete readings.at(0).data();
+    delete readings.at(3).data();
+    delete readings.at(4).data();
+
+    QCOMPARE(store.getCount(), 7);
+    QCOMPARE(store.getCount(eDistanceReading), 3);
+    QCOMPARE(store.getCount(eCartesianReading), 4);
+    QCOMPARE(store.getReadings().size(), 7);
+    QCOMPARE(store.getReadings(eDistanceReading).size(), 3);
+
+    //a null pointer cannot be removed, but is not counted either
+    QVERIFY(!store.remove(readings.at(0)));
+    QCOMPARE(store.getCount(), 7);
+
+    //the remaining readings keep their order
+    QList<QPointer<Reading> > stored = store.getReadings();
+    QVERIFY(stored.at(0) == readings.at(1));
+    QVERIFY(stored.at(1) == readings.at(2));
+    QVERIFY(stored.at(2) == readings.at(5));
+
+    foreach(const QPointer<Reading> &reading, readings){
+        delete reading.data();
+    }
+    QCOMPARE(store.getCount(), 0);
+    QCOMPARE(store.getCount(eDistanceReading), 0);
+    QCOMPARE(store.getCount(eCartesianReading), 0);
+
+}
+
+void ReadingStoreTest::testCompaction(){
+
+    //more than one chunk, so that the compaction moves entries between chunks
+    const int numReadings = 3 * 4096 + 100;
+    ReadingStore store;
+    QList<QPointer<Reading> > readings;
+    for(int i = 0; i < numReadings; i++){
+        readings.append(this->createReading((ReadingTypes)(i % 3)));
+        QVERIFY(store.add(readings.last()));
+    }
+
+    //remove (or delete) all readings except every fifth one, this compacts the store
+    QList<QPointer<Reading> > kept;
+    for(int i = 0; i < numReadings; i++){
+        if(i % 5 == 0){
+            kept.append(readings.at(i));
+        }else if(i % 5 == 1){
+            delete readings.at(i).data();
+        }else{
+            QVERIFY(store.remove(readings.at(i)));
+            delete readings.at(i).data();
+        }
+    }
+
+    //order, counts and type indices after the compaction
+    QCOMPARE(store.getCount(), kept.size());
+    QList<QPointer<Reading> > stored = store.getReadings();
+    QCOMPARE(stored.size(), kept.size());
+    for(int i = 0; i < kept.size(); i++){
+        QVERIFY(stored.at(i) == kept.at(i));
+        QVERIFY(store.contains(kept.at(i)));
+    }
+    for(int type = 0; type < 3; type++){
+        QList<QPointer<Reading> > ofType = store.getReadings((ReadingTypes)type);
+        QCOMPARE(store.getCount((ReadingTypes)type), ofType.size());
+        foreach(const QPointer<Reading> &reading, ofType){
+            QCOMPARE((int)reading->getTypeOfReading(), type);
+        }
+    }
+
+    //the rebuilt indices are used by remove and add
+    QVERIFY(store.remove(kept.last()));
+    QVERIFY(!store.contains(kept.last()));
+    QVERIFY(store.add(kept.last()));
+    QVERIFY(store.getReadings().last() == kept.last());
+    QCOMPARE(store.getCount(), kept.size());
+
+    foreach(const QPointer<Reading> &reading, kept){
+        delete reading.data();
+    }
+
+}
+
+void ReadingStoreTest::testAddressReuse(){
+
+    ReadingStore store;
+    QPointer<Reading> stored = this->createReading(ePolarReading);
+    QVERIFY(store.add(stored));
+    const Reading *address = stored.data();
+
+    //delete the reading without removing it and try to get a new reading at the same address
+    delete stored.data();
+    QList<Reading *> others;
+    Reading *reused = 0;
+    for(int i = 0; i < 1000 && reused == 0; i++){
+        Reading *reading = this->createReading(eDistanceReading).data();
+        if(reading == address){
+            reused = reading;
+        }else{
+            others.append(reading);
+        }
+    }
+    qDeleteAll(others);
+    if(reused == 0){
+        QSKIP("the address of the deleted reading was not reused");
+    }
+
+    //the new reading is not stored, although an entry with its address exists
+    QPointer<Reading> reading = reused;
+    QVERIFY(!store.contains(reading));
+    QVERIFY(!store.remove(reading));
+    QCOMPARE(store.getCount(), 0);
+    QCOMPARE(store.getCount(ePolarReading), 0);
+
+    //it can be added with its own type
+    QVERIFY(store.add(reading));
+    QVERIFY(store.contains(reading));
+    QCOMPARE(store.getCount(), 1);
+    QCOMPARE(store.getCount(eDistanceReading), 1);
+    QCOMPARE(store.getCount(ePolarReading), 0);
+    QVERIFY(store.remove(reading));
+    QCOMPARE(store.getCount(), 0);
+
+    delete reused;
+
+}
+
+QTEST_APPLESS_MAIN(ReadingStoreTest)
+
+#include "tst_readingstore.moc"
@@ -0,0 +1,289 @@
+#include <QString>
+#include <QtTest>
+#include <QtEndian>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "chooselalib.h"
+#include "featurewrapper.h"
+#include "oijob.h"
+#include "oirequestencoder.h"
+#include "oirequestresponse.h"
+
+using namespace oi;
+
+class RequestEncoderTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    RequestEncoderTest();
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void testBinaryRequest();
+    void testBinaryRequestWithoutPayload();
+    void testTruncatedFrames();
+    void testWrongLengthPrefix();
+    void testOverflowingCount();
+    void testJsonRequest();
+    void testJsonWithoutType();
+    void testJsonSince();
+    void testRemovedFeatures();
+
+private:
+    QByteArray createFrame(const quint16 &type, const qint32 &requester, const QByteArray &payload) const;
+    QByteArray createIds(const quint32 &count, const QList<qint32> &ids) const;
+    OiRequestResponse createRequest(const OiRequestResponse::Encoding &encoding, const QByteArray &data) const;
+};
+
+RequestEncoderTest::RequestEncoderTest()
+{
+}
+
+void RequestEncoderTest::initTestCase() {
+    ChooseLALib::setLinearAlgebra(ChooseLALib::Armadillo);
+}
+
+QByteArray RequestEncoderTest::createFrame(const quint16 &type, const qint32 &requester, const QByteArray &payload) const{
+
+    uchar header[12];
+    qToLittleEndian<quint32>(8 + payload.size(), header);
+    qToLittleEndian<quint16>(type, header + 4);
+    qToLittleEndian<quint16>(0, header + 6);
+    qToLittleEndian<qint32>(requester, header + 8);
+
+    QByteArray frame((const char *)header, 12);
+    frame.append(payload);
+    return frame;
+
+}
+
+QByteArray RequestEncoderTest::createIds(const quint32 &count, const QList<qint32> &ids) const{
+
+    uchar bytes[4];
+    qToLittleEndian<quint32>(count, bytes);
+    QByteArray payload((const char *)bytes, 4);
+    foreach(const qint32 &id, ids){
+        qToLittleEndian<qint32>(id, bytes);
+        payload.append((const char *)bytes, 4);
+    }
+    return payload;
+
+}
+
+OiRequestResponse RequestEncoderTest::createRequest(const OiRequestResponse::Encoding &encoding, const QByteArray &data) const{
+    OiRequestResponse request;
+    request.encoding = encoding;
+    request.requestData = data;
+    return request;
+}
+
+void RequestEncoderTest::testBinaryRequest(){
+
+    QList<qint32> ids;
+    ids << 3 << 7 << 42;
+    OiRequestResponse request = this->createRequest(OiRequestResponse::eBinaryEncoding,
+                                                    this->createFrame(OiRequestResponse::eGetFeatures, 5, this->createIds(3, ids)));
+
+    QList<int> featureIds;
+    QVERIFY(OiRequestEncoder::decodeRequest(request, featureIds));
+    QCOMPARE(request.myRequestType, OiRequestResponse::eGetFeatures);
+    QCOMPARE(request.requesterId, 5);
+    QCOMPARE(featureIds.size(), 3);
+    QCOMPARE(featureIds.at(0), 3);
+    QCOMPARE(featureIds.at(1), 7);
+    QCOMPARE(featureIds.at(2), 42);
+
+}
+
+void RequestEncoderTest::testBinaryRequestWithoutPayload(){
+
+    OiRequestResponse request = this->createRequest(OiRequestResponse::eBinaryEncoding,
+                                                    this->createFrame(OiRequestResponse::eGetActiveFeature, 1, QByteArray()));
+
+    QList<int> featureIds;
+    QVERIFY(OiRequestEncoder::decodeRequest(request, featureIds));
+    QCOMPARE(request.myRequestType, OiRequestResponse::eGetActiveFeature);
+    QVERIFY(featureIds.isEmpty());
+
+}
+
+void RequestEncoderTest::testTruncatedFrames(){
+
+    QList<qint32> ids;
+    ids << 3 << 7;
+    QByteArray frame = this->createFrame(OiRequestResponse::eGetFeatures, 1, this->createIds(2, ids));
+
+    //every prefix of the frame is rejected (the length prefix does not match)
+    for(int size = 0; size < frame.size(); size++){
+        OiRequestResponse request = this->createRequest(OiRequestResponse::eBinaryEncoding, frame.left(size));
+        QList<int> featureIds;
+        QVERIFY2(!OiRequestEncoder::decodeRequest(request, featureIds), QString("size: %1").arg(size).toLatin1().data());
+    }
+
+    //consistent length prefix, but the ids are truncated
+    QByteArray truncated = this->createFrame(OiRequestResponse::eGetFeatures, 1, this->createIds(2, ids).left(10));
+    OiRequestResponse request = this->createRequest(OiRequestResponse::eBinaryEncoding, truncated);
+    QList<int> featureIds;
+    QVERIFY(!OiRequestEncoder::decodeRequest(request, featureIds));
+
+    //consistent length prefix, but the count is truncated
+    truncated = this->createFrame(OiRequestResponse::eGetFeatures, 1, QByteArray(2, '\0'));
+    request = this->createRequest(OiRequestResponse::eBinaryEncoding, truncated);
+    QVERIFY(!OiRequestEncoder::decodeRequest(request, featureIds));
+
+}
+
+void RequestEncoderTest::testWrongLengthPrefix(){
+
+    QList<qint32> ids;
+    ids << 3;
+    QByteArray frame = this->createFrame(OiRequestResponse::eGetFeatures, 1, this->createIds(1, ids));
+
+    QList<quint32> lengths;
+    lengths << 0 << (quint32)frame.size() - 5 << (quint32)frame.size() << 0xFFFFFFFC << 0xFFFFFFFF;
+    foreach(const quint32 &length, lengths){
+        QByteArray wrong = frame;
+        qToLittleEndian<quint32>(length, (uchar *)wrong.data());
+        OiRequestResponse request = this->createRequest(OiRequestResponse::eBinaryEncoding, wrong);
+        QList<int> featureIds;
+        QVERIFY2(!OiRequestEncoder::decodeRequest(request, featureIds), QString("length: %1").arg(length).toLatin1().data());
+    }
+
+}
+
+void RequestEncoderTest::testOverflowingCount(){
+
+    //4 * count wraps around to 4 in 32 bit arithmetic
+    QList<qint32> ids;
+    ids << 3;
+    QList<quint32> counts;
+    counts << 0x40000001 << 0x80000001 << 0xFFFFFFFF;
+    foreach(const quint32 &count, counts){
+        OiRequestResponse request = this->createRequest(OiRequestResponse::eBinaryEncoding,
+                                                        this->createFrame(OiRequestResponse::eGetFeatures, 1, this->createIds(count, ids)));
+        QList<int> featureIds;
+        QVERIFY2(!OiRequestEncoder::decodeRequest(request, featureIds), QString("count: %1").arg(count).toLatin1().data());
+        QVERIFY(featureIds.isEmpty());
+    }
+
+}
+
+void RequestEncoderTest::testJsonRequest(){
+
+    OiRequestResponse request = this->createRequest(OiRequestResponse::eJsonEncoding,
+                                                    QByteArray("{\"type\":12,\"requester\":4,\"data\":{\"ids\":[1,2,3]}}"));
+
+    QList<int> featureIds;
+    QVERIFY(OiRequestEncoder::decodeRequest(request, featureIds));
+    QCOMPARE(request.myRequestType, OiRequestResponse::eGetFeatures);
+    QCOMPARE(request.requesterId, 4);
+    QCOMPARE(featureIds.size(), 3);
+    QCOMPARE(featureIds.at(2), 3);
+
+}
+
+void RequestEncoderTest::testJsonWithoutType(){
+
+    QList<QByteArray> messages;
+    messages << QByteArray("{\"requester\":4,\"data\":{\"id\":1}}")
+             << QByteArray("{}")
+             << QByteArray("[{\"type\":12}]")
+             << QByteArray("{\"type\":12")
+             << QByteArray();
+    foreach(const QByteArray &message, messages){
+        OiRequestResponse request = this->createRequest(OiRequestResponse::eJsonEncoding, message);
+        QList<int> featureIds;
+        QVERIFY2(!OiRequestEncoder::decodeRequest(request, featureIds), message.constData());
+    }
+
+}
+
+void RequestEncoderTest::testJsonSince(){
+
+    //numbers and decimal strings (for sequences that are not exact as double)
+    QList<QByteArray> messages;
+    QList<quint64> sequences;
+    messages << QByteArray("{\"type\":12,\"data\":{\"since\":0}}")
+             << QByteArray("{\"type\":12,\"data\":{\"since\":4711}}")
+             << QByteArray("{\"type\":12,\"data\":{\"since\":\"4711\"}}")
+             << QByteArray("{\"type\":12,\"data\":{\"since\":\"18446744073709551615\"}}");
+    sequences << 0 << 4711 << 4711 << Q_UINT64_C(18446744073709551615);
+    for(int i = 0; i < messages.size(); i++){
+        OiRequestResponse request = this->createRequest(OiRequestResponse::eJsonEncoding, messages.at(i));
+        QList<int> featureIds;
+        quint64 sinceSequence = 0;
+        bool isDelta = false;
+        QVERIFY2(OiRequestEncoder::decodeRequest(request, featureIds, sinceSequence, isDelta), messages.at(i).constData());
+        QVERIFY(isDelta);
+        QCOMPARE(sinceSequence, sequences.at(i));
+    }
+
+    //negative, fractional, too large for a double and malformed sequences
+    messages.clear();
+    messages << QByteArray("{\"type\":12,\"data\":{\"since\":-1}}")
+             << QByteArray("{\"type\":12,\"data\":{\"since\":1.5}}")
+             << QByteArray("{\"type\":12,\"data\":{\"since\":1e300}}")
+             << QByteArray("{\"type\":12,\"data\":{\"since\":\"-1\"}}")
+             << QByteArray("{\"type\":12,\"data\":{\"since\":\"12a\"}}")
+             << QByteArray("{\"type\":12,\"data\":{\"since\":true}}");
+    foreach(const QByteArray &message, messages){
+        OiRequestResponse request = this->createRequest(OiRequestResponse::eJsonEncoding, message);
+        QList<int> featureIds;
+        quint64 sinceSequence = 0;
+        bool isDelta = false;
+        QVERIFY2(!OiRequestEncoder::decodeRequest(request, featureIds, sinceSequence, isDelta), message.constData());
+        QVERIFY(!isDelta);
+    }
+
+}
+
+void RequestEncoderTest::testRemovedFeatures(){
+
+    QPointer<OiJob> job = new OiJob();
+
+    FeatureAttributes attr;
+    attr.typeOfFeature = ePointFeature;
+    attr.name = "P";
+    attr.count = 2;
+    attr.isActual = true;
+    QList<QPointer<FeatureWrapper> > points = job->addFeatures(attr);
+    QCOMPARE(points.size(), 2);
+    const int firstId = points.at(0)->getFeature()->getId();
+    const int secondId = points.at(1)->getFeature()->getId();
+    const quint64 sinceSequence = job->getChangeSequence();
+
+    //remove one feature by id and one by pointer (both disconnect the feature before it is deleted)
+    QVERIFY(job->removeFeature(firstId));
+    QVERIFY(job->removeFeature(points.at(1)));
+    QVERIFY(job->getFeatureById(firstId).isNull());
+    QVERIFY(job->getFeatureById(secondId).isNull());
+    QVERIFY(job->getChangeSequence() > sinceSequence);
+
+    OiRequestResponse request = this->createRequest(OiRequestResponse::eJsonEncoding, QByteArray());
+    request.myRequestType = OiRequestResponse::eGetFeatures;
+    QVERIFY(OiRequestEncoder::encodeFeatureChanges(job, request, sinceSequence));
+
+    QJsonParseError error;
+    QJsonDocument response = QJsonDocument::fromJson(request.responseData, &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QCOMPARE(response.object().value("error").toInt(), (int)OiRequestResponse::eNoError);
+
+    QJsonObject data = response.object().value("data").toObject();
+    QCOMPARE(data.value("sequence").toDouble(), (double)job->getChangeSequence());
+    QVERIFY(data.value("features").toArray().isEmpty());
+    QJsonArray removed = data.value("removed").toArray();
+    QCOMPARE(removed.size(), 2);
+    QCOMPARE(removed.at(0).toInt(), firstId);
+    QCOMPARE(removed.at(1).toInt(), secondId);
+
+    delete job.data();
+
+}
+
+QTEST_APPLESS_MAIN(RequestEncoderTest)
+
+#include "tst_requestencoder.moc"
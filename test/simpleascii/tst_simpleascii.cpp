@@ -0,0 +1,85 @@
+#include <QString>
+#include <QtTest>
+#include <QBuffer>
+
+#include "chooselalib.h"
+#include "exchangesimpleascii.h"
+#include "exportengine.h"
+#include "featurewrapper.h"
+#include "point.h"
+
+using namespace oi;
+
+/*!
+ * \brief The SimpleAsciiExport class
+ * Makes the export engine of ExchangeSimpleAscii accessible to the test
+ */
+class SimpleAsciiExport : public ExchangeSimpleAscii
+{
+public:
+    using ExchangeSimpleAscii::createExportEngine;
+};
+
+class SimpleAsciiTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    SimpleAsciiTest();
+
+private Q_SLOTS:
+    void initTestCase();
+    void testExportDelimiter_data();
+    void testExportDelimiter();
+};
+
+SimpleAsciiTest::SimpleAsciiTest()
+{
+}
+
+void SimpleAsciiTest::initTestCase() {
+    ChooseLALib::setLinearAlgebra(ChooseLALib::Armadillo);
+}
+
+void SimpleAsciiTest::testExportDelimiter_data() {
+    QTest::addColumn<QString>("delimiter");
+    QTest::addColumn<QByteArray>("expected");
+
+    //the delimiter descriptions of the import dialog are resolved like parseAsciiData does
+    QTest::newRow("semicolon") << QString("semicolon [;]") << QByteArray("P1;1.50;-2.00\n");
+    QTest::newRow("comma") << QString("comma [,]") << QByteArray("P1,1.50,-2.00\n");
+    QTest::newRow("whitespace") << QString("whitespace [ ]") << QByteArray("P1 1.50 -2.00\n");
+    QTest::newRow("char") << QString(";") << QByteArray("P1;1.50;-2.00\n");
+    QTest::newRow("empty") << QString() << QByteArray("P1 1.50 -2.00\n");
+}
+
+void SimpleAsciiTest::testExportDelimiter() {
+    QFETCH(QString, delimiter);
+    QFETCH(QByteArray, expected);
+
+    Point *point = new Point(true, Position(1.5, -2.0, 3.0));
+    point->setFeatureName("P1");
+
+    SimpleAsciiExport exchange;
+    exchange.setDelimiter(delimiter);
+    exchange.setUserDefinedColumns(QList<ExchangeSimpleAscii::ColumnType>() << ExchangeSimpleAscii::eColumnFeatureName
+                                   << ExchangeSimpleAscii::eColumnX << ExchangeSimpleAscii::eColumnY);
+    exchange.setFeatures(QList<QPointer<FeatureWrapper> >() << point->getFeatureWrapper());
+
+    QPointer<ExportEngine> engine = exchange.createExportEngine();
+    QVERIFY(!engine.isNull());
+    QCOMPARE(engine->getDelimiter().size(), 1);
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    engine->setDevice(&buffer);
+    engine->run();
+    QCOMPARE(buffer.data(), expected);
+
+    delete engine.data();
+    delete point;
+}
+
+QTEST_APPLESS_MAIN(SimpleAsciiTest)
+
+#include "tst_simpleascii.moc"
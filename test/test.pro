@@ -1,6 +1,12 @@
 TEMPLATE = subdirs
 
-SUBDIRS = reading
+SUBDIRS = reading \
+    requestencoder \
+    nurbs \
+    readingstore \
+    bundleengine \
+    simpleascii \
+    benchmark
 
 INSTALLS =
 
@@ -10,13 +16,44 @@ QMAKE_EXTRA_TARGETS += run-test
 win32-msvc* {
 run-test.commands = \
     if not exist reports mkdir reports & if not exist reports exit 1 $$escape_expand(\n\t)\
-    cd $$shell_quote($$OUT_PWD/reading) && $(MAKE) run-test
+    cd $$shell_quote($$OUT_PWD/reading) && $(MAKE) run-test $$escape_expand(\n\t)\
+    cd $$shell_quote($$OUT_PWD/requestencoder) && $(MAKE) run-test $$escape_expand(\n\t)\
+    cd $$shell_quote($$OUT_PWD/nurbs) && $(MAKE) run-test $$escape_expand(\n\t)\
+    cd $$shell_quote($$OUT_PWD/readingstore) && $(MAKE) run-test $$escape_expand(\n\t)\
+    cd $$shell_quote($$OUT_PWD/bundleengine) && $(MAKE) run-test $$escape_expand(\n\t)\
+    cd $$shell_quote($$OUT_PWD/simpleascii) && $(MAKE) run-test
 } else:win32-g++ {
 run-test.commands = \
     [ -e "reports" ] || mkdir reports ; \
-    $(MAKE) -C $$shell_quote($$OUT_PWD/reading) run-test
+    $(MAKE) -C $$shell_quote($$OUT_PWD/reading) run-test ; \
+    $(MAKE) -C $$shell_quote($$OUT_PWD/requestencoder) run-test ; \
+    $(MAKE) -C $$shell_quote($$OUT_PWD/nurbs) run-test ; \
+    $(MAKE) -C $$shell_quote($$OUT_PWD/readingstore) run-test ; \
+    $(MAKE) -C $$shell_quote($$OUT_PWD/bundleengine) run-test ; \
+    $(MAKE) -C $$shell_quote($$OUT_PWD/simpleascii) run-test
 } else:linux {
 run-test.commands = \
     [ -e "reports" ] || mkdir reports ; \
-    $(MAKE) -C reading run-test ;
+    $(MAKE) -C reading run-test ; \
+    $(MAKE) -C requestencoder run-test ; \
+    $(MAKE) -C nurbs run-test ; \
+    $(MAKE) -C readingstore run-test ; \
+    $(MAKE) -C bundleengine run-test ; \
+    $(MAKE) -C simpleascii run-test ;
+}
+
+# benchmarks are not part of run-test (they take minutes for the largest point counts)
+QMAKE_EXTRA_TARGETS += run-benchmark
+win32-msvc* {
+run-benchmark.commands = \
+    if not exist reports mkdir reports & if not exist reports exit 1 $$escape_expand(\n\t)\
+    cd $$shell_quote($$OUT_PWD/benchmark) && $(MAKE) run-benchmark
+} else:win32-g++ {
+run-benchmark.commands = \
+    [ -e "reports" ] || mkdir reports ; \
+    $(MAKE) -C $$shell_quote($$OUT_PWD/benchmark) run-benchmark
+} else:linux {
+run-benchmark.commands = \
+    [ -e "reports" ] || mkdir reports ; \
+    $(MAKE) -C benchmark run-benchmark ;
 }